@@ -0,0 +1,386 @@
+/**
+ * @file bench_allocator.c
+ * @brief Benchmark de las políticas del asignador bajo cargas con nombre.
+ *
+ * Ejecuta cada carga con cada política de alloc_policy.h y mide cada reserva
+ * y liberación. Las cargas combinan una distribución de tamaños con
+ * un orden de liberación:
+ *
+ * - uniform_small, bimodal y power_law: rondas que llenan el conjunto vivo y
+ *   lo vacían en orden aleatorio.
+ * - lifo y fifo: las mismas rondas con tamaños power_law, liberando primero
+ *   el bloque más nuevo o el más viejo.
+ * - churn: llena el conjunto vivo una vez y luego reemplaza un bloque al azar
+ *   en cada paso, en régimen estacionario.
+ *
+ * Por cada política y carga reporta operaciones por segundo, percentiles de
+ * latencia de la reserva y la liberación, la mayor memoria tomada del
+ * sistema (el crecimiento del heap con sbrk más lo proyectado con
+ * policy_reserve), el mayor volumen vivo pedido y la fragmentación de
+ * policy_fragmentation. Cada corrida se hace en un proceso hijo, así todas
+ * empiezan con un heap sin usar y la memoria tomada no depende del orden de
+ * las corridas. En las cargas por rondas la fragmentación se toma a mitad del
+ * último vaciado, cuando el orden de liberación ya dejó huecos; en churn, al
+ * final.
+ *
+ * Además repite churn con conjuntos vivos crecientes (scaling_live_blocks)
+ * para mostrar cómo crece la latencia de cada política con la cantidad de
+ * bloques en el heap. La salida es JSON en stdout.
+ *
+ * Uso: bench_allocator [operaciones] [bloques_vivos] [semilla]
+ */
+
+#include "../../../lib/memory/include/memory.h"
+#include "../include/alloc_policy.h"
+#include "../include/json_writer.h"
+#include "../include/xorshift.h"
+#include "bench_common.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define DEFAULT_OPERATIONS 200000
+#define DEFAULT_LIVE_BLOCKS 4096
+#define DEFAULT_SEED 42
+
+/**
+ * @brief Distribución de los tamaños pedidos.
+ */
+typedef enum {
+  SIZES_UNIFORM_SMALL, ///< Uniforme entre 16 y 256 bytes
+  SIZES_BIMODAL,       ///< 90% entre 16 y 64 bytes, 10% entre 4 y 16 KiB
+  SIZES_POWER_LAW      ///< Pareto (alfa 1.2) entre 16 bytes y 64 KiB
+} SizeDistribution;
+
+/**
+ * @brief Qué bloque se libera en cada paso.
+ */
+typedef enum {
+  FREE_RANDOM, ///< Cualquiera de los vivos
+  FREE_LIFO,   ///< El más nuevo
+  FREE_FIFO,   ///< El más viejo
+  FREE_CHURN   ///< Régimen estacionario: liberar uno al azar y pedir otro
+} FreeOrder;
+
+/**
+ * @brief Carga con nombre.
+ */
+typedef struct {
+  const char *name;
+  SizeDistribution sizes;
+  FreeOrder order;
+} Workload;
+
+static const Workload workloads[] = {
+    {"uniform_small", SIZES_UNIFORM_SMALL, FREE_RANDOM},
+    {"bimodal", SIZES_BIMODAL, FREE_RANDOM},
+    {"power_law", SIZES_POWER_LAW, FREE_RANDOM},
+    {"lifo", SIZES_POWER_LAW, FREE_LIFO},
+    {"fifo", SIZES_POWER_LAW, FREE_FIFO},
+    {"churn", SIZES_POWER_LAW, FREE_CHURN},
+};
+
+static const struct {
+  int method;
+  const char *name;
+} policies[] = {
+    {FIRST_FIT, "first_fit"},
+    {BEST_FIT, "best_fit"},
+    {WORST_FIT, "worst_fit"},
+    {SEGREGATED_FIT, "segregated_fit"},
+    {INDEXED_BEST_FIT, "indexed_best_fit"},
+};
+
+/** Conjuntos vivos del barrido de escala, con la carga churn */
+static const size_t scaling_live_blocks[] = {256, 1024, 4096, 16384};
+
+/**
+ * @brief Estado de una corrida: bloques vivos en orden de asignación y
+ * latencias medidas.
+ */
+typedef struct {
+  void **blocks;           ///< Bloques vivos; el más viejo en first
+  size_t *sizes;           ///< Tamaño pedido de cada bloque
+  size_t first;            ///< Índice del bloque más viejo
+  size_t count;            ///< Bloques vivos
+  size_t capacity;         ///< Capacidad de blocks
+  uint64_t *malloc_ns;     ///< Latencias de my_malloc
+  size_t malloc_count;     ///< Latencias de my_malloc medidas
+  uint64_t *free_ns;       ///< Latencias de my_free
+  size_t free_count;       ///< Latencias de my_free medidas
+  size_t live_bytes;       ///< Bytes pedidos vivos
+  size_t peak_live_bytes;  ///< Mayor valor de live_bytes
+  char *heap_start;        ///< sbrk(0) al empezar
+  size_t peak_heap_bytes;  ///< Mayor memoria tomada del sistema
+  size_t failed;           ///< my_malloc que devolvieron NULL
+  uint64_t rng;            ///< Estado de xorshift64
+  int method;              ///< Política de la corrida
+} Run;
+
+/**
+ * @brief Resultado de una corrida, que el proceso hijo le pasa al padre.
+ */
+typedef struct {
+  size_t operations;       ///< Reservas y liberaciones medidas
+  double seconds;          ///< Duración de la corrida
+  LatencySummary malloc;   ///< Latencias de my_malloc
+  LatencySummary free;     ///< Latencias de my_free
+  size_t peak_heap_bytes;  ///< Mayor memoria tomada del sistema
+  size_t peak_live_bytes;  ///< Mayor volumen vivo pedido
+  double fragmentation;    ///< Fragmentación de la política
+  size_t failed;           ///< my_malloc que devolvieron NULL
+} RunResult;
+
+static uint64_t next_random(Run *run) { return xorshift64_next(&run->rng); }
+
+static double next_unit(Run *run) {
+  return (double)(next_random(run) >> 11) / 9007199254740992.0;
+}
+
+static size_t next_size(Run *run, SizeDistribution sizes) {
+  switch (sizes) {
+  case SIZES_UNIFORM_SMALL:
+    return 16 + next_random(run) % 241;
+  case SIZES_BIMODAL:
+    return next_random(run) % 10 == 0 ? 4096 + next_random(run) % 12289
+                                      : 16 + next_random(run) % 49;
+  case SIZES_POWER_LAW: {
+    double size = 16.0 / pow(1.0 - next_unit(run), 1.0 / 1.2);
+    return size > 65536.0 ? 65536 : (size_t)size;
+  }
+  }
+  return 16;
+}
+
+static int run_malloc(Run *run, SizeDistribution sizes) {
+  size_t size = next_size(run, sizes);
+  uint64_t start = now_ns();
+  void *block = policy_malloc(run->method, size);
+  run->malloc_ns[run->malloc_count++] = now_ns() - start;
+  if (block == NULL) {
+    run->failed++;
+    return -1;
+  }
+
+  size_t slot = (run->first + run->count) % run->capacity;
+  run->blocks[slot] = block;
+  run->sizes[slot] = size;
+  run->count++;
+  run->live_bytes += size;
+  if (run->live_bytes > run->peak_live_bytes) {
+    run->peak_live_bytes = run->live_bytes;
+  }
+  size_t heap =
+      (size_t)((char *)sbrk(0) - run->heap_start) + policy_reserved_bytes();
+  if (heap > run->peak_heap_bytes) {
+    run->peak_heap_bytes = heap;
+  }
+  return 0;
+}
+
+static void run_free(Run *run, FreeOrder order) {
+  size_t offset;
+  switch (order) {
+  case FREE_LIFO:
+    offset = run->count - 1;
+    break;
+  case FREE_FIFO:
+    offset = 0;
+    break;
+  default:
+    offset = next_random(run) % run->count;
+    break;
+  }
+
+  // El hueco se llena con el bloque más nuevo, como en main.c
+  size_t slot = (run->first + offset) % run->capacity;
+  size_t last = (run->first + run->count - 1) % run->capacity;
+  void *block = run->blocks[slot];
+  run->live_bytes -= run->sizes[slot];
+  if (order == FREE_FIFO) {
+    run->first = (run->first + 1) % run->capacity;
+  } else {
+    run->blocks[slot] = run->blocks[last];
+    run->sizes[slot] = run->sizes[last];
+  }
+  run->count--;
+
+  uint64_t start = now_ns();
+  policy_free(run->method, block);
+  run->free_ns[run->free_count++] = now_ns() - start;
+}
+
+/**
+ * @brief Parámetros de una corrida.
+ */
+typedef struct {
+  int policy;               ///< Índice en policies
+  const Workload *workload; ///< Carga de la corrida
+  size_t operations;        ///< Reservas y liberaciones a medir
+  size_t live;              ///< Bloques vivos
+  uint64_t seed;            ///< Semilla de xorshift64
+} RunParams;
+
+static void run_workload(void *out, const void *context) {
+  RunResult *result = out;
+  const RunParams *params = context;
+  const Workload *workload = params->workload;
+  size_t operations = params->operations;
+  size_t live = params->live;
+  uint64_t seed = params->seed;
+  Run run = {.capacity = live, .rng = seed ? seed : DEFAULT_SEED};
+  run.blocks = malloc(live * sizeof(void *));
+  run.sizes = malloc(live * sizeof(size_t));
+  // Cada paso hace a lo sumo una asignación y una liberación
+  run.malloc_ns = malloc((operations + live) * sizeof(uint64_t));
+  run.free_ns = malloc((operations + live) * sizeof(uint64_t));
+  if (run.blocks == NULL || run.sizes == NULL || run.malloc_ns == NULL ||
+      run.free_ns == NULL) {
+    fprintf(stderr, "Error al reservar el estado del benchmark\n");
+    exit(EXIT_FAILURE);
+  }
+
+  run.method = policies[params->policy].method;
+  run.heap_start = sbrk(0);
+  double fragmentation[ALLOC_POLICY_COUNT] = {0.0};
+  uint64_t start = now_ns();
+
+  if (workload->order == FREE_CHURN) {
+    while (run.count < live && run.malloc_count < operations &&
+           run_malloc(&run, workload->sizes) == 0) {
+    }
+    while (run.malloc_count + run.free_count < operations) {
+      if (run.count > 0) {
+        run_free(&run, FREE_RANDOM);
+      }
+      run_malloc(&run, workload->sizes);
+    }
+    policy_walk_heap();
+    policy_fragmentation(fragmentation);
+  } else {
+    while (run.malloc_count + run.free_count < operations) {
+      // Si el asignador se queda sin memoria, la ronda vacía lo que logró
+      size_t filled = 0;
+      while (run.count < live && run_malloc(&run, workload->sizes) == 0) {
+        filled++;
+      }
+      size_t done = run.malloc_count + run.free_count;
+      int last_round = filled == 0 || done + run.count >= operations;
+      size_t half = run.count / 2;
+      while (run.count > 0) {
+        if (last_round && run.count == half) {
+          policy_walk_heap();
+          policy_fragmentation(fragmentation);
+        }
+        run_free(&run, workload->order);
+      }
+      if (filled == 0) {
+        break;
+      }
+    }
+  }
+
+  result->seconds = (double)(now_ns() - start) / 1e9;
+  result->operations = run.malloc_count + run.free_count;
+  result->peak_heap_bytes = run.peak_heap_bytes;
+  result->peak_live_bytes = run.peak_live_bytes;
+  result->fragmentation = fragmentation[run.method];
+  result->failed = run.failed;
+  summarize_latency(&result->malloc, run.malloc_ns, run.malloc_count);
+  summarize_latency(&result->free, run.free_ns, run.free_count);
+
+  // Lo que quedó vivo se libera fuera de la medición
+  for (size_t i = 0; i < run.count; i++) {
+    policy_free(run.method, run.blocks[(run.first + i) % run.capacity]);
+  }
+
+  free(run.blocks);
+  free(run.sizes);
+  free(run.malloc_ns);
+  free(run.free_ns);
+}
+
+// Corre la carga en un proceso hijo, que empieza con el heap y las políticas
+// propias sin usar, y escribe su resultado
+static void measure_workload(JsonWriter *writer, int policy,
+                             const Workload *workload, size_t operations,
+                             size_t live, uint64_t seed) {
+  RunParams params = {.policy = policy,
+                      .workload = workload,
+                      .operations = operations,
+                      .live = live,
+                      .seed = seed};
+  RunResult result;
+  if (run_in_child(run_workload, &params, &result, sizeof(result)) != 0) {
+    fprintf(stderr, "La corrida %s/%s no terminó\n", policies[policy].name,
+            workload->name);
+    exit(EXIT_FAILURE);
+  }
+
+  json_object_begin(writer, NULL);
+  json_write_string(writer, "policy", policies[policy].name);
+  json_write_string(writer, "workload", workload->name);
+  json_write_uint(writer, "live_blocks", live);
+  json_write_uint(writer, "operations", result.operations);
+  json_write_number(writer, "seconds", result.seconds);
+  json_write_number(writer, "ops_per_sec",
+                    result.seconds > 0.0 ? result.operations / result.seconds
+                                         : 0.0);
+  write_latency(writer, "malloc", &result.malloc);
+  write_latency(writer, "free", &result.free);
+  json_write_uint(writer, "peak_heap_bytes", result.peak_heap_bytes);
+  json_write_uint(writer, "peak_live_bytes", result.peak_live_bytes);
+  json_write_number(writer, "fragmentation_percentage", result.fragmentation);
+  json_write_uint(writer, "failed_allocations", result.failed);
+  json_object_end(writer);
+}
+
+int main(int argc, char *argv[]) {
+  long operations = argc > 1 ? atol(argv[1]) : DEFAULT_OPERATIONS;
+  long live = argc > 2 ? atol(argv[2]) : DEFAULT_LIVE_BLOCKS;
+  unsigned long long seed =
+      argc > 3 ? strtoull(argv[3], NULL, 10) : DEFAULT_SEED;
+  if (operations <= 0) {
+    operations = DEFAULT_OPERATIONS;
+  }
+  if (live <= 0) {
+    live = DEFAULT_LIVE_BLOCKS;
+  }
+
+  JsonWriter writer = {0};
+  json_object_begin(&writer, NULL);
+  json_write_uint(&writer, "operations", (unsigned long long)operations);
+  json_write_uint(&writer, "live_blocks", (unsigned long long)live);
+  json_write_uint(&writer, "seed", seed);
+  json_array_begin(&writer, "results");
+  for (size_t p = 0; p < sizeof(policies) / sizeof(policies[0]); p++) {
+    for (size_t w = 0; w < sizeof(workloads) / sizeof(workloads[0]); w++) {
+      measure_workload(&writer, (int)p, &workloads[w], (size_t)operations,
+                       (size_t)live, seed);
+    }
+  }
+  json_array_end(&writer);
+
+  const Workload *churn =
+      &workloads[sizeof(workloads) / sizeof(workloads[0]) - 1];
+  json_array_begin(&writer, "scaling");
+  for (size_t p = 0; p < sizeof(policies) / sizeof(policies[0]); p++) {
+    for (size_t s = 0;
+         s < sizeof(scaling_live_blocks) / sizeof(scaling_live_blocks[0]);
+         s++) {
+      measure_workload(&writer, (int)p, churn, (size_t)operations,
+                       scaling_live_blocks[s], seed);
+    }
+  }
+  json_array_end(&writer);
+  json_object_end(&writer);
+
+  size_t length;
+  const char *json = json_writer_finish(&writer, &length);
+  fwrite(json, 1, length, stdout);
+  json_writer_free(&writer);
+  return EXIT_SUCCESS;
+}
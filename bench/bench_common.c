@@ -0,0 +1,76 @@
+#include "bench_common.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int compare_u64(const void *a, const void *b) {
+  uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+  return (x > y) - (x < y);
+}
+
+void summarize_latency(LatencySummary *summary, uint64_t *ns, size_t count) {
+  *summary = (LatencySummary){.count = count};
+  if (count > 0) {
+    qsort(ns, count, sizeof(uint64_t), compare_u64);
+    summary->p50_ns = ns[count / 2];
+    summary->p99_ns = ns[count * 99 / 100];
+    summary->p999_ns = ns[count * 999 / 1000];
+    summary->max_ns = ns[count - 1];
+  }
+}
+
+void write_latency(JsonWriter *writer, const char *key,
+                   const LatencySummary *summary) {
+  json_object_begin(writer, key);
+  json_write_uint(writer, "count", summary->count);
+  if (summary->count > 0) {
+    json_write_uint(writer, "p50_ns", summary->p50_ns);
+    json_write_uint(writer, "p99_ns", summary->p99_ns);
+    json_write_uint(writer, "p999_ns", summary->p999_ns);
+    json_write_uint(writer, "max_ns", summary->max_ns);
+  }
+  json_object_end(writer);
+}
+
+int run_in_child(BenchChildTask task, const void *context, void *result,
+                 size_t result_size) {
+  int fds[2];
+  if (pipe(fds) != 0) {
+    perror("Error al crear el pipe de la medición");
+    return -1;
+  }
+  pid_t pid = fork();
+  if (pid < 0) {
+    perror("Error al crear el proceso de la medición");
+    close(fds[0]);
+    close(fds[1]);
+    return -1;
+  }
+  if (pid == 0) {
+    close(fds[0]);
+    task(result, context);
+    ssize_t written = write(fds[1], result, result_size);
+    _exit(written == (ssize_t)result_size ? EXIT_SUCCESS : EXIT_FAILURE);
+  }
+
+  close(fds[1]);
+  ssize_t received = read(fds[0], result, result_size);
+  close(fds[0]);
+  int status;
+  if (waitpid(pid, &status, 0) != pid) {
+    perror("Error al esperar el proceso de la medición");
+    return -1;
+  }
+  return received == (ssize_t)result_size && WIFEXITED(status) &&
+                 WEXITSTATUS(status) == EXIT_SUCCESS
+             ? 0
+             : -1;
+}
@@ -0,0 +1,71 @@
+/**
+ * @file bench_common.h
+ * @brief Utilidades compartidas por bench_allocator y bench_replay.
+ *
+ * Reúnen los percentiles de latencia, su salida en JSON y la ejecución de una
+ * medición en un proceso hijo, que empieza con el heap y las políticas
+ * propias sin usar.
+ */
+
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+#include "../include/json_writer.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Percentiles de latencia de una operación.
+ */
+typedef struct
+{
+    size_t count;     ///< Latencias medidas
+    uint64_t p50_ns;  ///< Mediana
+    uint64_t p99_ns;  ///< Percentil 99
+    uint64_t p999_ns; ///< Percentil 99,9
+    uint64_t max_ns;  ///< Mayor latencia
+} LatencySummary;
+
+/**
+ * @brief Medición que corre en el proceso hijo.
+ *
+ * @param result Recibe el resultado que se le pasa al padre.
+ * @param context Datos de la medición.
+ */
+typedef void (*BenchChildTask)(void* result, const void* context);
+
+/**
+ * @brief Devuelve el reloj monótono en nanosegundos.
+ */
+uint64_t now_ns(void);
+
+/**
+ * @brief Calcula los percentiles de un conjunto de latencias.
+ *
+ * @param summary Recibe los percentiles.
+ * @param ns Latencias en nanosegundos; se ordenan en el lugar.
+ * @param count Cantidad de latencias.
+ */
+void summarize_latency(LatencySummary* summary, uint64_t* ns, size_t count);
+
+/**
+ * @brief Escribe los percentiles como un objeto JSON.
+ *
+ * @param writer Escritor de destino.
+ * @param key Clave del objeto.
+ * @param summary Percentiles a escribir; sin latencias solo se escribe count.
+ */
+void write_latency(JsonWriter* writer, const char* key, const LatencySummary* summary);
+
+/**
+ * @brief Corre una medición en un proceso hijo y copia su resultado.
+ *
+ * @param task Medición que corre el hijo.
+ * @param context Datos que recibe la medición.
+ * @param result Recibe el resultado del hijo.
+ * @param result_size Tamaño de result; a lo sumo PIPE_BUF bytes.
+ * @return 0 si el hijo terminó y entregó el resultado completo, -1 si no.
+ */
+int run_in_child(BenchChildTask task, const void* context, void* result, size_t result_size);
+
+#endif // BENCH_COMMON_H
@@ -0,0 +1,347 @@
+/**
+ * @file bench_proc_parse.c
+ * @brief Microbenchmark del tokenizador de /proc frente a sscanf.
+ *
+ * Compara el costo de analizar /proc/stat, /proc/diskstats, /proc/net/dev y
+ * /proc/meminfo con las versiones basadas en sscanf que usaba metrics.c y con
+ * proc_parse. Cada archivo se lee una vez a memoria para medir solo el
+ * análisis. Además de los archivos reales del host se generan archivos
+ * sintéticos con muchos núcleos, dispositivos e interfaces.
+ *
+ * Uso: bench_proc_parse [iteraciones]
+ */
+
+#include "../include/proc_parse.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DEFAULT_ITERATIONS 2000
+#define SYNTHETIC_CPUS 128
+#define SYNTHETIC_DISKS 1024
+#define SYNTHETIC_INTERFACES 512
+
+typedef unsigned long long (*parse_fn)(char *buffer, size_t length);
+
+/** Evita que el compilador descarte los resultados */
+static volatile unsigned long long sink;
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* ---- Versiones con sscanf (como en metrics.c antes de proc_parse) ---- */
+
+// Recorre las líneas terminándolas en '\0', como hacía fgets
+#define FOR_EACH_LINE(buffer, line)                                            \
+  for (char *line = (buffer), *next_line; line && *line; line = next_line)    \
+    if ((next_line = strchr(line, '\n')) != NULL ? (*next_line++ = '\0', 1)    \
+                                                 : 1)
+
+static unsigned long long sscanf_stat(char *buffer, size_t length) {
+  (void)length;
+  unsigned long long sum = 0, v[8], counter;
+  unsigned int cpu;
+  FOR_EACH_LINE(buffer, line) {
+    // "cpu  %llu" también aceptaría "cpu0": distinguimos por el espacio
+    if (strncmp(line, "cpu ", 4) == 0
+            ? sscanf(line, "cpu  %llu %llu %llu %llu %llu %llu %llu %llu",
+                     &v[0], &v[1], &v[2], &v[3], &v[4], &v[5], &v[6],
+                     &v[7]) == 8
+            : sscanf(line, "cpu%u %llu %llu %llu %llu %llu %llu %llu %llu",
+                     &cpu, &v[0], &v[1], &v[2], &v[3], &v[4], &v[5], &v[6],
+                     &v[7]) == 9) {
+      sum += v[0] + v[2] + v[3];
+    } else if (sscanf(line, "ctxt %llu", &counter) == 1 ||
+               sscanf(line, "processes %llu", &counter) == 1 ||
+               sscanf(line, "procs_running %llu", &counter) == 1 ||
+               sscanf(line, "procs_blocked %llu", &counter) == 1) {
+      sum += counter;
+    }
+  }
+  return sum;
+}
+
+static unsigned long long sscanf_diskstats(char *buffer, size_t length) {
+  (void)length;
+  unsigned long long sum = 0, v[8];
+  unsigned int major, minor;
+  char name[32];
+  FOR_EACH_LINE(buffer, line) {
+    if (sscanf(line, "%u %u %31s %llu %llu %llu %llu %llu %llu %llu %llu",
+               &major, &minor, name, &v[0], &v[1], &v[2], &v[3], &v[4], &v[5],
+               &v[6], &v[7]) == 11) {
+      sum += major + minor + v[0] + v[3] + v[4] + v[7];
+    }
+  }
+  return sum;
+}
+
+static unsigned long long sscanf_net_dev(char *buffer, size_t length) {
+  (void)length;
+  unsigned long long sum = 0, rx_bytes, rx_packets, tx_bytes, tx_packets;
+  char name[32];
+  FOR_EACH_LINE(buffer, line) {
+    if (sscanf(line, " %31[^:]:", name) == 1 &&
+        sscanf(line, "%*[^:]: %llu %llu %*u %*u %*u %*u %*u %*u %llu %llu",
+               &rx_bytes, &rx_packets, &tx_bytes, &tx_packets) == 4) {
+      sum += rx_bytes + rx_packets + tx_bytes + tx_packets;
+    }
+  }
+  return sum;
+}
+
+static unsigned long long sscanf_meminfo(char *buffer, size_t length) {
+  (void)length;
+  unsigned long long sum = 0, value;
+  FOR_EACH_LINE(buffer, line) {
+    if (sscanf(line, "MemTotal: %llu kB", &value) == 1 ||
+        sscanf(line, "MemAvailable: %llu kB", &value) == 1) {
+      sum += value;
+    }
+  }
+  return sum;
+}
+
+/* ---- Versiones con proc_parse ---- */
+
+static unsigned long long tokenizer_stat(char *buffer, size_t length) {
+  unsigned long long sum = 0, v[8], counter, cpu;
+  ProcCursor cursor, line;
+  proc_cursor_init(&cursor, buffer, length);
+  while (proc_next_line(&cursor, &line)) {
+    if (proc_consume_prefix(&line, "cpu", 3)) {
+      if (*line.pos != ' ' && !proc_parse_u64(&line, &cpu)) {
+        continue;
+      }
+      if (proc_parse_u64_array(&line, v, 8) == 8) {
+        sum += v[0] + v[2] + v[3];
+      }
+    } else if ((proc_consume_prefix(&line, "ctxt ", 5) ||
+                proc_consume_prefix(&line, "processes ", 10) ||
+                proc_consume_prefix(&line, "procs_running ", 14) ||
+                proc_consume_prefix(&line, "procs_blocked ", 14)) &&
+               proc_parse_u64(&line, &counter)) {
+      sum += counter;
+    }
+  }
+  return sum;
+}
+
+static unsigned long long tokenizer_diskstats(char *buffer, size_t length) {
+  unsigned long long sum = 0, v[8], major, minor;
+  ProcCursor cursor, line, name;
+  proc_cursor_init(&cursor, buffer, length);
+  while (proc_next_line(&cursor, &line)) {
+    if (proc_parse_u64(&line, &major) && proc_parse_u64(&line, &minor) &&
+        proc_next_field(&line, &name) &&
+        proc_parse_u64_array(&line, v, 8) == 8) {
+      sum += major + minor + v[0] + v[3] + v[4] + v[7];
+    }
+  }
+  return sum;
+}
+
+static unsigned long long tokenizer_net_dev(char *buffer, size_t length) {
+  unsigned long long sum = 0, v[16];
+  ProcCursor cursor, line, name;
+  proc_cursor_init(&cursor, buffer, length);
+  while (proc_next_line(&cursor, &line)) {
+    if (proc_split_at(&line, ':', &name) &&
+        proc_parse_u64_array(&line, v, 16) == 16) {
+      sum += v[0] + v[1] + v[8] + v[9];
+    }
+  }
+  return sum;
+}
+
+static unsigned long long tokenizer_meminfo(char *buffer, size_t length) {
+  unsigned long long sum = 0, value;
+  ProcCursor cursor, line;
+  proc_cursor_init(&cursor, buffer, length);
+  while (proc_next_line(&cursor, &line)) {
+    if ((proc_consume_prefix(&line, "MemTotal:", 9) ||
+         proc_consume_prefix(&line, "MemAvailable:", 13)) &&
+        proc_parse_u64(&line, &value)) {
+      sum += value;
+    }
+  }
+  return sum;
+}
+
+/* ---- Generación de archivos ---- */
+
+static char *read_file(const char *path, size_t *length) {
+  FILE *fp = fopen(path, "r");
+  if (fp == NULL) {
+    return NULL;
+  }
+  size_t capacity = 4096, used = 0, n;
+  char *buffer = malloc(capacity);
+  while (buffer != NULL &&
+         (n = fread(buffer + used, 1, capacity - used - 1, fp)) > 0) {
+    used += n;
+    if (used + 1 == capacity) {
+      capacity *= 2;
+      buffer = realloc(buffer, capacity);
+    }
+  }
+  fclose(fp);
+  if (buffer != NULL) {
+    buffer[used] = '\0';
+    *length = used;
+  }
+  return buffer;
+}
+
+// Genera contenido con el formato de un archivo de /proc en un búfer dinámico
+static char *synthetic_file(int kind, size_t *length) {
+  size_t capacity = 1 << 20;
+  char *buffer = malloc(capacity);
+  size_t used = 0;
+  if (buffer == NULL) {
+    return NULL;
+  }
+
+#define APPEND(...)                                                            \
+  used += (size_t)snprintf(buffer + used, capacity - used, __VA_ARGS__)
+
+  switch (kind) {
+  case 0: // /proc/stat
+    APPEND("cpu  %d %d %d %d %d %d %d %d 0 0\n", 48820731, 3120, 9912345,
+           812345678, 123456, 0, 88231, 912);
+    for (int cpu = 0; cpu < SYNTHETIC_CPUS; cpu++) {
+      APPEND("cpu%d %d %d %d %d %d %d %d %d 0 0\n", cpu, 381412 + cpu, 24,
+             77440 + cpu, 6346450 + cpu * 7, 964, 0, 689, 7);
+    }
+    APPEND("intr 912384712");
+    for (int i = 0; i < 512; i++) {
+      APPEND(" %d", i % 7);
+    }
+    APPEND("\nctxt 1837461827\nbtime 1700000000\nprocesses 8812734\n"
+           "procs_running 3\nprocs_blocked 0\n");
+    break;
+  case 1: // /proc/diskstats
+    for (int disk = 0; disk < SYNTHETIC_DISKS; disk++) {
+      APPEND("%4d %7d nvme%dn1 %d %d %d %d %d %d %d %d 0 %d %d %d %d %d %d %d "
+             "%d\n",
+             259, disk, disk, 1812734 + disk, 9123, 88123456, 712345,
+             2918273 + disk, 81273, 91827364, 1827364, 918273, 2738271, 12, 0,
+             0, 0, 7812, 981);
+    }
+    break;
+  case 2: // /proc/net/dev
+    APPEND("Inter-|   Receive                                                |"
+           "  Transmit\n"
+           " face |bytes    packets errs drop fifo frame compressed "
+           "multicast|bytes    packets errs drop fifo colls carrier "
+           "compressed\n");
+    for (int iface = 0; iface < SYNTHETIC_INTERFACES; iface++) {
+      APPEND("%6s%d: %llu %d 0 0 0 0 0 %d %llu %d 0 0 0 0 0 0\n", "veth",
+             iface, 918273645123ULL + (unsigned long long)iface, 81273645, 12,
+             712364512345ULL, 71283645);
+    }
+    break;
+  }
+#undef APPEND
+
+  *length = used;
+  return buffer;
+}
+
+/* ---- Medición ---- */
+
+// Mide el costo medio por análisis; se copia el original antes de cada pasada
+// porque las versiones con sscanf modifican el búfer
+static double measure(parse_fn fn, const char *original, size_t length,
+                      char *scratch, int iterations) {
+  double elapsed = 0.0;
+  for (int i = 0; i < iterations; i++) {
+    memcpy(scratch, original, length + 1);
+    double start = now_ns();
+    sink += fn(scratch, length);
+    elapsed += now_ns() - start;
+  }
+  return elapsed / iterations;
+}
+
+static void run_case(const char *name, char *content, size_t length,
+                     parse_fn reference, parse_fn tokenizer, int iterations) {
+  if (content == NULL) {
+    printf("%-28s no disponible\n", name);
+    return;
+  }
+
+  char *scratch = malloc(length + 1);
+  if (scratch == NULL) {
+    return;
+  }
+
+  // Ambas versiones deben extraer los mismos valores
+  memcpy(scratch, content, length + 1);
+  unsigned long long expected = reference(scratch, length);
+  memcpy(scratch, content, length + 1);
+  unsigned long long got = tokenizer(scratch, length);
+
+  double sscanf_ns = measure(reference, content, length, scratch, iterations);
+  double tokenizer_ns =
+      measure(tokenizer, content, length, scratch, iterations);
+
+  printf("%-28s %9zu %12.0f %12.0f %8.1fx%s\n", name, length, sscanf_ns,
+         tokenizer_ns, sscanf_ns / tokenizer_ns,
+         expected == got ? "" : "  (resultados distintos)");
+  free(scratch);
+}
+
+int main(int argc, char *argv[]) {
+  int iterations = argc > 1 ? atoi(argv[1]) : DEFAULT_ITERATIONS;
+  if (iterations <= 0) {
+    iterations = DEFAULT_ITERATIONS;
+  }
+
+  static const struct {
+    const char *path;
+    parse_fn reference;
+    parse_fn tokenizer;
+  } real_files[] = {
+      {"/proc/stat", sscanf_stat, tokenizer_stat},
+      {"/proc/diskstats", sscanf_diskstats, tokenizer_diskstats},
+      {"/proc/net/dev", sscanf_net_dev, tokenizer_net_dev},
+      {"/proc/meminfo", sscanf_meminfo, tokenizer_meminfo},
+  };
+  static const struct {
+    const char *name;
+    parse_fn reference;
+    parse_fn tokenizer;
+  } synthetic_files[] = {
+      {"sintético stat (128 cpus)", sscanf_stat, tokenizer_stat},
+      {"sintético diskstats (1024)", sscanf_diskstats, tokenizer_diskstats},
+      {"sintético net/dev (512)", sscanf_net_dev, tokenizer_net_dev},
+  };
+
+  printf("%-28s %9s %12s %12s %9s\n", "archivo", "bytes", "sscanf ns",
+         "proc_parse ns", "mejora");
+
+  for (size_t i = 0; i < sizeof(real_files) / sizeof(real_files[0]); i++) {
+    size_t length = 0;
+    char *content = read_file(real_files[i].path, &length);
+    run_case(real_files[i].path, content, length, real_files[i].reference,
+             real_files[i].tokenizer, iterations);
+    free(content);
+  }
+
+  for (size_t i = 0; i < sizeof(synthetic_files) / sizeof(synthetic_files[0]);
+       i++) {
+    size_t length = 0;
+    char *content = synthetic_file((int)i, &length);
+    run_case(synthetic_files[i].name, content, length,
+             synthetic_files[i].reference, synthetic_files[i].tokenizer,
+             iterations);
+    free(content);
+  }
+
+  return EXIT_SUCCESS;
+}
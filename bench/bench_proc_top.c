@@ -0,0 +1,152 @@
+/**
+ * @file bench_proc_top.c
+ * @brief Costo de un barrido del recolector por proceso.
+ *
+ * Mide los barridos de proc_top sobre el /proc del host y sobre un árbol
+ * sintético con la forma de /proc (un directorio por pid con su stat, más
+ * entradas no numéricas) creado en un directorio temporal, para ver el costo
+ * con muchos más procesos de los que suele tener la máquina. El primer
+ * barrido llena la tabla; los siguientes son el régimen estacionario.
+ *
+ * Uso: bench_proc_top [pids_sintéticos] [barridos]
+ */
+
+#include "../include/proc_top.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define DEFAULT_PIDS 50000
+#define DEFAULT_SCANS 5
+
+// Entradas de /proc que no son procesos
+static const char *non_pid_entries[] = {"self", "sys", "net", "meminfo"};
+
+static int write_stat(int dir, int pid) {
+  char name[32];
+  snprintf(name, sizeof(name), "%d", pid);
+  if (mkdirat(dir, name, 0755) != 0) {
+    return -1;
+  }
+  snprintf(name, sizeof(name), "%d/stat", pid);
+  int fd = openat(dir, name, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    return -1;
+  }
+
+  // Algunos nombres con espacios y paréntesis, como permite el kernel
+  char line[512];
+  int length = snprintf(
+      line, sizeof(line),
+      "%d (%s%d) S 1 %d %d 0 -1 4194560 %d 0 0 0 %d %d 0 0 20 0 1 0 %d "
+      "%d %d 18446744073709551615 1 1 0 0 0 0 0 0 0 0 0 0 17 %d 0 0 0 0 0\n",
+      pid, pid % 7 == 0 ? "kworker/u8:) " : "worker", pid, pid, pid,
+      1000 + pid % 997, (pid * 7919) % 100000, (pid % 1000) * 37, pid,
+      (pid % 4096) * 4096 * 64, (pid * 31) % 262144, pid % 8);
+  ssize_t written = write(fd, line, (size_t)length);
+  close(fd);
+  return written == length ? 0 : -1;
+}
+
+static void remove_tree(const char *root, int pids) {
+  int dir = open(root, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (dir >= 0) {
+    char name[32];
+    for (int pid = 1; pid <= pids; pid++) {
+      snprintf(name, sizeof(name), "%d/stat", pid);
+      unlinkat(dir, name, 0);
+      snprintf(name, sizeof(name), "%d", pid);
+      unlinkat(dir, name, AT_REMOVEDIR);
+    }
+    for (size_t i = 0;
+         i < sizeof(non_pid_entries) / sizeof(non_pid_entries[0]); i++) {
+      unlinkat(dir, non_pid_entries[i], AT_REMOVEDIR);
+    }
+    close(dir);
+  }
+  rmdir(root);
+}
+
+static int build_tree(char *root, int pids) {
+  if (mkdtemp(root) == NULL) {
+    perror("Error al crear el directorio sintético");
+    return -1;
+  }
+  int dir = open(root, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (dir < 0) {
+    return -1;
+  }
+  int result = 0;
+  for (size_t i = 0;
+       i < sizeof(non_pid_entries) / sizeof(non_pid_entries[0]); i++) {
+    mkdirat(dir, non_pid_entries[i], 0755);
+  }
+  for (int pid = 1; pid <= pids && result == 0; pid++) {
+    result = write_stat(dir, pid);
+  }
+  close(dir);
+  if (result != 0) {
+    perror("Error al escribir el árbol sintético");
+  }
+  return result;
+}
+
+static void run_case(const char *name, const char *root, size_t max_pids,
+                     int scans) {
+  ProcTopConfig config = {
+      .root = root, .top_n = PROC_TOP_DEFAULT_N, .max_pids = max_pids};
+  if (proc_top_start(&config) != 0) {
+    printf("%-24s no disponible\n", name);
+    return;
+  }
+
+  for (int i = 0; i < scans; i++) {
+    if (proc_top_scan() != 0) {
+      break;
+    }
+    ProcTopStats stats;
+    proc_top_get_stats(&stats);
+    printf("%-24s %6d %8zu %8zu %8zu %10.2f %10.2f %10zu\n", name, i + 1,
+           stats.pids, stats.tracked, stats.dropped, stats.cpu_seconds * 1e3,
+           stats.wall_seconds * 1e3, stats.memory_bytes / 1024);
+  }
+
+  const ProcTopEntry *entries;
+  size_t count = proc_top_by_rss(&entries);
+  for (size_t i = 0; i < count && i < 3; i++) {
+    printf("  rss #%zu: %d (%s) %llu KiB\n", i + 1, entries[i].pid,
+           entries[i].comm, entries[i].rss_bytes / 1024);
+  }
+  proc_top_stop();
+}
+
+int main(int argc, char *argv[]) {
+  int pids = argc > 1 ? atoi(argv[1]) : DEFAULT_PIDS;
+  int scans = argc > 2 ? atoi(argv[2]) : DEFAULT_SCANS;
+  if (pids <= 0) {
+    pids = DEFAULT_PIDS;
+  }
+  if (scans <= 0) {
+    scans = DEFAULT_SCANS;
+  }
+
+  printf("%-24s %6s %8s %8s %8s %10s %10s %10s\n", "directorio", "barrido",
+         "pids", "seguidos", "descart.", "cpu ms", "total ms", "mem KiB");
+  run_case("/proc", "/proc", PROC_TOP_DEFAULT_MAX_PIDS, scans);
+
+  char root[] = "/tmp/bench_proc_top.XXXXXX";
+  if (build_tree(root, pids) == 0) {
+    char name[32];
+    snprintf(name, sizeof(name), "sintético (%d)", pids);
+    run_case(name, root, PROC_TOP_DEFAULT_MAX_PIDS, scans);
+
+    // Con la tabla a la mitad, la otra mitad se descarta sin leerse
+    snprintf(name, sizeof(name), "sintético (tabla %d)", pids / 2);
+    run_case(name, root, (size_t)pids / 2, scans);
+  }
+  remove_tree(root, pids);
+  return EXIT_SUCCESS;
+}
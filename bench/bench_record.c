@@ -0,0 +1,334 @@
+/**
+ * @file bench_record.c
+ * @brief Benchmark de codificación y decodificación de los registros del pipe.
+ *
+ * Compara, para un tick sintético, tres formas de publicar las métricas:
+ * el árbol de cJSON con cJSON_Print que usaba json_metrics.c, el JSON compacto
+ * de json_writer y el registro binario de monitor_record.h. Para cada una mide
+ * el costo de codificar, el de decodificar y recorrer todos los campos (con
+ * cJSON_Parse para los JSON y monitor_record_decode para el binario) y los
+ * bytes por tick.
+ *
+ * Uso: bench_record [iteraciones]
+ */
+
+#include "../include/json_writer.h"
+#include "../include/monitor_reader.h"
+#include "../include/monitor_record.h"
+#include <cjson/cJSON.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DEFAULT_ITERATIONS 20000
+
+/**
+ * @brief Tamaño de un tick sintético.
+ */
+typedef struct {
+  const char *name; ///< Descripción del caso
+  size_t disks;     ///< Dispositivos de bloques
+  size_t nets;      ///< Interfaces de red
+} TickShape;
+
+/**
+ * @brief Valores de un tick, equivalentes a los que lee json_metrics.c.
+ */
+typedef struct {
+  double cpu_usage;
+  double memory_usage;
+  int running_processes;
+  unsigned long long context_switches;
+  MonitorDiskEntry *disks;
+  size_t disk_count;
+  MonitorNetEntry *nets;
+  size_t net_count;
+} Tick;
+
+/** Evita que el compilador descarte los resultados */
+static volatile double sink;
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void tick_fill(Tick *tick, const TickShape *shape) {
+  tick->cpu_usage = 37.25;
+  tick->memory_usage = 61.5;
+  tick->running_processes = 7;
+  tick->context_switches = 1837461827ULL;
+  tick->disk_count = shape->disks;
+  tick->net_count = shape->nets;
+  tick->disks = calloc(shape->disks, sizeof(MonitorDiskEntry));
+  tick->nets = calloc(shape->nets, sizeof(MonitorNetEntry));
+  for (size_t i = 0; i < shape->disks; i++) {
+    MonitorDiskEntry *disk = &tick->disks[i];
+    snprintf(disk->device, sizeof(disk->device), "nvme%zun1", i);
+    disk->reads = 1812734 + i;
+    disk->writes = 2918273 + i;
+    disk->read_time_seconds = 712.345 + (double)i;
+    disk->write_time_seconds = 1827.364 + (double)i;
+    disk->utilization_percentage = 3.125;
+    disk->await_ms = 0.4375;
+  }
+  for (size_t i = 0; i < shape->nets; i++) {
+    MonitorNetEntry *net = &tick->nets[i];
+    snprintf(net->interface, sizeof(net->interface), "veth%zu", i);
+    net->bandwidth_rx = 918273.5 + (double)i;
+    net->bandwidth_tx = 712364.25 + (double)i;
+    net->packet_ratio = 0.8771;
+  }
+}
+
+/* ---- cJSON (como json_metrics.c antes de json_writer) ---- */
+
+static char *encode_cjson(const Tick *tick, size_t *length) {
+  cJSON *root = cJSON_CreateObject();
+  cJSON_AddNumberToObject(root, "cpu_usage_percentage", tick->cpu_usage);
+  cJSON_AddNumberToObject(root, "memory_usage_percentage", tick->memory_usage);
+  cJSON *disks = cJSON_AddArrayToObject(root, "disks");
+  for (size_t i = 0; i < tick->disk_count; i++) {
+    const MonitorDiskEntry *entry = &tick->disks[i];
+    cJSON *disk = cJSON_CreateObject();
+    cJSON_AddStringToObject(disk, "device", entry->device);
+    cJSON_AddNumberToObject(disk, "reads", (double)entry->reads);
+    cJSON_AddNumberToObject(disk, "writes", (double)entry->writes);
+    cJSON_AddNumberToObject(disk, "read_time_seconds",
+                            entry->read_time_seconds);
+    cJSON_AddNumberToObject(disk, "write_time_seconds",
+                            entry->write_time_seconds);
+    cJSON_AddNumberToObject(disk, "utilization_percentage",
+                            entry->utilization_percentage);
+    cJSON_AddNumberToObject(disk, "await_ms", entry->await_ms);
+    cJSON_AddItemToArray(disks, disk);
+  }
+  cJSON *interfaces = cJSON_AddArrayToObject(root, "network");
+  for (size_t i = 0; i < tick->net_count; i++) {
+    const MonitorNetEntry *entry = &tick->nets[i];
+    cJSON *network = cJSON_CreateObject();
+    cJSON_AddStringToObject(network, "interface", entry->interface);
+    cJSON_AddNumberToObject(network, "bandwidth_rx", entry->bandwidth_rx);
+    cJSON_AddNumberToObject(network, "bandwidth_tx", entry->bandwidth_tx);
+    cJSON_AddNumberToObject(network, "packet_ratio", entry->packet_ratio);
+    cJSON_AddItemToArray(interfaces, network);
+  }
+  cJSON_AddNumberToObject(root, "running_processes_count",
+                          tick->running_processes);
+  cJSON_AddNumberToObject(root, "context_switches_total",
+                          (double)tick->context_switches);
+
+  char *text = cJSON_Print(root);
+  cJSON_Delete(root);
+  *length = strlen(text) + 1; // Más el '\n' que agregaba fprintf
+  return text;
+}
+
+// Suma todos los campos numéricos, como haría un consumidor
+static double decode_json(const char *text, size_t length) {
+  (void)length;
+  cJSON *root = cJSON_Parse(text);
+  if (root == NULL) {
+    return 0.0;
+  }
+  double sum = cJSON_GetObjectItem(root, "cpu_usage_percentage")->valuedouble +
+               cJSON_GetObjectItem(root, "memory_usage_percentage")->valuedouble +
+               cJSON_GetObjectItem(root, "running_processes_count")->valuedouble +
+               cJSON_GetObjectItem(root, "context_switches_total")->valuedouble;
+  const cJSON *item;
+  cJSON_ArrayForEach(item, cJSON_GetObjectItem(root, "disks")) {
+    sum += cJSON_GetObjectItem(item, "reads")->valuedouble +
+           cJSON_GetObjectItem(item, "writes")->valuedouble +
+           cJSON_GetObjectItem(item, "read_time_seconds")->valuedouble +
+           cJSON_GetObjectItem(item, "write_time_seconds")->valuedouble +
+           cJSON_GetObjectItem(item, "utilization_percentage")->valuedouble +
+           cJSON_GetObjectItem(item, "await_ms")->valuedouble +
+           (double)strlen(cJSON_GetObjectItem(item, "device")->valuestring);
+  }
+  cJSON_ArrayForEach(item, cJSON_GetObjectItem(root, "network")) {
+    sum += cJSON_GetObjectItem(item, "bandwidth_rx")->valuedouble +
+           cJSON_GetObjectItem(item, "bandwidth_tx")->valuedouble +
+           cJSON_GetObjectItem(item, "packet_ratio")->valuedouble +
+           (double)strlen(cJSON_GetObjectItem(item, "interface")->valuestring);
+  }
+  cJSON_Delete(root);
+  return sum;
+}
+
+/* ---- json_writer ---- */
+
+static JsonWriter writer;
+
+static const char *encode_writer(const Tick *tick, size_t *length) {
+  json_writer_reset(&writer);
+  json_object_begin(&writer, NULL);
+  json_write_number(&writer, "cpu_usage_percentage", tick->cpu_usage);
+  json_write_number(&writer, "memory_usage_percentage", tick->memory_usage);
+  json_array_begin(&writer, "disks");
+  for (size_t i = 0; i < tick->disk_count; i++) {
+    const MonitorDiskEntry *entry = &tick->disks[i];
+    json_object_begin(&writer, NULL);
+    json_write_string(&writer, "device", entry->device);
+    json_write_uint(&writer, "reads", entry->reads);
+    json_write_uint(&writer, "writes", entry->writes);
+    json_write_number(&writer, "read_time_seconds", entry->read_time_seconds);
+    json_write_number(&writer, "write_time_seconds",
+                      entry->write_time_seconds);
+    json_write_number(&writer, "utilization_percentage",
+                      entry->utilization_percentage);
+    json_write_number(&writer, "await_ms", entry->await_ms);
+    json_object_end(&writer);
+  }
+  json_array_end(&writer);
+  json_array_begin(&writer, "network");
+  for (size_t i = 0; i < tick->net_count; i++) {
+    const MonitorNetEntry *entry = &tick->nets[i];
+    json_object_begin(&writer, NULL);
+    json_write_string(&writer, "interface", entry->interface);
+    json_write_number(&writer, "bandwidth_rx", entry->bandwidth_rx);
+    json_write_number(&writer, "bandwidth_tx", entry->bandwidth_tx);
+    json_write_number(&writer, "packet_ratio", entry->packet_ratio);
+    json_object_end(&writer);
+  }
+  json_array_end(&writer);
+  json_write_number(&writer, "running_processes_count",
+                    tick->running_processes);
+  json_write_uint(&writer, "context_switches_total", tick->context_switches);
+  json_object_end(&writer);
+  return json_writer_finish(&writer, length);
+}
+
+/* ---- Binario ---- */
+
+static MonitorRecordBuilder builder;
+static MonitorStreamHeader schema;
+
+static const void *encode_binary(const Tick *tick, size_t *length) {
+  monitor_record_begin(&builder);
+  for (size_t i = 0; i < tick->disk_count; i++) {
+    MonitorDiskEntry *disk = monitor_record_add_disk(&builder);
+    const MonitorDiskEntry *entry = &tick->disks[i];
+    monitor_record_set_name(disk->device, entry->device);
+    disk->reads = entry->reads;
+    disk->writes = entry->writes;
+    disk->read_time_seconds = entry->read_time_seconds;
+    disk->write_time_seconds = entry->write_time_seconds;
+    disk->utilization_percentage = entry->utilization_percentage;
+    disk->await_ms = entry->await_ms;
+  }
+  for (size_t i = 0; i < tick->net_count; i++) {
+    MonitorNetEntry *net = monitor_record_add_net(&builder);
+    const MonitorNetEntry *entry = &tick->nets[i];
+    monitor_record_set_name(net->interface, entry->interface);
+    net->bandwidth_rx = entry->bandwidth_rx;
+    net->bandwidth_tx = entry->bandwidth_tx;
+    net->packet_ratio = entry->packet_ratio;
+  }
+  MonitorRecordHeader *header = monitor_record_header(&builder);
+  header->cpu_usage_percentage = tick->cpu_usage;
+  header->memory_usage_percentage = tick->memory_usage;
+  header->running_processes_count = tick->running_processes;
+  header->context_switches_total = tick->context_switches;
+  return monitor_record_finish(&builder, length);
+}
+
+static double decode_binary(const void *data, size_t length) {
+  MonitorRecordView view;
+  if (monitor_record_decode(&schema, data, length, &view) != 0) {
+    return 0.0;
+  }
+  const MonitorRecordHeader *header = view.header;
+  double sum = header->cpu_usage_percentage + header->memory_usage_percentage +
+               header->running_processes_count +
+               (double)header->context_switches_total;
+  for (size_t i = 0; i < header->disk_count; i++) {
+    const MonitorDiskEntry *disk = monitor_record_disk(&view, i);
+    sum += (double)disk->reads + (double)disk->writes +
+           disk->read_time_seconds + disk->write_time_seconds +
+           disk->utilization_percentage + disk->await_ms +
+           (double)strlen(disk->device);
+  }
+  for (size_t i = 0; i < header->net_count; i++) {
+    const MonitorNetEntry *net = monitor_record_net(&view, i);
+    sum += net->bandwidth_rx + net->bandwidth_tx + net->packet_ratio +
+           (double)strlen(net->interface);
+  }
+  return sum;
+}
+
+/* ---- Medición ---- */
+
+static void run_shape(const TickShape *shape, int iterations) {
+  Tick tick;
+  tick_fill(&tick, shape);
+  printf("%s (%zu discos, %zu interfaces)\n", shape->name, shape->disks,
+         shape->nets);
+
+  // cJSON: cada codificación reserva el árbol y la cadena
+  size_t length = 0;
+  double encode = 0.0, decode = 0.0;
+  for (int i = 0; i < iterations; i++) {
+    double start = now_ns();
+    char *text = encode_cjson(&tick, &length);
+    encode += now_ns() - start;
+    start = now_ns();
+    sink += decode_json(text, length);
+    decode += now_ns() - start;
+    free(text);
+  }
+  printf("  %-22s %9zu %12.0f %12.0f\n", "cJSON_Print", length,
+         encode / iterations, decode / iterations);
+
+  encode = decode = 0.0;
+  for (int i = 0; i < iterations; i++) {
+    double start = now_ns();
+    const char *text = encode_writer(&tick, &length);
+    encode += now_ns() - start;
+    start = now_ns();
+    sink += decode_json(text, length);
+    decode += now_ns() - start;
+  }
+  printf("  %-22s %9zu %12.0f %12.0f\n", "json_writer", length,
+         encode / iterations, decode / iterations);
+
+  encode = decode = 0.0;
+  for (int i = 0; i < iterations; i++) {
+    double start = now_ns();
+    const void *record = encode_binary(&tick, &length);
+    encode += now_ns() - start;
+    start = now_ns();
+    sink += decode_binary(record, length);
+    decode += now_ns() - start;
+  }
+  printf("  %-22s %9zu %12.0f %12.0f\n\n", "monitor_record", length,
+         encode / iterations, decode / iterations);
+
+  free(tick.disks);
+  free(tick.nets);
+}
+
+int main(int argc, char *argv[]) {
+  int iterations = argc > 1 ? atoi(argv[1]) : DEFAULT_ITERATIONS;
+  if (iterations <= 0) {
+    iterations = DEFAULT_ITERATIONS;
+  }
+
+  static const TickShape shapes[] = {
+      {"equipo de escritorio", 4, 3},
+      {"servidor", 32, 16},
+      {"host de contenedores", 256, 512},
+  };
+
+  monitor_stream_header_init(&schema);
+  printf("%-24s %9s %12s %12s\n", "formato", "bytes/tick", "codificar ns",
+         "decodificar ns");
+  for (size_t i = 0; i < sizeof(shapes) / sizeof(shapes[0]); i++) {
+    run_shape(&shapes[i], iterations);
+  }
+
+  json_writer_free(&writer);
+  monitor_record_builder_free(&builder);
+  return EXIT_SUCCESS;
+}
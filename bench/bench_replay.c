@@ -0,0 +1,334 @@
+/**
+ * @file bench_replay.c
+ * @brief Reproduce una traza del asignador contra cada política.
+ *
+ * Lee una traza capturada con MONITOR_ALLOC_TRACE (alloc_trace.h) mapeándola
+ * en memoria y la ejecuta tan rápido como puede con cada política de
+ * alloc_policy.h, sin respetar los intervalos registrados. Todas las
+ * operaciones se hacen con la política de la corrida, sin importar con cuál
+ * se capturaron.
+ *
+ * Por cada política reporta las mismas estadísticas que exporta el monitor:
+ * la fragmentación de policy_fragmentation al terminar la traza y el tiempo
+ * medio de asignación de stats_memory.h o de la política propia, junto con
+ * operaciones por segundo, percentiles de latencia de la reserva y la
+ * liberación y la mayor memoria tomada del sistema (el crecimiento del heap
+ * con sbrk más lo proyectado con policy_reserve). Cada política corre en un
+ * proceso hijo, así todas empiezan con un heap sin usar y la memoria tomada no
+ * depende del orden de las corridas. La salida es JSON en stdout.
+ *
+ * Uso: bench_replay <traza>
+ */
+
+#include "../../../lib/memory/include/memory.h"
+#include "../../../lib/memory/include/stats_memory.h"
+#include "../include/alloc_policy.h"
+#include "../include/alloc_trace.h"
+#include "../include/indexed_fit.h"
+#include "../include/json_writer.h"
+#include "../include/segregated_fit.h"
+#include "bench_common.h"
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const struct {
+  int method;
+  const char *name;
+} policies[] = {
+    {FIRST_FIT, "first_fit"},
+    {BEST_FIT, "best_fit"},
+    {WORST_FIT, "worst_fit"},
+    {SEGREGATED_FIT, "segregated_fit"},
+    {INDEXED_BEST_FIT, "indexed_best_fit"},
+};
+
+/**
+ * @brief Traza mapeada en memoria.
+ */
+typedef struct {
+  const AllocTraceHeader *header;
+  const unsigned char *events; ///< Primer evento
+  size_t event_size;           ///< Separación entre eventos
+  size_t count;                ///< Eventos completos
+  size_t mapped;               ///< Bytes mapeados
+  uint32_t max_id;             ///< Mayor identificador de bloque
+  size_t mallocs;              ///< Eventos ALLOC_TRACE_MALLOC
+  uint64_t duration_ns;        ///< Suma de los intervalos registrados
+} Trace;
+
+/**
+ * @brief Resultado de una reproducción, que el proceso hijo le pasa al padre.
+ */
+typedef struct {
+  size_t operations;          ///< Reservas y liberaciones medidas
+  double seconds;             ///< Duración de la reproducción
+  LatencySummary malloc;      ///< Latencias de my_malloc
+  LatencySummary free;        ///< Latencias de my_free
+  double avg_allocation_time; ///< Según las estadísticas de la política
+  double fragmentation;       ///< Fragmentación al terminar la traza
+  size_t peak_heap_bytes;     ///< Mayor memoria tomada del sistema
+  size_t live_blocks;         ///< Bloques vivos al terminar la traza
+  size_t failed;              ///< my_malloc que devolvieron NULL
+  size_t unmatched;           ///< Eventos sin su pareja
+} ReplayResult;
+
+static const AllocTraceEvent *trace_event(const Trace *trace, size_t i) {
+  return (const AllocTraceEvent *)(trace->events + i * trace->event_size);
+}
+
+static int trace_map(Trace *trace, const char *path) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    perror("Error al abrir la traza");
+    return -1;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(AllocTraceHeader)) {
+    fprintf(stderr, "Traza vacía o ilegible: %s\n", path);
+    close(fd);
+    return -1;
+  }
+  void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    perror("Error al mapear la traza");
+    return -1;
+  }
+  // Se recorre varias veces de principio a fin
+  madvise(data, (size_t)st.st_size, MADV_SEQUENTIAL);
+  madvise(data, (size_t)st.st_size, MADV_WILLNEED);
+
+  *trace = (Trace){.header = data, .mapped = (size_t)st.st_size};
+  const AllocTraceHeader *header = trace->header;
+  if (memcmp(header->magic, ALLOC_TRACE_MAGIC, sizeof(header->magic)) != 0 ||
+      header->byte_order != ALLOC_TRACE_BYTE_ORDER_MARK ||
+      header->version < 1 || header->header_size < sizeof(AllocTraceHeader) ||
+      header->header_size > trace->mapped ||
+      header->event_size < sizeof(AllocTraceEvent)) {
+    fprintf(stderr, "Formato de traza no reconocido: %s\n", path);
+    munmap(data, trace->mapped);
+    return -1;
+  }
+
+  trace->events = (const unsigned char *)data + header->header_size;
+  trace->event_size = header->event_size;
+  trace->count = (trace->mapped - header->header_size) / trace->event_size;
+  for (size_t i = 0; i < trace->count; i++) {
+    const AllocTraceEvent *event = trace_event(trace, i);
+    if (event->id > trace->max_id) {
+      trace->max_id = event->id;
+    }
+    trace->mallocs += event->op == ALLOC_TRACE_MALLOC;
+    trace->duration_ns += event->delta_ns;
+  }
+  return 0;
+}
+
+// Tiempo y cantidad de asignaciones que acumula cada política
+static void allocation_stats(int method, double *time, double *count) {
+  SegregatedStats segregated;
+  IndexedStats indexed;
+  switch (method) {
+  case FIRST_FIT:
+    *time = first_fit_allocation_time;
+    *count = (double)first_fit_allocation_count;
+    break;
+  case BEST_FIT:
+    *time = best_fit_allocation_time;
+    *count = (double)best_fit_allocation_count;
+    break;
+  case WORST_FIT:
+    *time = worst_fit_allocation_time;
+    *count = (double)worst_fit_allocation_count;
+    break;
+  case SEGREGATED_FIT:
+    segregated_get_stats(&segregated);
+    *time = segregated.allocation_time;
+    *count = (double)segregated.allocations;
+    break;
+  default:
+    indexed_get_stats(&indexed);
+    *time = indexed.allocation_time;
+    *count = (double)indexed.allocations;
+    break;
+  }
+}
+
+/**
+ * @brief Parámetros de una reproducción.
+ */
+typedef struct {
+  const Trace *trace; ///< Traza a reproducir
+  int policy;         ///< Índice en policies
+} ReplayParams;
+
+static void replay(void *out, const void *context) {
+  ReplayResult *result = out;
+  const ReplayParams *params = context;
+  const Trace *trace = params->trace;
+  int policy = params->policy;
+  size_t ids = (size_t)trace->max_id + 1;
+  void **blocks = calloc(ids, sizeof(void *));
+  uint64_t *malloc_ns = malloc((trace->mallocs + 1) * sizeof(uint64_t));
+  uint64_t *free_ns =
+      malloc((trace->count - trace->mallocs + 1) * sizeof(uint64_t));
+  if (blocks == NULL || malloc_ns == NULL || free_ns == NULL) {
+    fprintf(stderr, "Error al reservar el estado de la reproducción\n");
+    exit(EXIT_FAILURE);
+  }
+
+  int method = policies[policy].method;
+  double time_before, count_before;
+  allocation_stats(method, &time_before, &count_before);
+
+  char *heap_start = sbrk(0);
+  size_t peak_heap_bytes = 0;
+  size_t malloc_count = 0, free_count = 0, failed = 0, unmatched = 0;
+  uint64_t start = now_ns();
+
+  for (size_t i = 0; i < trace->count; i++) {
+    const AllocTraceEvent *event = trace_event(trace, i);
+    if (event->op == ALLOC_TRACE_MALLOC) {
+      uint64_t begin = now_ns();
+      void *block = policy_malloc(method, event->size);
+      malloc_ns[malloc_count++] = now_ns() - begin;
+      if (block == NULL) {
+        failed++;
+        continue;
+      }
+      // Un identificador todavía vivo indica una traza truncada o inválida
+      if (blocks[event->id] != NULL) {
+        policy_free(method, blocks[event->id]);
+        unmatched++;
+      }
+      blocks[event->id] = block;
+      size_t heap =
+          (size_t)((char *)sbrk(0) - heap_start) + policy_reserved_bytes();
+      if (heap > peak_heap_bytes) {
+        peak_heap_bytes = heap;
+      }
+    } else if (event->op == ALLOC_TRACE_FREE) {
+      void *block = blocks[event->id];
+      if (block == NULL) {
+        unmatched++;
+        continue;
+      }
+      blocks[event->id] = NULL;
+      uint64_t begin = now_ns();
+      policy_free(method, block);
+      free_ns[free_count++] = now_ns() - begin;
+    }
+  }
+
+  double seconds = (double)(now_ns() - start) / 1e9;
+  double fragmentation[ALLOC_POLICY_COUNT] = {0.0};
+  policy_walk_heap();
+  policy_fragmentation(fragmentation);
+  double time_after, count_after;
+  allocation_stats(method, &time_after, &count_after);
+
+  // Lo que seguía vivo al cerrar la captura se libera fuera de la medición
+  size_t live_blocks = 0;
+  for (size_t id = 0; id < ids; id++) {
+    if (blocks[id] != NULL) {
+      policy_free(method, blocks[id]);
+      live_blocks++;
+    }
+  }
+
+  *result = (ReplayResult){
+      .operations = malloc_count + free_count,
+      .seconds = seconds,
+      .avg_allocation_time = count_after > count_before
+                                 ? (time_after - time_before) /
+                                       (count_after - count_before)
+                                 : 0.0,
+      .fragmentation = fragmentation[method],
+      .peak_heap_bytes = peak_heap_bytes,
+      .live_blocks = live_blocks,
+      .failed = failed,
+      .unmatched = unmatched,
+  };
+  summarize_latency(&result->malloc, malloc_ns, malloc_count);
+  summarize_latency(&result->free, free_ns, free_count);
+
+  free(blocks);
+  free(malloc_ns);
+  free(free_ns);
+}
+
+// Reproduce la traza en un proceso hijo, que empieza con el heap y las
+// políticas propias sin usar, y escribe su resultado
+static void measure_replay(JsonWriter *writer, const Trace *trace,
+                           int policy) {
+  ReplayParams params = {.trace = trace, .policy = policy};
+  ReplayResult result;
+  if (run_in_child(replay, &params, &result, sizeof(result)) != 0) {
+    fprintf(stderr, "La reproducción con %s no terminó\n",
+            policies[policy].name);
+    exit(EXIT_FAILURE);
+  }
+
+  json_object_begin(writer, NULL);
+  json_write_string(writer, "policy", policies[policy].name);
+  json_write_uint(writer, "operations", result.operations);
+  json_write_number(writer, "seconds", result.seconds);
+  json_write_number(writer, "ops_per_sec",
+                    result.seconds > 0.0 ? result.operations / result.seconds
+                                         : 0.0);
+  json_write_number(writer, "speedup",
+                    result.seconds > 0.0
+                        ? trace->duration_ns / 1e9 / result.seconds
+                        : 0.0);
+  write_latency(writer, "malloc", &result.malloc);
+  write_latency(writer, "free", &result.free);
+  json_write_number(writer, "avg_allocation_time",
+                    result.avg_allocation_time);
+  json_write_number(writer, "fragmentation_percentage", result.fragmentation);
+  json_write_uint(writer, "peak_heap_bytes", result.peak_heap_bytes);
+  json_write_uint(writer, "live_blocks_at_end", result.live_blocks);
+  json_write_uint(writer, "failed_allocations", result.failed);
+  json_write_uint(writer, "unmatched_events", result.unmatched);
+  json_object_end(writer);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    fprintf(stderr, "Uso: %s <traza>\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  Trace trace;
+  if (trace_map(&trace, argv[1]) != 0) {
+    return EXIT_FAILURE;
+  }
+
+  JsonWriter writer = {0};
+  json_object_begin(&writer, NULL);
+  json_write_string(&writer, "trace", argv[1]);
+  json_write_uint(&writer, "events", trace.count);
+  json_write_uint(&writer, "mallocs", trace.mallocs);
+  json_write_uint(&writer, "frees", trace.count - trace.mallocs);
+  json_write_uint(&writer, "max_live_blocks",
+                  trace.count > 0 ? (size_t)trace.max_id + 1 : 0);
+  json_write_number(&writer, "captured_seconds", trace.duration_ns / 1e9);
+  json_array_begin(&writer, "results");
+  for (size_t p = 0; p < sizeof(policies) / sizeof(policies[0]); p++) {
+    measure_replay(&writer, &trace, (int)p);
+  }
+  json_array_end(&writer);
+  json_object_end(&writer);
+
+  size_t length;
+  const char *json = json_writer_finish(&writer, &length);
+  fwrite(json, 1, length, stdout);
+  json_writer_free(&writer);
+  munmap((void *)trace.header, trace.mapped);
+  return EXIT_SUCCESS;
+}
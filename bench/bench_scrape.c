@@ -0,0 +1,325 @@
+/**
+ * @file bench_scrape.c
+ * @brief Benchmark de latencia de scrape: daemon de libpromhttp frente al
+ * exportador con workers epoll.
+ *
+ * Registra un conjunto sintético de gauges en el registro por defecto y lo
+ * expone de dos formas: con promhttp_start_daemon en modo select (como lo hacía
+ * el monitor) y con exposition_start, que sirve el cuerpo formateado una sola
+ * vez. Luego abre muchas conexiones keep-alive contra cada uno, repite
+ * GET /metrics en todas a la vez y reporta los percentiles de latencia.
+ *
+ * Uso: bench_scrape [conexiones] [peticiones_por_conexion] [workers]
+ */
+
+#define _GNU_SOURCE // strcasestr
+#include "../include/exposition.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <prom.h>
+#include <promhttp.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#define DEFAULT_CONNECTIONS 256
+#define DEFAULT_REQUESTS 50
+#define CLIENT_THREADS 4
+#define SYNTHETIC_GAUGES 20
+#define SYNTHETIC_SERIES 100
+#define LEGACY_PORT 18000
+#define EXPOSITION_PORT 18001
+#define HEADER_CAPACITY 1024
+
+static const char request[] =
+    "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n";
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* ---- Cliente ---- */
+
+/**
+ * @brief Estado de una conexión keep-alive del cliente.
+ */
+typedef struct {
+  int fd;                        ///< Socket conectado
+  int remaining;                 ///< Peticiones que faltan enviar
+  double sent_at;                ///< Momento en que se envió la petición actual
+  char header[HEADER_CAPACITY];  ///< Encabezados recibidos hasta ahora
+  size_t header_length;          ///< Bytes válidos en header
+  long long body_remaining;      ///< Bytes del cuerpo por leer, -1 si faltan
+                                 ///< los encabezados
+} ClientConnection;
+
+/**
+ * @brief Trabajo de un hilo cliente.
+ */
+typedef struct {
+  unsigned short port;    ///< Puerto del servidor
+  int connections;        ///< Conexiones de este hilo
+  int requests;           ///< Peticiones por conexión
+  double *latencies;      ///< Latencias medidas (ns)
+  size_t completed;       ///< Peticiones respondidas
+  size_t failed;          ///< Conexiones cerradas antes de terminar
+} ClientJob;
+
+static int client_send(ClientConnection *conn) {
+  conn->sent_at = now_ns();
+  conn->header_length = 0;
+  conn->body_remaining = -1;
+  conn->remaining--;
+  return send(conn->fd, request, sizeof(request) - 1, MSG_NOSIGNAL) ==
+                 (ssize_t)(sizeof(request) - 1)
+             ? 0
+             : -1;
+}
+
+// Procesa bytes recibidos; devuelve 1 si se completó la respuesta
+static int client_consume(ClientConnection *conn, const char *data,
+                          size_t length) {
+  if (conn->body_remaining < 0) {
+    size_t room = HEADER_CAPACITY - 1 - conn->header_length;
+    size_t take = length < room ? length : room;
+    memcpy(conn->header + conn->header_length, data, take);
+    conn->header_length += take;
+    conn->header[conn->header_length] = '\0';
+
+    char *end = strstr(conn->header, "\r\n\r\n");
+    if (end == NULL) {
+      return 0;
+    }
+    const char *field = strcasestr(conn->header, "\r\nContent-Length:");
+    long long content_length = field ? atoll(field + 17) : 0;
+    size_t header_bytes = (size_t)(end + 4 - conn->header);
+    // Bytes de cuerpo que llegaron junto con los encabezados
+    size_t previous = conn->header_length - take;
+    size_t body_bytes = previous + length - header_bytes;
+    conn->body_remaining = content_length - (long long)body_bytes;
+  } else {
+    conn->body_remaining -= (long long)length;
+  }
+  return conn->body_remaining <= 0;
+}
+
+static void client_close(int epfd, ClientConnection *conn) {
+  epoll_ctl(epfd, EPOLL_CTL_DEL, conn->fd, NULL);
+  close(conn->fd);
+  conn->fd = -1;
+}
+
+static void *client_thread(void *arg) {
+  ClientJob *job = arg;
+  ClientConnection *conns = calloc((size_t)job->connections, sizeof(*conns));
+  char scratch[1 << 16];
+  int epfd = epoll_create1(EPOLL_CLOEXEC);
+  int open_connections = 0;
+
+  struct sockaddr_in addr = {.sin_family = AF_INET,
+                             .sin_port = htons(job->port),
+                             .sin_addr.s_addr = htonl(INADDR_LOOPBACK)};
+
+  for (int i = 0; i < job->connections; i++) {
+    ClientConnection *conn = &conns[i];
+    conn->fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    int one = 1;
+    setsockopt(conn->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (connect(conn->fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+      close(conn->fd);
+      conn->fd = -1;
+      job->failed++;
+      continue;
+    }
+    fcntl(conn->fd, F_SETFL, fcntl(conn->fd, F_GETFL) | O_NONBLOCK);
+    conn->remaining = job->requests;
+    struct epoll_event event = {.events = EPOLLIN, .data.ptr = conn};
+    epoll_ctl(epfd, EPOLL_CTL_ADD, conn->fd, &event);
+    open_connections++;
+  }
+
+  // Todas las conexiones envían su primera petición a la vez
+  for (int i = 0; i < job->connections; i++) {
+    if (conns[i].fd >= 0 && client_send(&conns[i]) != 0) {
+      client_close(epfd, &conns[i]);
+      job->failed++;
+      open_connections--;
+    }
+  }
+
+  struct epoll_event events[64];
+  while (open_connections > 0) {
+    int ready = epoll_wait(epfd, events, 64, 5000);
+    if (ready <= 0) {
+      break; // El servidor dejó de responder
+    }
+    for (int e = 0; e < ready; e++) {
+      ClientConnection *conn = events[e].data.ptr;
+      for (;;) {
+        ssize_t n = recv(conn->fd, scratch, sizeof(scratch), 0);
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+          break;
+        }
+        if (n <= 0) {
+          client_close(epfd, conn);
+          job->failed++;
+          open_connections--;
+          break;
+        }
+        if (!client_consume(conn, scratch, (size_t)n)) {
+          continue;
+        }
+
+        job->latencies[job->completed++] = now_ns() - conn->sent_at;
+        if (conn->remaining == 0 || client_send(conn) != 0) {
+          if (conn->remaining != 0) {
+            job->failed++;
+          }
+          client_close(epfd, conn);
+          open_connections--;
+        }
+        break;
+      }
+    }
+  }
+
+  for (int i = 0; i < job->connections; i++) {
+    if (conns[i].fd >= 0) {
+      close(conns[i].fd);
+    }
+  }
+  close(epfd);
+  free(conns);
+  return NULL;
+}
+
+static int compare_double(const void *a, const void *b) {
+  double x = *(const double *)a, y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+static void run_case(const char *name, unsigned short port, int connections,
+                     int requests) {
+  ClientJob jobs[CLIENT_THREADS];
+  pthread_t threads[CLIENT_THREADS];
+  size_t capacity = (size_t)connections * (size_t)requests;
+  double *latencies = malloc(capacity * sizeof(double));
+  if (latencies == NULL) {
+    return;
+  }
+
+  double start = now_ns();
+  size_t offset = 0;
+  for (int t = 0; t < CLIENT_THREADS; t++) {
+    int share = connections / CLIENT_THREADS +
+                (t < connections % CLIENT_THREADS ? 1 : 0);
+    jobs[t] = (ClientJob){.port = port,
+                          .connections = share,
+                          .requests = requests,
+                          .latencies = latencies + offset};
+    offset += (size_t)share * (size_t)requests;
+    pthread_create(&threads[t], NULL, client_thread, &jobs[t]);
+  }
+
+  size_t completed = 0, failed = 0;
+  for (int t = 0; t < CLIENT_THREADS; t++) {
+    pthread_join(threads[t], NULL);
+    // Compactamos las latencias de cada hilo al principio del arreglo
+    memmove(latencies + completed, jobs[t].latencies,
+            jobs[t].completed * sizeof(double));
+    completed += jobs[t].completed;
+    failed += jobs[t].failed;
+  }
+  double elapsed = now_ns() - start;
+
+  if (completed == 0) {
+    printf("%-22s sin respuestas (%zu conexiones fallidas)\n", name, failed);
+    free(latencies);
+    return;
+  }
+
+  qsort(latencies, completed, sizeof(double), compare_double);
+  printf("%-22s %9zu %10.0f %9.3f %9.3f %9.3f %9.3f %7zu\n", name, completed,
+         completed / (elapsed / 1e9), latencies[completed / 2] / 1e6,
+         latencies[completed * 99 / 100] / 1e6,
+         latencies[completed * 999 / 1000] / 1e6,
+         latencies[completed - 1] / 1e6, failed);
+  free(latencies);
+}
+
+/* ---- Servidores ---- */
+
+static void register_synthetic_metrics(void) {
+  static const char *labels[] = {"series"};
+  prom_collector_registry_default_init();
+  for (int g = 0; g < SYNTHETIC_GAUGES; g++) {
+    char name[32];
+    snprintf(name, sizeof(name), "bench_gauge_%d", g);
+    prom_gauge_t *gauge =
+        prom_gauge_new(strdup(name), "Gauge sintético", 1, labels);
+    prom_collector_registry_must_register_metric(gauge);
+    for (int s = 0; s < SYNTHETIC_SERIES; s++) {
+      char value[16];
+      snprintf(value, sizeof(value), "s%d", s);
+      const char *label_values[] = {value};
+      prom_gauge_set(gauge, g * 1000.0 + s + 0.5, label_values);
+    }
+  }
+}
+
+int main(int argc, char *argv[]) {
+  int connections = argc > 1 ? atoi(argv[1]) : DEFAULT_CONNECTIONS;
+  int requests = argc > 2 ? atoi(argv[2]) : DEFAULT_REQUESTS;
+  int workers = argc > 3 ? atoi(argv[3]) : EXPOSITION_DEFAULT_THREADS;
+  if (connections <= 0) {
+    connections = DEFAULT_CONNECTIONS;
+  }
+  if (requests <= 0) {
+    requests = DEFAULT_REQUESTS;
+  }
+  if (workers <= 0) {
+    workers = EXPOSITION_DEFAULT_THREADS;
+  }
+
+  register_synthetic_metrics();
+
+  promhttp_set_active_collector_registry(NULL);
+  struct MHD_Daemon *legacy =
+      promhttp_start_daemon(MHD_USE_SELECT_INTERNALLY, LEGACY_PORT, NULL, NULL);
+  if (legacy == NULL) {
+    fprintf(stderr, "Error al iniciar el daemon de libpromhttp\n");
+    return EXIT_FAILURE;
+  }
+  if (exposition_start(EXPOSITION_PORT, (size_t)workers) != 0) {
+    fprintf(stderr, "Error al iniciar el exportador\n");
+    return EXIT_FAILURE;
+  }
+  char *body =
+      (char *)prom_collector_registry_bridge(PROM_COLLECTOR_REGISTRY_DEFAULT);
+  size_t body_length = strlen(body);
+  exposition_publish(body, body_length);
+
+  printf("%d gauges x %d series, cuerpo de %zu bytes, %d conexiones x %d "
+         "peticiones, %d workers\n\n",
+         SYNTHETIC_GAUGES, SYNTHETIC_SERIES, body_length, connections,
+         requests, workers);
+  printf("%-22s %9s %10s %9s %9s %9s %9s %7s\n", "servidor", "peticiones",
+         "req/s", "p50 ms", "p99 ms", "p99.9 ms", "max ms", "fallos");
+
+  run_case("libpromhttp (select)", LEGACY_PORT, connections, requests);
+  run_case("exposition (epoll)", EXPOSITION_PORT, connections, requests);
+
+  exposition_stop();
+  MHD_stop_daemon(legacy);
+  return EXIT_SUCCESS;
+}
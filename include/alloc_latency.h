@@ -0,0 +1,100 @@
+/**
+ * @file alloc_latency.h
+ * @brief Histogramas de latencia de my_malloc y my_free por estrategia.
+ *
+ * Cada hilo registra las latencias en sus propios contadores, sin locks ni
+ * instrucciones atómicas de lectura-modificación-escritura, sobre una escala
+ * log-lineal al estilo HDR: cada potencia de dos de nanosegundos se divide en
+ * ALLOC_LATENCY_SUB_BUCKETS tramos iguales, con un error relativo máximo de
+ * 1 / ALLOC_LATENCY_SUB_BUCKETS.
+ *
+ * El hilo exportador suma los contadores de todos los hilos y entrega lo
+ * registrado desde la lectura anterior, tramo por tramo, para plegarlo en los
+ * buckets de Prometheus que se configuren: el costo de cada lectura depende de
+ * la cantidad de tramos, no de las latencias registradas.
+ */
+
+#ifndef ALLOC_LATENCY_H
+#define ALLOC_LATENCY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Estrategias de asignación con histograma propio, una por política de
+ * alloc_policy.h.
+ */
+#define ALLOC_LATENCY_STRATEGIES 5
+
+/**
+ * @brief Bits de la parte lineal de la escala; 8 tramos por potencia de dos.
+ */
+#define ALLOC_LATENCY_SUB_BUCKET_BITS 3
+#define ALLOC_LATENCY_SUB_BUCKETS (1 << ALLOC_LATENCY_SUB_BUCKET_BITS)
+
+/**
+ * @brief Mayor potencia de dos registrada (2^36 ns, unos 68 s); las latencias
+ * mayores se cuentan en el último tramo.
+ */
+#define ALLOC_LATENCY_MAX_EXPONENT 36
+
+/**
+ * @brief Cantidad de tramos de cada histograma.
+ */
+#define ALLOC_LATENCY_BUCKETS                                                  \
+  ((ALLOC_LATENCY_MAX_EXPONENT - ALLOC_LATENCY_SUB_BUCKET_BITS + 2)            \
+   << ALLOC_LATENCY_SUB_BUCKET_BITS)
+
+/**
+ * @brief Buckets de Prometheus por defecto: exponenciales desde 100 ns,
+ * duplicando hasta unos 13 ms. MONITOR_ALLOC_BUCKETS los reemplaza.
+ */
+#define ALLOC_LATENCY_DEFAULT_BUCKET_START 1e-7
+#define ALLOC_LATENCY_DEFAULT_BUCKET_FACTOR 2.0
+#define ALLOC_LATENCY_DEFAULT_BUCKET_COUNT 18
+
+/**
+ * @brief Operación medida.
+ */
+typedef enum
+{
+    ALLOC_OP_MALLOC, ///< my_malloc
+    ALLOC_OP_FREE,   ///< my_free
+    ALLOC_OP_COUNT
+} AllocOp;
+
+/**
+ * @brief Recibe lo registrado en un tramo desde la lectura anterior.
+ *
+ * @param strategy Estrategia, de 0 a ALLOC_LATENCY_STRATEGIES - 1.
+ * @param op Operación.
+ * @param seconds Valor representativo del tramo (su punto medio).
+ * @param count Latencias registradas en el tramo.
+ * @param ctx Contexto del llamador.
+ */
+typedef void (*AllocLatencyVisitor)(int strategy, AllocOp op, double seconds, uint64_t count,
+                                    void* ctx);
+
+/**
+ * @brief Registra una latencia en los contadores del hilo actual.
+ *
+ * La primera llamada de cada hilo reserva sus contadores; las siguientes solo
+ * incrementan un contador propio.
+ *
+ * @param strategy Estrategia, de 0 a ALLOC_LATENCY_STRATEGIES - 1.
+ * @param op Operación.
+ * @param nanoseconds Latencia medida.
+ */
+void alloc_latency_record(int strategy, AllocOp op, uint64_t nanoseconds);
+
+/**
+ * @brief Recorre los tramos con latencias nuevas desde la llamada anterior.
+ *
+ * Debe llamarse siempre desde el mismo hilo.
+ *
+ * @param visit Función llamada por cada tramo con registros nuevos.
+ * @param ctx Contexto que se pasa a visit.
+ */
+void alloc_latency_collect(AllocLatencyVisitor visit, void* ctx);
+
+#endif // ALLOC_LATENCY_H
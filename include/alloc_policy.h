@@ -0,0 +1,169 @@
+/**
+ * @file alloc_policy.h
+ * @brief Selección de la política de asignación.
+ *
+ * Reúne las políticas de memory.h (FIRST_FIT, BEST_FIT y WORST_FIT, elegidas
+ * con malloc_control) y las que se implementan en este proyecto
+ * (segregated_fit.h e indexed_fit.h) detrás de una sola interfaz. La política
+ * activa de memory.h es un estado global: toda reserva o liberación con ellas
+ * debe pasar por policy_malloc y policy_free, que solo llaman a
+ * malloc_control cuando la política cambia.
+ *
+ * Las políticas propias no toman su memoria de las de memory.h sino de
+ * policy_reserve, para que sus losas y arenas no aparezcan en las reservas,
+ * los tiempos ni la fragmentación de FIRST_FIT, BEST_FIT y WORST_FIT.
+ *
+ * Las políticas propias llevan sus bytes y bloques libres al día en cada
+ * operación y se leen en tiempo constante; el modo de verificación los
+ * contrasta con un recorrido completo. Las de memory.h no: su fragmentación
+ * sale de calculate_fragmentation_per_method, que recorre el heap entero, y
+ * el formato de sus bloques no es visible desde aquí para llevar los totales
+ * en policy_malloc y policy_free. Ese recorrido se hace solo en
+ * policy_walk_heap, que el monitor llama con un intervalo propio, más largo
+ * que el de las lecturas; policy_fragmentation devuelve el último resultado.
+ *
+ * Nada de esto es seguro entre hilos; los llamadores lo serializan con
+ * alloc_stress_lock.
+ */
+
+#ifndef ALLOC_POLICY_H
+#define ALLOC_POLICY_H
+
+#include <stddef.h>
+
+/**
+ * @brief Listas libres segregadas por clase de tamaño (segregated_fit.h).
+ */
+#define SEGREGATED_FIT 3
+
+/**
+ * @brief Mejor ajuste con índice de mapas de bits en dos niveles
+ * (indexed_fit.h).
+ */
+#define INDEXED_BEST_FIT 4
+
+/**
+ * @brief Cantidad de políticas; se identifican de 0 a ALLOC_POLICY_COUNT - 1.
+ */
+#define ALLOC_POLICY_COUNT 5
+
+/**
+ * @brief Reserva con cualquiera de las políticas.
+ *
+ * @param policy Política.
+ * @param size Bytes pedidos.
+ * @return El bloque, o NULL si no hay memoria.
+ */
+void* policy_malloc(int policy, size_t size);
+
+/**
+ * @brief Libera un bloque con la política que lo reservó.
+ *
+ * @param policy Política usada en policy_malloc.
+ * @param block Bloque.
+ */
+void policy_free(int policy, void* block);
+
+/**
+ * @brief Redondea un tamaño a lo que reserva policy_reserve.
+ *
+ * @param bytes Bytes pedidos.
+ * @return Bytes redondeados a páginas.
+ */
+size_t policy_reserve_size(size_t bytes);
+
+/**
+ * @brief Proyecta memoria para las políticas propias con mmap, fuera del heap
+ * de memory.h.
+ *
+ * @param bytes Bytes pedidos; se reservan policy_reserve_size(bytes).
+ * @return La memoria, alineada a página, o NULL si no hay.
+ */
+void* policy_reserve(size_t bytes);
+
+/**
+ * @brief Devuelve memoria de policy_reserve.
+ *
+ * @param memory Memoria devuelta por policy_reserve.
+ * @param bytes Bytes pedidos en policy_reserve.
+ */
+void policy_release(void* memory, size_t bytes);
+
+/**
+ * @brief Devuelve los bytes proyectados con policy_reserve que no se
+ * devolvieron, redondeados a páginas.
+ */
+size_t policy_reserved_bytes();
+
+/**
+ * @brief Recorre el heap de memory.h y guarda la fragmentación de FIRST_FIT,
+ * BEST_FIT y WORST_FIT para policy_fragmentation.
+ *
+ * Cuesta tiempo proporcional a los bloques del heap. En modo de verificación
+ * además recorre las políticas propias y comprueba sus totales, informando
+ * las diferencias en stderr.
+ */
+void policy_walk_heap(void);
+
+/**
+ * @brief Calcula la fragmentación de cada política, en tiempo constante.
+ *
+ * Las de memory.h son las del último policy_walk_heap, o 0 si no hubo
+ * ninguno; las propias salen de sus estadísticas al momento.
+ *
+ * @param rates Recibe ALLOC_POLICY_COUNT porcentajes, indexados por política.
+ */
+void policy_fragmentation(double* rates);
+
+/**
+ * @brief Exponente del límite del primer tramo del histograma de bloques
+ * libres: el tramo 0 cuenta los bloques de hasta 16 bytes.
+ */
+#define POLICY_FREE_MIN_SHIFT 4
+
+/**
+ * @brief Tramos del histograma de bloques libres: el tramo i cuenta los
+ * bloques de más de 2^(i + 3) y hasta 2^(i + 4) bytes, hasta 16 MiB, y el
+ * último los mayores.
+ */
+#define POLICY_FREE_BUCKETS 22
+
+/**
+ * @brief Bloques libres de una política.
+ */
+typedef struct
+{
+    size_t free_bytes;           ///< Bytes de carga útil en bloques libres
+    size_t largest_free_block;   ///< Carga útil del mayor bloque libre; indexed_fit la redondea al límite de su clase
+    size_t largest_allocatable;  ///< Mayor pedido que se sirve sin crecer
+    size_t free_blocks;          ///< Bloques libres
+    size_t histogram[POLICY_FREE_BUCKETS]; ///< Bloques libres por tramo
+} PolicyFreeStats;
+
+/**
+ * @brief Devuelve el tramo del histograma de bloques libres de un tamaño.
+ *
+ * @param size Carga útil del bloque.
+ * @return Tramo, menor que POLICY_FREE_BUCKETS.
+ */
+size_t policy_free_bucket(size_t size);
+
+/**
+ * @brief Devuelve los totales de bloques libres de una política propia.
+ *
+ * @param policy SEGREGATED_FIT o INDEXED_BEST_FIT.
+ * @param stats Recibe los totales.
+ * @return 0 si la política los lleva, -1 para las de memory.h.
+ */
+int policy_free_stats(int policy, PolicyFreeStats* stats);
+
+/**
+ * @brief Activa o desactiva el modo de verificación de policy_walk_heap.
+ *
+ * Se activa con la variable de entorno MONITOR_ALLOC_CHECK.
+ *
+ * @param enabled Distinto de cero para activarlo.
+ */
+void policy_set_check(int enabled);
+
+#endif // ALLOC_POLICY_H
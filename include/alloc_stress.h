@@ -0,0 +1,117 @@
+/**
+ * @file alloc_stress.h
+ * @brief Modo de estrés del asignador con varios hilos.
+ *
+ * Cada hilo trabajador mantiene su propio conjunto de bloques y en cada
+ * operación elige uno al azar: si está vacío lo reserva con my_malloc y si
+ * está ocupado lo libera con my_free, así que el tráfico es mitad reservas y
+ * mitad liberaciones con la mitad del conjunto viva en régimen estacionario.
+ * El ritmo de cada hilo se limita a la tasa configurada.
+ *
+ * El asignador elige la política con un estado global (malloc_control) y
+ * las políticas de alloc_policy.h tampoco son seguras entre hilos, así que
+ * cada operación toma un mutex que cubre la elección de la política y la
+ * llamada. El tiempo de espera de ese mutex es la contención que se exporta
+ * por hilo; cualquier otro código que use el asignador mientras corre el modo
+ * de estrés debe tomarlo con alloc_stress_lock.
+ */
+
+#ifndef ALLOC_STRESS_H
+#define ALLOC_STRESS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Bloques por hilo si no se indica otra cantidad.
+ */
+#define ALLOC_STRESS_DEFAULT_WORKING_SET 256
+
+/**
+ * @brief Operaciones por segundo de cada hilo si no se indica otra tasa.
+ */
+#define ALLOC_STRESS_DEFAULT_RATE 10000
+
+/**
+ * @brief Mayor tamaño pedido si no se indica otro; los tamaños son uniformes
+ * desde 16 bytes.
+ */
+#define ALLOC_STRESS_DEFAULT_MAX_SIZE 1024
+
+/**
+ * @brief Configuración del modo de estrés.
+ */
+typedef struct
+{
+    size_t threads;     ///< Hilos trabajadores; 0 desactiva el modo
+    size_t working_set; ///< Bloques de cada hilo
+    unsigned int rate;  ///< Operaciones por segundo de cada hilo; 0 sin límite
+    size_t max_size;    ///< Mayor tamaño pedido
+    int policy;         ///< Política de todos los hilos, o -1 para alternarlas
+} AllocStressConfig;
+
+/**
+ * @brief Estadísticas de un hilo trabajador.
+ */
+typedef struct
+{
+    const char* thread;          ///< Número del hilo, como texto
+    const char* strategy;        ///< Política que usa el hilo
+    unsigned long long ops;      ///< Operaciones desde el inicio
+    double lock_wait_seconds;    ///< Espera acumulada del mutex del asignador
+    unsigned long long failed;   ///< my_malloc que devolvieron NULL
+} AllocStressStats;
+
+/**
+ * @brief Lee la configuración de las variables de entorno.
+ *
+ * MONITOR_ALLOC_STRESS_THREADS activa el modo con esa cantidad de hilos;
+ * MONITOR_ALLOC_STRESS_WORKING_SET, MONITOR_ALLOC_STRESS_RATE y
+ * MONITOR_ALLOC_STRESS_MAX_SIZE fijan el resto. MONITOR_ALLOC_STRESS_POLICY
+ * (first_fit, best_fit, worst_fit, segregated_fit o indexed_best_fit) usa una
+ * sola política en todos los hilos; si no se indica, el hilo i usa la
+ * política i módulo ALLOC_POLICY_COUNT.
+ *
+ * @param config Configuración a completar.
+ */
+void alloc_stress_config_from_env(AllocStressConfig* config);
+
+/**
+ * @brief Inicia los hilos trabajadores.
+ *
+ * @param config Configuración.
+ * @return 0 si se iniciaron, -1 en caso de error.
+ */
+int alloc_stress_start(const AllocStressConfig* config);
+
+/**
+ * @brief Detiene los hilos trabajadores y libera sus bloques.
+ */
+void alloc_stress_stop();
+
+/**
+ * @brief Toma el mutex del asignador.
+ *
+ * @return Nanosegundos de espera.
+ */
+uint64_t alloc_stress_lock();
+
+/**
+ * @brief Suelta el mutex del asignador.
+ */
+void alloc_stress_unlock();
+
+/**
+ * @brief Devuelve la cantidad de hilos trabajadores en ejecución.
+ */
+size_t alloc_stress_thread_count();
+
+/**
+ * @brief Devuelve las estadísticas de un hilo trabajador.
+ *
+ * @param index Índice del hilo, menor que alloc_stress_thread_count().
+ * @param stats Recibe las estadísticas.
+ */
+void alloc_stress_get_stats(size_t index, AllocStressStats* stats);
+
+#endif // ALLOC_STRESS_H
@@ -0,0 +1,126 @@
+/**
+ * @file alloc_trace.h
+ * @brief Captura de las operaciones del asignador en una traza binaria.
+ *
+ * Con la captura abierta, cada my_malloc y my_free registrado se agrega a un
+ * archivo como un AllocTraceEvent de 16 bytes: operación, política, tamaño
+ * pedido, identificador del bloque y nanosegundos desde el evento anterior.
+ * Los bloques se identifican por un número y no por su dirección, para que la
+ * traza pueda reproducirse contra cualquier política (bench/bench_replay.c).
+ * Los identificadores de los bloques liberados se reutilizan, así que el mayor
+ * identificador de la traza es el mayor número de bloques vivos a la vez.
+ *
+ * El archivo empieza con un AllocTraceHeader. Todos los campos son
+ * little-endian; los lectores deben avanzar de a event_size bytes para poder
+ * leer versiones que agreguen campos al final de cada evento.
+ */
+
+#ifndef ALLOC_TRACE_H
+#define ALLOC_TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Identificador del archivo ("ALTR").
+ */
+#define ALLOC_TRACE_MAGIC "ALTR"
+
+/**
+ * @brief Versión del formato.
+ */
+#define ALLOC_TRACE_VERSION 1
+
+/**
+ * @brief Marca de orden de bytes; se lee como 0x01020304 en un host
+ * little-endian.
+ */
+#define ALLOC_TRACE_BYTE_ORDER_MARK 0x01020304u
+
+/**
+ * @brief Operación registrada.
+ */
+typedef enum
+{
+    ALLOC_TRACE_MALLOC, ///< my_malloc que devolvió un bloque
+    ALLOC_TRACE_FREE    ///< my_free de un bloque registrado
+} AllocTraceOp;
+
+/**
+ * @brief Encabezado del archivo.
+ */
+typedef struct
+{
+    char magic[4];        ///< ALLOC_TRACE_MAGIC, sin '\0'
+    uint32_t byte_order;  ///< ALLOC_TRACE_BYTE_ORDER_MARK
+    uint16_t version;     ///< ALLOC_TRACE_VERSION
+    uint16_t header_size; ///< sizeof(AllocTraceHeader); los eventos empiezan aquí
+    uint16_t event_size;  ///< sizeof(AllocTraceEvent)
+    uint16_t reserved;    ///< 0
+    int64_t start_ns;     ///< CLOCK_REALTIME al abrir la captura
+} AllocTraceHeader;
+
+/**
+ * @brief Operación del asignador.
+ */
+typedef struct
+{
+    uint32_t delta_ns; ///< Nanosegundos desde el evento anterior, saturado en UINT32_MAX
+    uint32_t id;       ///< Identificador del bloque
+    uint32_t size;     ///< Bytes pedidos, saturado en UINT32_MAX; 0 en las liberaciones
+    uint8_t op;        ///< AllocTraceOp
+    uint8_t policy;    ///< FIRST_FIT, BEST_FIT o WORST_FIT
+    uint16_t reserved; ///< 0
+} AllocTraceEvent;
+
+_Static_assert(sizeof(AllocTraceHeader) == 24, "AllocTraceHeader");
+_Static_assert(sizeof(AllocTraceEvent) == 16, "AllocTraceEvent");
+
+/**
+ * @brief Abre la captura, reemplazando el archivo si existe.
+ *
+ * @param path Ruta del archivo de traza.
+ * @return 0 si se abrió, -1 en caso de error.
+ */
+int alloc_trace_open(const char* path);
+
+/**
+ * @brief Registra un my_malloc exitoso. No hace nada si la captura no está
+ * abierta.
+ *
+ * Debe llamarse después de my_malloc y antes de que el bloque se comparta con
+ * otro hilo.
+ *
+ * @param policy Política con la que se reservó el bloque.
+ * @param size Bytes pedidos.
+ * @param block Bloque devuelto por my_malloc.
+ */
+void alloc_trace_malloc(int policy, size_t size, const void* block);
+
+/**
+ * @brief Registra un my_free. No hace nada si la captura no está abierta o
+ * el bloque se reservó antes de abrirla.
+ *
+ * Debe llamarse antes de my_free, mientras la dirección todavía no puede
+ * volver a entregarse.
+ *
+ * @param policy Política activa al liberar.
+ * @param block Bloque que se va a liberar.
+ */
+void alloc_trace_free(int policy, const void* block);
+
+/**
+ * @brief Escribe en el archivo los eventos pendientes. No hace nada si la
+ * captura no está abierta.
+ *
+ * Sin esta llamada los eventos quedan en memoria hasta llenar el búfer, y una
+ * terminación sin alloc_trace_close los pierde.
+ */
+void alloc_trace_flush(void);
+
+/**
+ * @brief Vuelca los eventos pendientes y cierra la captura.
+ */
+void alloc_trace_close(void);
+
+#endif // ALLOC_TRACE_H
@@ -0,0 +1,38 @@
+/**
+ * @file binary_metrics.h
+ * @brief Salida de las métricas en el formato binario de monitor_record.h.
+ *
+ * Alternativa a send_metrics_as_json para consumidores que prefieren
+ * registros de disposición fija. Se elige con MONITOR_PIPE_FORMAT=binary.
+ */
+
+#ifndef BINARY_METRICS_H
+#define BINARY_METRICS_H
+
+#include <stddef.h>
+
+/**
+ * @brief Registra el encabezado de esquema como preámbulo del pipe.
+ *
+ * Debe llamarse antes de monitor_pipe_start; el publicador envía el preámbulo
+ * cada vez que abre el pipe.
+ */
+void init_binary_metrics();
+
+/**
+ * @brief Codifica las métricas del tick en un registro binario.
+ *
+ * Cada llamada es un tick nuevo y reutiliza el mismo búfer.
+ *
+ * @param length Recibe la longitud del registro.
+ * @return El registro, válido hasta la próxima llamada, o NULL si falló.
+ */
+const void* encode_metrics_as_binary(size_t* length);
+
+/**
+ * @brief Codifica las métricas del tick en un registro binario y lo encola en
+ * el pipe.
+ */
+void send_metrics_as_binary();
+
+#endif // BINARY_METRICS_H
@@ -12,7 +12,6 @@
 
 #include "metrics.h"
 #include <prom.h>
-#include <promhttp.h>
 #include <pthread.h>
 
 #define BUFFER_SIZE                                                            \
@@ -52,13 +51,41 @@ void update_context_switches_metric();
 void update_disk_metrics();
 
 /**
- * @brief Actualiza la métrica de uso de CPU.
+ * @brief Muestrea el uso de CPU.
  *
- * Calcula y actualiza el porcentaje de uso de CPU basado en los tiempos de
- * ejecución de la CPU.
+ * Calcula el porcentaje de uso de CPU basado en los tiempos de ejecución de la
+ * CPU y lo agrega a su historia; update_cpu_window_metrics lo exporta.
  */
 void update_cpu_gauge();
 
+/**
+ * @brief Muestrea el uso de CPU por núcleo.
+ *
+ * Agrega a la historia, para cada línea "cpuN" de /proc/stat, el porcentaje
+ * del último intervalo en los modos user, system, iowait, steal, irq y
+ * softirq; update_cpu_window_metrics lo exporta.
+ */
+void update_cpu_core_metrics();
+
+/**
+ * @brief Exporta el uso de CPU total y por núcleo con los agregados de su
+ * ventana de historia.
+ *
+ * Además del último valor exporta el mínimo, el máximo y el promedio de las
+ * muestras de la ventana, de modo que los picos más cortos que el intervalo de
+ * scrape no se pierdan.
+ */
+void update_cpu_window_metrics();
+
+/**
+ * @brief Inicializa la historia de CPU y sus métricas de mínimo, máximo y
+ * promedio.
+ *
+ * La capacidad y la ventana se leen de MONITOR_HISTORY_SAMPLES y
+ * MONITOR_HISTORY_WINDOW_MS.
+ */
+void init_history_metrics();
+
 /**
  * @brief Actualiza la métrica de uso de memoria.
  *
@@ -71,7 +98,8 @@ void update_memory_gauge();
  * @brief Función del hilo para exponer las métricas vía HTTP en el puerto 8000.
  *
  * Esta función crea un servidor HTTP en el puerto 8000, donde se exponen todas
- * las métricas registradas para que Prometheus las recoja.
+ * las métricas registradas para que Prometheus las recoja, y vuelca en el
+ * registro cada instantánea publicada por el recolector.
  *
  * @param arg Argumento no utilizado.
  * @return Siempre retorna `NULL`.
@@ -81,8 +109,8 @@ void *expose_metrics(void *arg);
 /**
  * @brief Inicializa las métricas del sistema.
  *
- * Inicializa las métricas relacionadas con CPU, memoria, disco y red, además de
- * configurar los mutex para la sincronización de acceso en los hilos.
+ * Inicializa las métricas relacionadas con CPU, memoria, disco y red, además del
+ * intercambio de instantáneas entre el hilo recolector y el exportador.
  */
 void init_metrics();
 
@@ -102,6 +130,54 @@ void init_disk_metrics();
  */
 void init_network_metrics();
 
+/**
+ * @brief Inicializa las métricas del publicador del pipe.
+ *
+ * Configura las métricas de profundidad de la cola, registros escritos y
+ * descartados y latencia de escritura hacia /tmp/monitor_pipe.
+ */
+void init_pipe_metrics();
+
+/**
+ * @brief Actualiza las métricas del publicador del pipe.
+ *
+ * Lee las estadísticas del publicador y exporta la profundidad de la cola, los
+ * registros escritos y descartados y la latencia de escritura.
+ */
+void update_pipe_metrics();
+
+/**
+ * @brief Inicializa las métricas del planificador.
+ *
+ * Configura, por recolector, las ejecuciones, los vencimientos perdidos, el
+ * retraso respecto del vencimiento y el intervalo configurado.
+ */
+void init_scheduler_metrics();
+
+/**
+ * @brief Actualiza las métricas del planificador.
+ *
+ * Lee las estadísticas de cada tarea del planificador; debe llamarse desde
+ * una tarea del propio planificador.
+ */
+void update_scheduler_metrics();
+
+/**
+ * @brief Inicializa las métricas del recolector por proceso.
+ *
+ * Configura los rankings por uso de CPU y por memoria residente, etiquetados
+ * por posición, y el costo del barrido: procesos encontrados, seguidos y
+ * descartados, tiempo de CPU, duración y memoria reservada.
+ */
+void init_proc_top_metrics();
+
+/**
+ * @brief Actualiza las métricas del recolector por proceso.
+ *
+ * No hace nada si el recolector no está iniciado.
+ */
+void update_proc_top_metrics();
+
 /**
  * @brief Inicializa las métricas de procesos en ejecución.
  *
@@ -119,12 +195,33 @@ void init_count_processes();
 void init_context_switches_metric();
 
 /**
- * @brief Destruye los mutex utilizados en la protección de las métricas.
+ * @brief Inicializa los histogramas de latencia de my_malloc y my_free.
+ *
+ * Prepara allocator_malloc_latency_seconds y allocator_free_latency_seconds,
+ * etiquetados por estrategia. No se registran en libprom: en cada tick se
+ * pliegan los tramos nuevos de alloc_latency en los buckets y las series se
+ * agregan al cuerpo de exposición. La disposición de buckets se lee de
+ * MONITOR_ALLOC_BUCKETS: "exponential:inicio,factor,cantidad",
+ * "linear:inicio,ancho,cantidad" o una lista creciente de límites en segundos.
+ */
+void init_alloc_latency_metrics();
+
+/**
+ * @brief Inicializa las métricas del modo de estrés del asignador.
+ *
+ * Configura, por hilo trabajador y estrategia, las operaciones, su tasa, la
+ * espera acumulada del mutex del asignador, la fracción del intervalo que se
+ * pasó esperando y las reservas fallidas.
+ */
+void init_alloc_stress_metrics();
+
+/**
+ * @brief Actualiza las métricas del modo de estrés del asignador.
  *
- * Libera los recursos asociados con los mutex utilizados para proteger el
- * acceso a las métricas en los hilos.
+ * No hace nada si el modo no está activo. Las tasas se calculan respecto de
+ * la llamada anterior.
  */
-void destroy_mutex();
+void update_alloc_stress_metrics();
 
 void update_memory_fragmentation_metric();
 void update_allocation_policy_metrics();
@@ -0,0 +1,60 @@
+/**
+ * @file exposition.h
+ * @brief Servidor HTTP que entrega la exposición de métricas ya formateada.
+ *
+ * El texto en formato Prometheus se genera una sola vez por tick y todas las
+ * peticiones a /metrics hasta el siguiente tick reciben la misma respuesta, sin
+ * volver a recorrer el registro ni copiar el cuerpo.
+ *
+ * El servidor usa varios workers, cada uno con su propio socket de escucha
+ * (SO_REUSEPORT) y un hilo de epoll que mantiene las conexiones keep-alive.
+ *
+ * El cuerpo se comprime con gzip (y con zstd si se compila con HAVE_ZSTD) una
+ * vez por tick, y cada scrape recibe la codificación que negocia su
+ * Accept-Encoding.
+ */
+
+#ifndef EXPOSITION_H
+#define EXPOSITION_H
+
+#include <microhttpd.h>
+#include <stddef.h>
+
+/**
+ * @brief Cantidad de workers HTTP si no se indica otra.
+ */
+#define EXPOSITION_DEFAULT_THREADS 4
+
+/**
+ * @brief Segundos que una conexión keep-alive puede quedar inactiva.
+ */
+#define EXPOSITION_KEEPALIVE_TIMEOUT 60
+
+/**
+ * @brief Inicia los workers del servidor HTTP de exposición.
+ *
+ * @param port Puerto en el que escuchan todos los workers.
+ * @param threads Cantidad de workers (0 se trata como 1).
+ * @return 0 si se iniciaron todos los workers, -1 en caso de error.
+ */
+int exposition_start(unsigned short port, size_t threads);
+
+/**
+ * @brief Detiene los workers y libera sus respuestas.
+ */
+void exposition_stop();
+
+/**
+ * @brief Publica el cuerpo de exposición de un nuevo tick.
+ *
+ * La función toma posesión de data, que debe haberse reservado con malloc, y
+ * genera en ese momento las versiones comprimidas. El cuerpo anterior se
+ * libera cuando termina la última petición que lo usa. Solo debe llamarse
+ * desde un único hilo.
+ *
+ * @param data Texto en formato de exposición de Prometheus.
+ * @param length Longitud de data en bytes.
+ */
+void exposition_publish(char* data, size_t length);
+
+#endif // EXPOSITION_H
@@ -0,0 +1,130 @@
+/**
+ * @file history.h
+ * @brief Historia de alta resolución de una serie con ventana deslizante.
+ *
+ * Cada serie guarda sus últimas muestras en un anillo de capacidad fija y
+ * mantiene de forma incremental el mínimo, el máximo y el promedio de las
+ * muestras dentro de la ventana: la suma se actualiza al entrar y salir cada
+ * muestra, y el mínimo y el máximo salen de dos colas monótonas. Agregar una
+ * muestra cuesta O(1) amortizado y consultar la ventana cuesta O(1).
+ *
+ * Así un pico más corto que el intervalo de scrape sigue visible en el máximo
+ * de la ventana aunque el último valor ya haya bajado.
+ */
+
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Muestras por serie si no se indica otra cantidad.
+ */
+#define HISTORY_DEFAULT_SAMPLES 64
+
+/**
+ * @brief Ventana por defecto, igual al scrape_interval de prometheus.yml.
+ */
+#define HISTORY_DEFAULT_WINDOW_MS 5000
+
+/**
+ * @brief Configuración de la historia.
+ */
+typedef struct
+{
+    size_t samples;         ///< Capacidad del anillo de cada serie
+    unsigned int window_ms; ///< Duración de la ventana
+} HistoryConfig;
+
+/**
+ * @brief Muestra de una serie.
+ */
+typedef struct
+{
+    long long time_ns; ///< CLOCK_MONOTONIC de la muestra
+    double value;      ///< Valor
+} HistorySample;
+
+/**
+ * @brief Anillo de muestras de una serie con sus agregados.
+ *
+ * Las muestras y las colas se identifican por su número de secuencia; la
+ * posición en el anillo es el número módulo la capacidad.
+ */
+typedef struct
+{
+    HistorySample* samples; ///< Anillo de muestras
+    uint64_t* min_queue;    ///< Secuencias con valores crecientes
+    uint64_t* max_queue;    ///< Secuencias con valores decrecientes
+    size_t capacity;        ///< Muestras que caben en el anillo
+    long long window_ns;    ///< Duración de la ventana
+    uint64_t head;          ///< Secuencia de la muestra más antigua
+    uint64_t tail;          ///< Secuencia de la próxima muestra
+    uint64_t min_head;      ///< Frente de min_queue
+    uint64_t min_tail;      ///< Fin de min_queue
+    uint64_t max_head;      ///< Frente de max_queue
+    uint64_t max_tail;      ///< Fin de max_queue
+    double sum;             ///< Suma de las muestras de la ventana
+} HistoryRing;
+
+/**
+ * @brief Agregados de la ventana.
+ */
+typedef struct
+{
+    double last;  ///< Última muestra
+    double min;   ///< Mínimo de la ventana
+    double max;   ///< Máximo de la ventana
+    double avg;   ///< Promedio de la ventana
+    size_t count; ///< Muestras en la ventana
+} HistoryWindow;
+
+/**
+ * @brief Lee la configuración de las variables de entorno.
+ *
+ * MONITOR_HISTORY_SAMPLES fija la capacidad de cada serie y con ella la
+ * memoria usada; MONITOR_HISTORY_WINDOW_MS la duración de la ventana.
+ *
+ * @param config Configuración a completar.
+ */
+void history_config_from_env(HistoryConfig* config);
+
+/**
+ * @brief Reserva el anillo de una serie.
+ *
+ * @param ring Anillo a inicializar.
+ * @param config Capacidad y ventana.
+ * @return 0 si se reservó, -1 en caso de error.
+ */
+int history_ring_init(HistoryRing* ring, const HistoryConfig* config);
+
+/**
+ * @brief Agrega una muestra y descarta las que salieron de la ventana.
+ *
+ * Si el anillo está lleno se descarta la más antigua, así que la ventana
+ * efectiva nunca supera capacity muestras.
+ *
+ * @param ring Anillo.
+ * @param time_ns CLOCK_MONOTONIC de la muestra, no decreciente.
+ * @param value Valor.
+ */
+void history_ring_push(HistoryRing* ring, long long time_ns, double value);
+
+/**
+ * @brief Devuelve los agregados de la ventana.
+ *
+ * @param ring Anillo.
+ * @param window Recibe los agregados.
+ * @return 0 si hay muestras, -1 si el anillo está vacío.
+ */
+int history_ring_window(const HistoryRing* ring, HistoryWindow* window);
+
+/**
+ * @brief Libera el anillo.
+ *
+ * @param ring Anillo.
+ */
+void history_ring_free(HistoryRing* ring);
+
+#endif // HISTORY_H
@@ -0,0 +1,102 @@
+/**
+ * @file indexed_fit.h
+ * @brief Buen ajuste en tiempo constante con un índice de dos niveles.
+ *
+ * Los bloques libres se guardan en listas por clase de tamaño: el primer
+ * nivel es la potencia de dos del tamaño y el segundo la divide en
+ * INDEXED_SL_COUNT tramos iguales (como TLSF). Un mapa de bits por nivel
+ * indica qué listas tienen bloques, así que encontrar la lista no vacía más
+ * chica que alcanza para un pedido cuesta dos find-first-set, sin recorrer
+ * bloques. Al liberar, el bloque se une con sus vecinos físicos libres.
+ *
+ * Es un buen ajuste, no el mejor ajuste exacto: el pedido se redondea al
+ * límite superior de su tramo para que cualquier bloque de la lista
+ * encontrada alcance, y se toma el primero de esa lista. Todos los bloques de
+ * una lista están en el mismo tramo, así que el elegido excede al menor de
+ * esa lista en menos de 1 / INDEXED_SL_COUNT (6,25%) del tamaño de la clase.
+ * Los bloques de la propia clase del pedido no se consideran (salvo que el
+ * pedido caiga justo en su límite inferior), así que si la siguiente lista no
+ * vacía está varias clases más arriba se parte un bloque mucho mayor que el
+ * mejor ajuste. El sobrante del bloque elegido vuelve al índice.
+ *
+ * La memoria sale de arenas de INDEXED_ARENA_SIZE bytes proyectadas con
+ * policy_reserve, fuera de las políticas de memory.h, que no se devuelven. Se
+ * elige con INDEXED_BEST_FIT en alloc_policy.h. No es seguro entre hilos.
+ */
+
+#ifndef INDEXED_FIT_H
+#define INDEXED_FIT_H
+
+#include "alloc_policy.h"
+#include <stddef.h>
+
+/**
+ * @brief Bits del segundo nivel: 16 tramos por potencia de dos.
+ */
+#define INDEXED_SL_BITS 4
+#define INDEXED_SL_COUNT (1 << INDEXED_SL_BITS)
+
+/**
+ * @brief Alineación de los bloques y granularidad de los tamaños.
+ */
+#define INDEXED_ALIGN 16
+
+/**
+ * @brief Bytes de cada arena; los pedidos que no caben
+ * reciben una arena a su medida.
+ */
+#define INDEXED_ARENA_SIZE (256 * 1024)
+
+/**
+ * @brief Estadísticas de la política, equivalentes a las de stats_memory.h.
+ */
+typedef struct
+{
+    unsigned long long allocations; ///< Reservas exitosas desde el inicio
+    double allocation_time;         ///< Tiempo total de las reservas (segundos)
+    size_t reserved_bytes;          ///< Bytes de las arenas
+    size_t allocated_bytes;         ///< Bytes de los bloques entregados vivos
+    size_t free_blocks;             ///< Bloques en el índice
+    size_t free_bytes;              ///< Carga útil de esos bloques
+    size_t largest_free_block;      ///< Límite inferior de la clase del mayor de ellos
+    size_t largest_allocatable;     ///< Mayor pedido que se sirve sin otra arena
+    size_t free_histogram[POLICY_FREE_BUCKETS]; ///< Bloques libres por tramo
+} IndexedStats;
+
+/**
+ * @brief Reserva el primer bloque de la menor clase que alcanza.
+ *
+ * @param size Bytes pedidos.
+ * @return El bloque, alineado a INDEXED_ALIGN, o NULL si no hay memoria.
+ */
+void* indexed_malloc(size_t size);
+
+/**
+ * @brief Libera un bloque devuelto por indexed_malloc.
+ *
+ * @param block Bloque, o NULL.
+ */
+void indexed_free(void* block);
+
+/**
+ * @brief Devuelve las estadísticas de la política.
+ *
+ * Los totales se llevan al día en cada operación y la lista no vacía más
+ * alta sale de los mapas de bits, así que la lectura no recorre bloques. El
+ * mayor bloque libre se informa con la precisión del índice: el límite
+ * inferior de su clase, que lo subestima en menos de 1 / INDEXED_SL_COUNT y
+ * es justamente el mayor pedido que se sirve sin otra arena.
+ *
+ * @param stats Recibe las estadísticas.
+ */
+void indexed_get_stats(IndexedStats* stats);
+
+/**
+ * @brief Recorre todas las arenas y las compara con el índice y las
+ * estadísticas.
+ *
+ * @return 0 si coinciden, -1 si no (el detalle va a stderr).
+ */
+int indexed_check();
+
+#endif // INDEXED_FIT_H
@@ -0,0 +1,115 @@
+/**
+ * @file json_writer.h
+ * @brief Emisor de JSON compacto sobre un búfer reutilizable.
+ *
+ * Escribe el documento directamente como texto, sin construir un árbol. El
+ * búfer se conserva entre documentos y solo crece cuando un documento no
+ * entra, por lo que en régimen estable emitir un registro no reserva memoria.
+ */
+
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <stddef.h>
+
+/**
+ * @brief Profundidad máxima de anidamiento de objetos y arreglos.
+ */
+#define JSON_WRITER_MAX_DEPTH 64
+
+/**
+ * @brief Estado del emisor.
+ */
+typedef struct
+{
+    char* data;                 ///< Documento emitido hasta ahora
+    size_t length;              ///< Bytes válidos en data
+    size_t capacity;            ///< Capacidad reservada en data
+    unsigned int depth;         ///< Nivel de anidamiento actual
+    unsigned long long started; ///< Bit por nivel: 1 si ya tiene algún elemento
+    int failed;                 ///< 1 si falló una reserva; el documento se descarta
+} JsonWriter;
+
+/**
+ * @brief Empieza un documento nuevo, conservando el búfer.
+ *
+ * @param writer Emisor a reiniciar.
+ */
+void json_writer_reset(JsonWriter* writer);
+
+/**
+ * @brief Libera el búfer del emisor.
+ *
+ * @param writer Emisor a liberar.
+ */
+void json_writer_free(JsonWriter* writer);
+
+/**
+ * @brief Abre un objeto.
+ *
+ * @param writer Emisor.
+ * @param key Clave dentro del objeto contenedor, o NULL en la raíz o en un
+ * arreglo.
+ */
+void json_object_begin(JsonWriter* writer, const char* key);
+
+/**
+ * @brief Cierra el objeto abierto más recientemente.
+ *
+ * @param writer Emisor.
+ */
+void json_object_end(JsonWriter* writer);
+
+/**
+ * @brief Abre un arreglo.
+ *
+ * @param writer Emisor.
+ * @param key Clave dentro del objeto contenedor, o NULL en la raíz o en un
+ * arreglo.
+ */
+void json_array_begin(JsonWriter* writer, const char* key);
+
+/**
+ * @brief Cierra el arreglo abierto más recientemente.
+ *
+ * @param writer Emisor.
+ */
+void json_array_end(JsonWriter* writer);
+
+/**
+ * @brief Escribe un número. NaN e infinito se escriben como null.
+ *
+ * @param writer Emisor.
+ * @param key Clave, o NULL dentro de un arreglo.
+ * @param value Valor a escribir.
+ */
+void json_write_number(JsonWriter* writer, const char* key, double value);
+
+/**
+ * @brief Escribe un entero sin signo sin pasar por double.
+ *
+ * @param writer Emisor.
+ * @param key Clave, o NULL dentro de un arreglo.
+ * @param value Valor a escribir.
+ */
+void json_write_uint(JsonWriter* writer, const char* key, unsigned long long value);
+
+/**
+ * @brief Escribe una cadena, escapando los caracteres que lo requieren.
+ *
+ * @param writer Emisor.
+ * @param key Clave, o NULL dentro de un arreglo.
+ * @param value Cadena terminada en '\0'.
+ */
+void json_write_string(JsonWriter* writer, const char* key, const char* value);
+
+/**
+ * @brief Termina el documento con un salto de línea.
+ *
+ * @param writer Emisor.
+ * @param length Recibe la longitud del documento, incluido el '\n'.
+ * @return El documento, o NULL si falló alguna reserva o quedó mal anidado.
+ */
+const char* json_writer_finish(JsonWriter* writer, size_t* length);
+
+#endif // JSON_WRITER_H
@@ -17,65 +17,299 @@
  */
 #define BUFFER_SIZE 256
 
+/**
+ * @brief Tamaño máximo del nombre de un dispositivo de bloques.
+ */
+#define DISK_NAME_SIZE 32
+
+/**
+ * @brief Cantidad de campos numéricos de una línea de /proc/diskstats.
+ */
+#define DISK_STATS_FIELD_COUNT 17
+
 /**
  * @brief Estructura para almacenar estadísticas de disco.
+ *
+ * Los campos siguen el orden de /proc/diskstats (ver
+ * Documentation/admin-guide/iostats.rst); los tiempos están en milisegundos.
+ * Los kernels anteriores a 4.18 y 5.5 no reportan los campos de descarte y de
+ * flush, que quedan en 0.
  */
 typedef struct
 {
-    unsigned long long reads;      ///< Número de lecturas realizadas en el disco
-    unsigned long long writes;     ///< Número de escrituras realizadas en el disco
-    unsigned long long read_time;  ///< Tiempo dedicado a operaciones de lectura
-    unsigned long long write_time; ///< Tiempo dedicado a operaciones de escritura
+    unsigned long long reads;             ///< Número de lecturas realizadas en el disco
+    unsigned long long reads_merged;      ///< Lecturas fusionadas con otras adyacentes
+    unsigned long long sectors_read;      ///< Sectores (512 bytes) leídos
+    unsigned long long read_time;         ///< Tiempo dedicado a operaciones de lectura
+    unsigned long long writes;            ///< Número de escrituras realizadas en el disco
+    unsigned long long writes_merged;     ///< Escrituras fusionadas con otras adyacentes
+    unsigned long long sectors_written;   ///< Sectores (512 bytes) escritos
+    unsigned long long write_time;        ///< Tiempo dedicado a operaciones de escritura
+    unsigned long long ios_in_progress;   ///< Operaciones en curso en este momento
+    unsigned long long io_ticks;          ///< Tiempo con al menos una operación en curso
+    unsigned long long weighted_io_time;  ///< Tiempo ponderado por operaciones en curso
+    unsigned long long discards;          ///< Descartes completados
+    unsigned long long discards_merged;   ///< Descartes fusionados
+    unsigned long long sectors_discarded; ///< Sectores descartados
+    unsigned long long discard_time;      ///< Tiempo dedicado a descartes
+    unsigned long long flushes;           ///< Flushes completados
+    unsigned long long flush_time;        ///< Tiempo dedicado a flushes
 } DiskStats;
 
+/**
+ * @brief Estado de un dispositivo de bloques en la tabla de discos.
+ */
+typedef struct
+{
+    unsigned int major;           ///< Número mayor del dispositivo
+    unsigned int minor;           ///< Número menor del dispositivo
+    int in_use;                   ///< 1 si la entrada de la tabla está ocupada
+    char name[DISK_NAME_SIZE];    ///< Nombre del dispositivo (e.g., "nvme0n1")
+    DiskStats stats;              ///< Valores del último refresco
+    DiskStats prev;               ///< Valores del refresco anterior
+    unsigned long long last_seen; ///< Generación del último refresco que lo incluyó
+    double utilization;           ///< Porcentaje del intervalo con E/S en curso
+    double read_await;            ///< Tiempo medio por lectura en el intervalo (ms)
+    double write_await;           ///< Tiempo medio por escritura en el intervalo (ms)
+    double await;                 ///< Tiempo medio por operación en el intervalo (ms)
+} DiskDevice;
+
+/**
+ * @brief Tabla hash de dispositivos de bloques indexada por major:minor.
+ *
+ * Usa direccionamiento abierto con sondeo lineal, por lo que releer miles de
+ * dispositivos no compara cadenas ni reserva memoria salvo al crecer.
+ */
+typedef struct
+{
+    DiskDevice* slots;             ///< Entradas de la tabla (capacidad potencia de 2)
+    size_t capacity;               ///< Cantidad de entradas
+    size_t count;                  ///< Entradas ocupadas
+    unsigned long long generation; ///< Número de refresco actual
+    double interval_ms;            ///< Milisegundos entre los dos últimos refrescos
+} DiskTable;
+
+/**
+ * @brief Tamaño máximo del nombre de una interfaz de red.
+ */
+#define NET_INTERFACE_NAME_SIZE 32
+
+/**
+ * @brief Cantidad de campos numéricos de una línea de /proc/net/dev.
+ */
+#define NET_STATS_FIELD_COUNT 16
+
 /**
  * @brief Estructura para almacenar estadísticas de red.
+ *
+ * Los campos siguen el orden de /proc/net/dev: ocho de recepción seguidos de
+ * ocho de transmisión.
  */
 typedef struct
 {
     unsigned long long bytes_received;      ///< Bytes recibidos a través de la interfaz de red
-    unsigned long long bytes_transmitted;   ///< Bytes transmitidos a través de la interfaz de red
     unsigned long long packets_received;    ///< Paquetes recibidos a través de la interfaz de red
+    unsigned long long rx_errors;           ///< Errores de recepción
+    unsigned long long rx_dropped;          ///< Paquetes recibidos descartados
+    unsigned long long rx_fifo;             ///< Errores de FIFO en recepción
+    unsigned long long rx_frame;            ///< Errores de trama en recepción
+    unsigned long long rx_compressed;       ///< Paquetes comprimidos recibidos
+    unsigned long long rx_multicast;        ///< Paquetes multicast recibidos
+    unsigned long long bytes_transmitted;   ///< Bytes transmitidos a través de la interfaz de red
     unsigned long long packets_transmitted; ///< Paquetes transmitidos a través de la interfaz de red
+    unsigned long long tx_errors;           ///< Errores de transmisión
+    unsigned long long tx_dropped;          ///< Paquetes a transmitir descartados
+    unsigned long long tx_fifo;             ///< Errores de FIFO en transmisión
+    unsigned long long tx_collisions;       ///< Colisiones detectadas
+    unsigned long long tx_carrier;          ///< Pérdidas de portadora
+    unsigned long long tx_compressed;       ///< Paquetes comprimidos transmitidos
 } NetStats;
 
 /**
- * @brief Obtiene estadísticas de red (bytes y paquetes transmitidos y recibidos).
+ * @brief Estado y tasas de una interfaz de red.
+ */
+typedef struct
+{
+    char name[NET_INTERFACE_NAME_SIZE]; ///< Nombre de la interfaz (e.g., "wlp2s0")
+    size_t name_length;                 ///< Longitud del nombre
+    unsigned int hash;                  ///< Hash del nombre, usado en la tabla
+    unsigned long long last_seen;       ///< Generación del último refresco que la incluyó
+    NetStats stats;                     ///< Valores del último refresco
+    NetStats prev;                      ///< Valores del refresco anterior
+    double rx_bytes_rate;               ///< Bytes por segundo recibidos en el intervalo
+    double tx_bytes_rate;               ///< Bytes por segundo transmitidos en el intervalo
+    double rx_packets_rate;             ///< Paquetes por segundo recibidos en el intervalo
+    double tx_packets_rate;             ///< Paquetes por segundo transmitidos en el intervalo
+} NetInterface;
+
+/**
+ * @brief Tabla de interfaces de red.
  *
- * Lee los valores de /proc/net/dev para una interfaz de red específica y devuelve las estadísticas de tráfico.
+ * Las interfaces se guardan de forma contigua en "interfaces" y se localizan a
+ * través de "index", un arreglo compacto de direccionamiento abierto con la
+ * posición de cada interfaz. Una sola pasada por /proc/net/dev actualiza todas.
+ */
+typedef struct
+{
+    NetInterface* interfaces;      ///< Interfaces presentes, sin huecos
+    size_t count;                  ///< Cantidad de interfaces
+    size_t allocated;              ///< Capacidad reservada en interfaces
+    int* index;                    ///< Posición en interfaces por entrada, o -1 si está libre
+    size_t index_capacity;         ///< Cantidad de entradas del índice (potencia de 2)
+    unsigned long long generation; ///< Número de refresco actual
+    double interval_seconds;       ///< Segundos entre los dos últimos refrescos
+} NetTable;
+
+/**
+ * @brief Tiempos acumulados de CPU (en jiffies) de una línea "cpu" de
+ * /proc/stat.
+ */
+typedef struct
+{
+    unsigned long long user;    ///< Tiempo en modo usuario
+    unsigned long long nice;    ///< Tiempo en modo usuario con prioridad modificada
+    unsigned long long system;  ///< Tiempo en modo kernel
+    unsigned long long idle;    ///< Tiempo inactivo
+    unsigned long long iowait;  ///< Tiempo inactivo esperando E/S
+    unsigned long long irq;     ///< Tiempo atendiendo interrupciones
+    unsigned long long softirq; ///< Tiempo atendiendo interrupciones diferidas
+    unsigned long long steal;   ///< Tiempo robado por el hipervisor
+} CpuTimes;
+
+/**
+ * @brief Modos de CPU de una línea "cpu", en el orden en que aparecen en
+ * /proc/stat.
+ */
+typedef enum
+{
+    CPU_MODE_USER,    ///< Modo usuario
+    CPU_MODE_NICE,    ///< Modo usuario con prioridad modificada
+    CPU_MODE_SYSTEM,  ///< Modo kernel
+    CPU_MODE_IDLE,    ///< Inactivo
+    CPU_MODE_IOWAIT,  ///< Inactivo esperando E/S
+    CPU_MODE_IRQ,     ///< Interrupciones
+    CPU_MODE_SOFTIRQ, ///< Interrupciones diferidas
+    CPU_MODE_STEAL,   ///< Tiempo robado por el hipervisor
+    CPU_MODE_COUNT    ///< Cantidad de modos
+} CpuMode;
+
+/**
+ * @brief Instantánea de /proc/stat leída en una sola pasada.
+ *
+ * Todos los consumidores de un mismo tick (Prometheus y JSON) leen de esta
+ * estructura, por lo que sus valores son consistentes entre sí.
+ */
+typedef struct
+{
+    CpuTimes total;                                ///< Línea agregada "cpu"
+    unsigned long long* cpu_times[CPU_MODE_COUNT]; ///< Líneas "cpuN" como columnas: cpu_times[modo][N]
+    unsigned long long* cpu_present;               ///< cpu_present[N]: 1 si la línea "cpuN" apareció en esta lectura
+    size_t cpu_count;                              ///< Mayor N leído más uno
+    size_t cpu_capacity;                           ///< Capacidad reservada en cada columna
+    unsigned long long ctxt;          ///< Cambios de contexto desde el arranque
+    unsigned long long intr;          ///< Interrupciones atendidas desde el arranque
+    unsigned long long softirq;       ///< Interrupciones diferidas desde el arranque
+    unsigned long long processes;     ///< Procesos creados desde el arranque
+    unsigned long long procs_running; ///< Procesos en estado ejecutable
+    unsigned long long procs_blocked; ///< Procesos bloqueados esperando E/S
+} ProcStatSnapshot;
+
+/**
+ * @brief Uso por núcleo calculado entre las dos últimas instantáneas.
+ *
+ * Los valores se guardan como columnas contiguas (una por modo) para que el
+ * cálculo de diferencias recorra arreglos planos que el compilador puede
+ * vectorizar.
+ */
+typedef struct
+{
+    double* percent[CPU_MODE_COUNT]; ///< percent[modo][N]: porcentaje del intervalo en ese modo
+    size_t core_count;               ///< Cantidad de núcleos; los ausentes en alguna lectura quedan en 0
+    size_t capacity;                 ///< Capacidad reservada en cada columna
+} CpuCoreUsage;
+
+/**
+ * @brief Lee /proc/stat una vez y actualiza la instantánea del tick actual.
+ *
+ * Debe llamarse una vez por tick, antes de los recolectores que dependen de
+ * /proc/stat. La instantánea anterior se conserva para calcular diferencias,
+ * y el uso por núcleo se recalcula en la misma llamada.
+ *
+ * @return 0 si la lectura fue correcta, -1 en caso de error.
+ */
+int refresh_proc_stat();
+
+/**
+ * @brief Devuelve la instantánea de /proc/stat del tick actual.
+ *
+ * @return Puntero a la instantánea, válido hasta el próximo refresh_proc_stat().
+ */
+const ProcStatSnapshot* get_proc_stat_snapshot();
+
+/**
+ * @brief Devuelve el uso por núcleo y modo del tick actual.
+ *
+ * @return Puntero al uso por núcleo, válido hasta el próximo refresh_proc_stat().
+ */
+const CpuCoreUsage* get_cpu_core_usage();
+
+/**
+ * @brief Lee /proc/net/dev y actualiza la tabla de interfaces.
  *
- * @param interface_name Nombre de la interfaz de red a monitorear (e.g., "wlp2s0").
- * @return Estructura NetStats con los valores recolectados de la interfaz especificada.
+ * Actualiza todas las interfaces presentes y calcula sus tasas por segundo con
+ * marcas de tiempo de CLOCK_MONOTONIC, de modo que no dependen de la duración
+ * de la iteración del bucle. Debe llamarse una vez por tick.
+ *
+ * @return 0 si la lectura fue correcta, -1 en caso de error.
+ */
+int refresh_network_stats();
+
+/**
+ * @brief Devuelve la tabla de interfaces del último refresco.
+ *
+ * @return Puntero a la tabla, válido hasta el próximo refresh_network_stats().
  */
-NetStats get_network_stats(const char* interface_name);
+const NetTable* get_network_table();
 
 /**
  * @brief Obtiene el número de procesos en ejecución.
  *
- * Lee el número de procesos en ejecución desde /proc/loadavg.
+ * Toma el valor procs_running de la instantánea de /proc/stat del tick actual.
  *
- * @return Número de procesos en ejecución, o -1 en caso de error.
+ * @return Número de procesos en ejecución, o -1 si falló la última lectura de
+ * /proc/stat.
  */
 int get_running_processes();
 
 /**
  * @brief Obtiene el número total de cambios de contexto del sistema.
  *
- * Lee el número de cambios de contexto desde /proc/stat.
+ * Toma el valor ctxt de la instantánea de /proc/stat del tick actual.
  *
- * @return Número total de cambios de contexto, o 0 en caso de error.
+ * @return Número total de cambios de contexto, o 0 si falló la última lectura
+ * de /proc/stat.
  */
 unsigned long long get_context_switches();
 
 /**
- * @brief Obtiene estadísticas de disco (lecturas, escrituras y tiempos).
+ * @brief Lee /proc/diskstats y actualiza la tabla de dispositivos.
+ *
+ * Actualiza todos los dispositivos de bloques presentes, calcula la utilización
+ * y la latencia media del intervalo transcurrido desde el refresco anterior y
+ * descarta los dispositivos que ya no existen. Debe llamarse una vez por tick.
+ *
+ * @return 0 si la lectura fue correcta, -1 en caso de error.
+ */
+int refresh_disk_stats();
+
+/**
+ * @brief Devuelve la tabla de dispositivos del último refresco.
  *
- * Lee los valores de /proc/diskstats para un disco específico y devuelve las
- * lecturas, escrituras y tiempos de operación.
+ * Solo las entradas con in_use distinto de 0 son válidas.
  *
- * @return Estructura DiskStats con los valores recolectados.
+ * @return Puntero a la tabla, válido hasta el próximo refresh_disk_stats().
  */
-DiskStats get_disk_stats();
+const DiskTable* get_disk_table();
 
 /**
  * @brief Obtiene el porcentaje de uso de memoria desde /proc/meminfo.
@@ -90,8 +324,8 @@ double get_memory_usage();
 /**
  * @brief Obtiene el porcentaje de uso de CPU desde /proc/stat.
  *
- * Lee los tiempos de CPU desde /proc/stat y calcula el porcentaje de uso de CPU
- * en un intervalo de tiempo.
+ * Calcula el porcentaje de uso de CPU entre las dos últimas instantáneas de
+ * /proc/stat. Varias llamadas dentro del mismo tick devuelven el mismo valor.
  *
  * @return Uso de CPU como porcentaje (0.0 a 100.0), o -1.0 en caso de error.
  */
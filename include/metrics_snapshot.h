@@ -0,0 +1,95 @@
+/**
+ * @file metrics_snapshot.h
+ * @brief Intercambio sin bloqueos de instantáneas de métricas entre el hilo
+ * recolector y el hilo exportador.
+ *
+ * El recolector escribe los valores de cada tick en una instantánea privada y
+ * la publica con un intercambio atómico de índices (triple búfer). El
+ * exportador siempre obtiene la última instantánea completa y nunca la comparte
+ * con el recolector mientras la lee, por lo que ninguno de los dos caminos
+ * necesita un mutex ni espera al otro.
+ */
+
+#ifndef METRICS_SNAPSHOT_H
+#define METRICS_SNAPSHOT_H
+
+#include <prom.h>
+#include <stddef.h>
+
+/**
+ * @brief Cantidad máxima de etiquetas por muestra.
+ */
+#define SNAPSHOT_MAX_LABELS 2
+
+/**
+ * @brief Tamaño máximo de cada valor de etiqueta, incluido el '\0'.
+ */
+#define SNAPSHOT_LABEL_SIZE 32
+
+/**
+ * @brief Valor de una métrica (con sus etiquetas) tomado en un tick.
+ */
+typedef struct
+{
+    prom_gauge_t* metric;                                    ///< Métrica destino
+    double value;                                            ///< Valor a exportar
+    size_t label_count;                                      ///< Cantidad de etiquetas
+    char labels[SNAPSHOT_MAX_LABELS][SNAPSHOT_LABEL_SIZE];   ///< Copia de los valores de las etiquetas
+} SnapshotSample;
+
+/**
+ * @brief Conjunto de muestras de un tick.
+ */
+typedef struct
+{
+    SnapshotSample* samples;       ///< Muestras del tick
+    size_t count;                  ///< Cantidad de muestras
+    size_t capacity;               ///< Capacidad reservada en samples
+    unsigned long long generation; ///< Número de tick en que se publicó
+} MetricsSnapshot;
+
+/**
+ * @brief Inicializa el intercambio de instantáneas.
+ *
+ * @return 0 si se inicializó correctamente, -1 en caso de error.
+ */
+int snapshot_init();
+
+/**
+ * @brief Registra el valor de un gauge en la instantánea en construcción.
+ *
+ * Solo debe llamarse desde el hilo recolector. Los valores de las etiquetas
+ * se copian, por lo que el llamador puede reutilizarlos.
+ *
+ * @param metric Gauge destino.
+ * @param value Valor a exportar.
+ * @param labels Valores de las etiquetas, o NULL si la métrica no tiene.
+ * @param label_count Cantidad de etiquetas (a lo sumo SNAPSHOT_MAX_LABELS).
+ */
+void snapshot_gauge_set(prom_gauge_t* metric, double value, const char** labels, size_t label_count);
+
+/**
+ * @brief Publica la instantánea en construcción y empieza una nueva.
+ *
+ * Solo debe llamarse desde el hilo recolector, una vez por tick. No bloquea.
+ */
+void snapshot_publish();
+
+/**
+ * @brief Espera hasta que haya una instantánea nueva publicada.
+ *
+ * Solo debe llamarse desde el hilo exportador.
+ */
+void snapshot_wait();
+
+/**
+ * @brief Obtiene la última instantánea publicada.
+ *
+ * Solo debe llamarse desde el hilo exportador. La instantánea devuelta le
+ * pertenece hasta la próxima llamada y el recolector no la modifica.
+ *
+ * @return La instantánea más reciente, o NULL si todavía no se publicó ninguna.
+ */
+const MetricsSnapshot* snapshot_acquire();
+
+#endif // METRICS_SNAPSHOT_H
@@ -0,0 +1,135 @@
+/**
+ * @file monitor_pipe.h
+ * @brief Publicador de registros del monitor hacia /tmp/monitor_pipe.
+ *
+ * Los registros se encolan en una cola acotada y un hilo dedicado los escribe
+ * en el pipe, de modo que un lector lento o ausente nunca detiene el bucle de
+ * recolección. Cuando la cola se llena se aplica la política de desborde
+ * configurada.
+ *
+ * El pipe se abre una sola vez en modo no bloqueante y se conserva entre
+ * registros. Si todavía no hay un lector o el lector se va, el hilo lo vuelve
+ * a abrir más tarde.
+ */
+
+#ifndef MONITOR_PIPE_H
+#define MONITOR_PIPE_H
+
+#include <stddef.h>
+
+/**
+ * @brief Ruta del pipe donde se publican los registros.
+ */
+#define MONITOR_PIPE_PATH "/tmp/monitor_pipe"
+
+/**
+ * @brief Profundidad de la cola si no se indica otra.
+ */
+#define MONITOR_PIPE_DEFAULT_DEPTH 16
+
+/**
+ * @brief Espera máxima de la política MONITOR_PIPE_BLOCK si no se indica otra.
+ */
+#define MONITOR_PIPE_DEFAULT_BLOCK_MS 100
+
+/**
+ * @brief Qué hacer con un registro nuevo cuando la cola está llena.
+ */
+typedef enum
+{
+    MONITOR_PIPE_DROP_OLDEST, ///< Descartar el registro más antiguo de la cola
+    MONITOR_PIPE_COALESCE,    ///< Descartar todos los pendientes y dejar solo el nuevo
+    MONITOR_PIPE_BLOCK        ///< Esperar lugar hasta un tiempo límite y luego descartar el nuevo
+} MonitorPipePolicy;
+
+/**
+ * @brief Formato de los registros que se publican.
+ */
+typedef enum
+{
+    MONITOR_PIPE_JSON,  ///< Una línea de JSON compacto por tick
+    MONITOR_PIPE_BINARY ///< Registros binarios de monitor_record.h
+} MonitorPipeFormat;
+
+/**
+ * @brief Configuración del publicador.
+ */
+typedef struct
+{
+    size_t depth;             ///< Registros que caben en la cola
+    MonitorPipePolicy policy; ///< Política de desborde
+    unsigned int block_ms;    ///< Espera máxima con MONITOR_PIPE_BLOCK
+    MonitorPipeFormat format; ///< Formato de los registros
+} MonitorPipeConfig;
+
+/**
+ * @brief Estadísticas del publicador.
+ */
+typedef struct
+{
+    size_t queue_depth;           ///< Registros encolados ahora
+    unsigned long long written;   ///< Registros escritos desde el inicio
+    unsigned long long dropped;   ///< Registros descartados desde el inicio
+    double last_write_seconds;    ///< Duración de la última escritura completa
+    double max_write_seconds;     ///< Mayor duración desde la consulta anterior
+} MonitorPipeStats;
+
+/**
+ * @brief Carga la configuración desde el entorno.
+ *
+ * Lee MONITOR_PIPE_DEPTH, MONITOR_PIPE_POLICY ("drop-oldest", "coalesce" o
+ * "block"), MONITOR_PIPE_BLOCK_MS y MONITOR_PIPE_FORMAT ("json" o "binary");
+ * los valores ausentes o inválidos toman el valor por defecto.
+ *
+ * @param config Configuración a completar.
+ */
+void monitor_pipe_config_from_env(MonitorPipeConfig* config);
+
+/**
+ * @brief Define los datos que se envían cada vez que se abre el pipe, antes
+ * de cualquier registro.
+ *
+ * Debe llamarse antes de monitor_pipe_start. Los datos se copian.
+ *
+ * @param data Contenido del preámbulo.
+ * @param length Longitud del preámbulo en bytes.
+ * @return 0 si se registró, -1 si no se pudo reservar memoria.
+ */
+int monitor_pipe_set_preamble(const void* data, size_t length);
+
+/**
+ * @brief Inicia el hilo publicador.
+ *
+ * @param config Configuración del publicador.
+ * @return 0 si se inició correctamente, -1 en caso de error.
+ */
+int monitor_pipe_start(const MonitorPipeConfig* config);
+
+/**
+ * @brief Encola una copia de un registro completo.
+ *
+ * Nunca bloquea salvo con MONITOR_PIPE_BLOCK, y en ese caso a lo sumo
+ * block_ms. Los búferes de la cola se reutilizan, así que en régimen estable
+ * no reserva memoria.
+ *
+ * @param data Contenido del registro.
+ * @param length Longitud del registro en bytes.
+ * @return 0 si el registro se encoló, -1 si se descartó.
+ */
+int monitor_pipe_submit(const char* data, size_t length);
+
+/**
+ * @brief Obtiene las estadísticas y reinicia el máximo de escritura.
+ *
+ * @param stats Estadísticas a completar.
+ */
+void monitor_pipe_get_stats(MonitorPipeStats* stats);
+
+/**
+ * @brief Detiene el hilo publicador y cierra el pipe.
+ *
+ * Los registros que queden en la cola se descartan.
+ */
+void monitor_pipe_stop(void);
+
+#endif // MONITOR_PIPE_H
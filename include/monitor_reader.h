@@ -0,0 +1,185 @@
+/**
+ * @file monitor_reader.h
+ * @brief Biblioteca de lectura del formato binario de /tmp/monitor_pipe.
+ *
+ * Decodifica el encabezado de esquema y los registros descritos en
+ * monitor_record.h sin copiarlos: cada registro se expone como una vista sobre
+ * el búfer de lectura. Solo depende de monitor_record.h, monitor_shm.h y
+ * monitor_reader.c, así que un consumidor puede compilarla sin el resto del
+ * monitor.
+ *
+ * También lee el anillo de memoria compartida de monitor_shm.h. Una lectura
+ * del anillo no hace llamadas al sistema ni copia el registro:
+ *
+ * @code
+ * uint64_t tick = monitor_shm_reader_head(&reader) - 1;
+ * if (monitor_shm_reader_begin(&reader, tick, &view) == 0) {
+ *     double cpu = view.header->cpu_usage_percentage;
+ *     if (monitor_shm_reader_validate(&reader, tick)) {
+ *         // cpu pertenece al tick completo
+ *     }
+ * }
+ * @endcode
+ */
+
+#ifndef MONITOR_READER_H
+#define MONITOR_READER_H
+
+#include "monitor_record.h"
+#include "monitor_shm.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Vista de un registro decodificado.
+ *
+ * Los punteros apuntan al búfer del que se decodificó el registro.
+ */
+typedef struct
+{
+    const MonitorRecordHeader* header; ///< Encabezado del registro
+    const char* disks;                 ///< Primera entrada de disco
+    size_t disk_stride;                ///< Distancia entre entradas de disco
+    const char* nets;                  ///< Primera entrada de red
+    size_t net_stride;                 ///< Distancia entre entradas de red
+} MonitorRecordView;
+
+/**
+ * @brief Lector de un flujo binario sobre un descriptor.
+ */
+typedef struct
+{
+    int fd;                     ///< Descriptor del que se lee
+    char* buffer;               ///< Datos leídos y todavía no consumidos
+    size_t capacity;            ///< Capacidad de buffer
+    size_t start;               ///< Primer byte sin consumir
+    size_t end;                 ///< Fin de los datos leídos
+    MonitorStreamHeader schema; ///< Último encabezado de esquema recibido
+    int has_schema;             ///< 1 si ya se recibió un encabezado
+} MonitorReader;
+
+/**
+ * @brief Decodifica un encabezado de esquema.
+ *
+ * @param data Datos que empiezan con el encabezado.
+ * @param length Bytes disponibles en data.
+ * @param schema Recibe el encabezado.
+ * @return 0 si es válido y compatible, -1 en caso contrario.
+ */
+int monitor_stream_header_decode(const void* data, size_t length, MonitorStreamHeader* schema);
+
+/**
+ * @brief Decodifica un registro completo.
+ *
+ * @param schema Encabezado de esquema del flujo.
+ * @param data Registro, alineado a 8 bytes.
+ * @param length Bytes disponibles en data.
+ * @param view Recibe la vista del registro.
+ * @return 0 si el registro es válido, -1 en caso contrario.
+ */
+int monitor_record_decode(const MonitorStreamHeader* schema, const void* data, size_t length,
+                          MonitorRecordView* view);
+
+/**
+ * @brief Devuelve la entrada de disco i de un registro.
+ */
+static inline const MonitorDiskEntry* monitor_record_disk(const MonitorRecordView* view, size_t i)
+{
+    return (const MonitorDiskEntry*)(view->disks + i * view->disk_stride);
+}
+
+/**
+ * @brief Devuelve la entrada de red i de un registro.
+ */
+static inline const MonitorNetEntry* monitor_record_net(const MonitorRecordView* view, size_t i)
+{
+    return (const MonitorNetEntry*)(view->nets + i * view->net_stride);
+}
+
+/**
+ * @brief Abre un pipe o archivo para leer el flujo.
+ *
+ * @param reader Lector a inicializar.
+ * @param path Ruta del pipe, normalmente MONITOR_PIPE_PATH.
+ * @return 0 si se abrió, -1 en caso de error.
+ */
+int monitor_reader_open(MonitorReader* reader, const char* path);
+
+/**
+ * @brief Lee el siguiente registro, bloqueando hasta que llegue completo.
+ *
+ * Los encabezados de esquema que aparezcan en el flujo (uno por cada vez que
+ * el monitor abre el pipe) se procesan de forma transparente.
+ *
+ * @param reader Lector.
+ * @param view Recibe el registro; es válido hasta la próxima llamada.
+ * @return 1 si se leyó un registro, 0 al final del flujo, -1 si el flujo es
+ * inválido o falló la lectura.
+ */
+int monitor_reader_next(MonitorReader* reader, MonitorRecordView* view);
+
+/**
+ * @brief Cierra el descriptor y libera el búfer del lector.
+ *
+ * @param reader Lector.
+ */
+void monitor_reader_close(MonitorReader* reader);
+
+/**
+ * @brief Lector del anillo de memoria compartida.
+ */
+typedef struct
+{
+    const MonitorShmHeader* header; ///< Objeto mapeado en solo lectura
+    size_t size;                    ///< Bytes mapeados
+} MonitorShmReader;
+
+/**
+ * @brief Mapea el anillo publicado por el monitor.
+ *
+ * @param reader Lector a inicializar.
+ * @param name Nombre del objeto, normalmente MONITOR_SHM_DEFAULT_NAME.
+ * @return 0 si se mapeó, -1 si no existe, todavía no está inicializado o su
+ * versión es incompatible.
+ */
+int monitor_shm_reader_open(MonitorShmReader* reader, const char* name);
+
+/**
+ * @brief Devuelve la cantidad de ticks publicados; el último es el valor
+ * devuelto menos uno.
+ */
+uint64_t monitor_shm_reader_head(const MonitorShmReader* reader);
+
+/**
+ * @brief Empieza a leer un tick directamente desde su ranura.
+ *
+ * La vista apunta a la memoria compartida y el escritor puede reutilizar la
+ * ranura en cualquier momento: los valores leídos solo son válidos si después
+ * monitor_shm_reader_validate devuelve 1.
+ *
+ * @param reader Lector.
+ * @param tick Tick a leer; solo están disponibles los últimos slot_count.
+ * @param view Recibe la vista del registro.
+ * @return 0 si la ranura tiene el tick, -1 si todavía no se publicó, ya se
+ * sobrescribió o no entró en la ranura.
+ */
+int monitor_shm_reader_begin(const MonitorShmReader* reader, uint64_t tick, MonitorRecordView* view);
+
+/**
+ * @brief Comprueba que la ranura de un tick no cambió desde
+ * monitor_shm_reader_begin.
+ *
+ * @param reader Lector.
+ * @param tick Tick pasado a monitor_shm_reader_begin.
+ * @return 1 si lo leído pertenece al tick completo, 0 si hay que descartarlo.
+ */
+int monitor_shm_reader_validate(const MonitorShmReader* reader, uint64_t tick);
+
+/**
+ * @brief Desmapea el anillo.
+ *
+ * @param reader Lector.
+ */
+void monitor_shm_reader_close(MonitorShmReader* reader);
+
+#endif // MONITOR_READER_H
@@ -0,0 +1,187 @@
+/**
+ * @file monitor_record.h
+ * @brief Formato binario de los registros que el monitor envía por el pipe.
+ *
+ * El flujo empieza con un encabezado de esquema (MonitorStreamHeader), que se
+ * envía cada vez que se abre el pipe, seguido de un registro por tick. Cada
+ * registro empieza con su longitud total y tiene una disposición fija: un
+ * MonitorRecordHeader, disk_count entradas MonitorDiskEntry y net_count
+ * entradas MonitorNetEntry. Todos los campos son little-endian y todas las
+ * estructuras miden un múltiplo de 8 bytes, así que un registro leído sobre un
+ * búfer alineado puede usarse sin copiarlo.
+ *
+ * Las versiones nuevas del formato solo agregan campos al final de cada
+ * estructura; el encabezado de esquema indica el tamaño de cada una para que un
+ * lector antiguo pueda saltearlos.
+ */
+
+#ifndef MONITOR_RECORD_H
+#define MONITOR_RECORD_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Identificador del flujo binario ("MONB").
+ */
+#define MONITOR_STREAM_MAGIC "MONB"
+
+/**
+ * @brief Versión del formato.
+ */
+#define MONITOR_RECORD_VERSION 1
+
+/**
+ * @brief Marca de orden de bytes; se lee como 0x01020304 en un host
+ * little-endian.
+ */
+#define MONITOR_BYTE_ORDER_MARK 0x01020304u
+
+/**
+ * @brief Tamaño de los nombres de dispositivo e interfaz, incluido el '\0'.
+ */
+#define MONITOR_RECORD_NAME_SIZE 32
+
+/**
+ * @brief Encabezado de esquema, enviado una vez por conexión.
+ */
+typedef struct
+{
+    char magic[4];                ///< MONITOR_STREAM_MAGIC, sin '\0'
+    uint32_t byte_order;          ///< MONITOR_BYTE_ORDER_MARK
+    uint16_t version;             ///< MONITOR_RECORD_VERSION
+    uint16_t header_size;         ///< sizeof(MonitorStreamHeader)
+    uint16_t record_header_size;  ///< sizeof(MonitorRecordHeader)
+    uint16_t disk_entry_size;     ///< sizeof(MonitorDiskEntry)
+    uint16_t net_entry_size;      ///< sizeof(MonitorNetEntry)
+    uint16_t name_size;           ///< MONITOR_RECORD_NAME_SIZE
+    uint32_t reserved;            ///< 0
+} MonitorStreamHeader;
+
+/**
+ * @brief Encabezado de cada registro.
+ */
+typedef struct
+{
+    uint32_t length;                  ///< Bytes del registro, incluido este campo
+    uint16_t version;                 ///< MONITOR_RECORD_VERSION
+    uint16_t flags;                   ///< Reservado, 0
+    uint64_t sequence;                ///< Número de tick
+    int64_t timestamp_ns;             ///< CLOCK_REALTIME del tick en nanosegundos
+    double cpu_usage_percentage;      ///< Uso total de CPU
+    double memory_usage_percentage;   ///< Uso de memoria
+    uint64_t context_switches_total;  ///< Cambios de contexto acumulados
+    int32_t running_processes_count;  ///< Procesos en ejecución
+    uint16_t disk_count;              ///< Entradas MonitorDiskEntry que siguen
+    uint16_t net_count;               ///< Entradas MonitorNetEntry que siguen
+} MonitorRecordHeader;
+
+/**
+ * @brief Estadísticas de un dispositivo de bloques.
+ */
+typedef struct
+{
+    char device[MONITOR_RECORD_NAME_SIZE]; ///< Nombre terminado en '\0'
+    uint64_t reads;                        ///< Lecturas completadas
+    uint64_t writes;                       ///< Escrituras completadas
+    double read_time_seconds;              ///< Tiempo de lectura acumulado
+    double write_time_seconds;             ///< Tiempo de escritura acumulado
+    double utilization_percentage;         ///< Utilización del último intervalo
+    double await_ms;                       ///< Espera media del último intervalo
+} MonitorDiskEntry;
+
+/**
+ * @brief Estadísticas de una interfaz de red.
+ */
+typedef struct
+{
+    char interface[MONITOR_RECORD_NAME_SIZE]; ///< Nombre terminado en '\0'
+    double bandwidth_rx;                      ///< Bytes recibidos por segundo
+    double bandwidth_tx;                      ///< Bytes transmitidos por segundo
+    double packet_ratio;                      ///< Paquetes transmitidos/recibidos
+} MonitorNetEntry;
+
+_Static_assert(sizeof(MonitorStreamHeader) == 24, "MonitorStreamHeader");
+_Static_assert(sizeof(MonitorRecordHeader) == 56, "MonitorRecordHeader");
+_Static_assert(sizeof(MonitorDiskEntry) == 80, "MonitorDiskEntry");
+_Static_assert(sizeof(MonitorNetEntry) == 56, "MonitorNetEntry");
+
+/**
+ * @brief Construye registros sobre un búfer reutilizable.
+ *
+ * Las entradas de disco deben agregarse antes que las de red.
+ */
+typedef struct
+{
+    char* data;      ///< Registro en construcción
+    size_t length;   ///< Bytes usados
+    size_t capacity; ///< Capacidad reservada
+    int failed;      ///< 1 si falló una reserva o se violó el orden
+} MonitorRecordBuilder;
+
+/**
+ * @brief Completa un encabezado de esquema para la versión actual.
+ *
+ * @param header Encabezado a completar.
+ */
+void monitor_stream_header_init(MonitorStreamHeader* header);
+
+/**
+ * @brief Empieza un registro nuevo, conservando el búfer.
+ *
+ * @param builder Constructor.
+ */
+void monitor_record_begin(MonitorRecordBuilder* builder);
+
+/**
+ * @brief Devuelve el encabezado del registro en construcción.
+ *
+ * El puntero es válido hasta la próxima llamada que agregue una entrada.
+ *
+ * @param builder Constructor.
+ * @return El encabezado, o NULL si el constructor falló.
+ */
+MonitorRecordHeader* monitor_record_header(MonitorRecordBuilder* builder);
+
+/**
+ * @brief Agrega una entrada de disco inicializada en cero.
+ *
+ * @param builder Constructor.
+ * @return La entrada, válida hasta la próxima llamada, o NULL si falló.
+ */
+MonitorDiskEntry* monitor_record_add_disk(MonitorRecordBuilder* builder);
+
+/**
+ * @brief Agrega una entrada de red inicializada en cero.
+ *
+ * @param builder Constructor.
+ * @return La entrada, válida hasta la próxima llamada, o NULL si falló.
+ */
+MonitorNetEntry* monitor_record_add_net(MonitorRecordBuilder* builder);
+
+/**
+ * @brief Termina el registro completando su longitud y versión.
+ *
+ * @param builder Constructor.
+ * @param length Recibe la longitud del registro.
+ * @return El registro, o NULL si falló alguna reserva.
+ */
+const void* monitor_record_finish(MonitorRecordBuilder* builder, size_t* length);
+
+/**
+ * @brief Libera el búfer del constructor.
+ *
+ * @param builder Constructor.
+ */
+void monitor_record_builder_free(MonitorRecordBuilder* builder);
+
+/**
+ * @brief Copia un nombre en un campo de tamaño fijo, truncándolo y
+ * completando con '\0'.
+ *
+ * @param field Campo destino de MONITOR_RECORD_NAME_SIZE bytes.
+ * @param name Nombre terminado en '\0'.
+ */
+void monitor_record_set_name(char* field, const char* name);
+
+#endif // MONITOR_RECORD_H
@@ -0,0 +1,127 @@
+/**
+ * @file monitor_shm.h
+ * @brief Anillo de snapshots en memoria compartida para consumidores locales.
+ *
+ * El recolector copia el registro binario de cada tick (monitor_record.h) en
+ * un anillo de ranuras de tamaño fijo dentro de un objeto de shm_open. Cada
+ * ranura está protegida por un seqlock: el escritor nunca espera a los
+ * lectores, y cualquier cantidad de lectores puede mapear el objeto en solo
+ * lectura y leer el último tick o los anteriores sin llamadas al sistema ni
+ * copias. La API de lectura está en monitor_reader.h.
+ *
+ * Protocolo de una ranura para el tick n: el escritor guarda 2n+1 en seq,
+ * copia el registro y guarda 2n+2. Un lector que ve 2n+2 antes y después de
+ * leer la ranura sabe que leyó el tick n completo.
+ */
+
+#ifndef MONITOR_SHM_H
+#define MONITOR_SHM_H
+
+#include "monitor_record.h"
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Nombre del objeto de memoria compartida si no se indica otro.
+ */
+#define MONITOR_SHM_DEFAULT_NAME "/monitor_snapshots"
+
+/**
+ * @brief Identificador del objeto ("MONSHM", completado con '\0').
+ */
+#define MONITOR_SHM_MAGIC "MONSHM"
+
+/**
+ * @brief Versión de la disposición del anillo.
+ */
+#define MONITOR_SHM_VERSION 1
+
+/**
+ * @brief Ranuras del anillo si no se indica otra cantidad.
+ */
+#define MONITOR_SHM_DEFAULT_SLOTS 64
+
+/**
+ * @brief Bytes por ranura si no se indica otro tamaño; alcanza para cientos de
+ * discos e interfaces.
+ */
+#define MONITOR_SHM_DEFAULT_SLOT_SIZE 65536
+
+/**
+ * @brief Encabezado del objeto compartido, seguido de slot_count ranuras.
+ */
+typedef struct
+{
+    char magic[8];                ///< MONITOR_SHM_MAGIC; se escribe al final de la inicialización
+    uint32_t version;             ///< MONITOR_SHM_VERSION
+    uint32_t header_size;         ///< sizeof(MonitorShmHeader)
+    uint32_t slot_count;          ///< Ranuras del anillo
+    uint32_t slot_size;           ///< Bytes por ranura, incluido MonitorShmSlot
+    MonitorStreamHeader schema;   ///< Esquema de los registros de las ranuras
+    _Atomic uint64_t head;        ///< Ticks publicados; el último es head - 1
+    _Atomic uint64_t oversized;   ///< Ticks que no entraron en una ranura
+    char reserved[64];            ///< Relleno hasta 128 bytes
+} MonitorShmHeader;
+
+/**
+ * @brief Encabezado de una ranura, seguido del registro.
+ */
+typedef struct
+{
+    _Atomic uint64_t seq; ///< Impar mientras se escribe; 2n+2 con el tick n completo
+    uint32_t length;      ///< Bytes del registro, 0 si no entró en la ranura
+    uint32_t reserved;    ///< 0
+} MonitorShmSlot;
+
+_Static_assert(sizeof(MonitorShmHeader) == 128, "MonitorShmHeader");
+_Static_assert(sizeof(MonitorShmSlot) == 16, "MonitorShmSlot");
+
+/**
+ * @brief Configuración del anillo.
+ */
+typedef struct
+{
+    const char* name; ///< Nombre para shm_open, empezando con '/'
+    size_t slots;     ///< Ranuras; 0 desactiva el anillo
+    size_t slot_size; ///< Bytes por ranura
+} MonitorShmConfig;
+
+/**
+ * @brief Lee la configuración de las variables de entorno.
+ *
+ * MONITOR_SHM_NAME elige el nombre, MONITOR_SHM_SLOTS la cantidad de ranuras
+ * (0 desactiva el anillo) y MONITOR_SHM_SLOT_SIZE los bytes por ranura.
+ *
+ * @param config Configuración a completar.
+ */
+void monitor_shm_config_from_env(MonitorShmConfig* config);
+
+/**
+ * @brief Crea el objeto compartido y lo mapea.
+ *
+ * Un objeto previo con el mismo nombre se desvincula; los lectores que lo
+ * tengan mapeado dejan de ver ticks nuevos y deben volver a abrirlo.
+ *
+ * @param config Configuración del anillo.
+ * @return 0 si se creó, -1 en caso de error.
+ */
+int monitor_shm_start(const MonitorShmConfig* config);
+
+/**
+ * @brief Publica el registro de un tick en la próxima ranura.
+ *
+ * Nunca bloquea: no toma locks ni hace llamadas al sistema.
+ *
+ * @param record Registro de monitor_record_finish.
+ * @param length Bytes del registro.
+ * @return 0 si se publicó, -1 si el anillo no está activo.
+ */
+int monitor_shm_publish(const void* record, size_t length);
+
+/**
+ * @brief Desmapea y desvincula el objeto compartido.
+ */
+void monitor_shm_stop();
+
+#endif // MONITOR_SHM_H
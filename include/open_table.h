@@ -0,0 +1,121 @@
+/**
+ * @file open_table.h
+ * @brief Tabla hash de direccionamiento abierto con sondeo lineal.
+ *
+ * La usan alloc_trace.c, para los bloques vivos de la traza, y proc_top.c,
+ * para los pids seguidos. Cada ranura es una estructura del llamador que
+ * empieza con una clave de 64 bits; la clave 0 marca una ranura libre. El
+ * borrado desplaza hacia atrás las ranuras que quedaron fuera de su posición,
+ * así no quedan marcas de borrado que alarguen las búsquedas.
+ */
+
+#ifndef OPEN_TABLE_H
+#define OPEN_TABLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @brief Tabla y sus ranuras.
+ */
+typedef struct
+{
+    unsigned char* slots; ///< Ranuras contiguas
+    size_t slot_size;     ///< Bytes por ranura, con la clave al principio
+    size_t mask;          ///< Capacidad menos uno; la capacidad es potencia de dos
+    size_t count;         ///< Ranuras ocupadas
+} OpenTable;
+
+/**
+ * @brief Reserva una tabla vacía.
+ *
+ * @param table Tabla a inicializar.
+ * @param capacity Cantidad de ranuras; debe ser potencia de dos.
+ * @param slot_size Bytes por ranura.
+ * @return 0 si tuvo éxito, -1 si no hubo memoria.
+ */
+int open_table_init(OpenTable* table, size_t capacity, size_t slot_size);
+
+/**
+ * @brief Libera las ranuras y deja la tabla vacía.
+ *
+ * @param table Tabla a liberar.
+ */
+void open_table_free(OpenTable* table);
+
+/**
+ * @brief Devuelve la ranura s.
+ */
+static inline void* open_table_slot(const OpenTable* table, size_t s)
+{
+    return table->slots + s * table->slot_size;
+}
+
+/**
+ * @brief Devuelve la clave de la ranura s, o 0 si está libre.
+ */
+static inline uint64_t open_table_key(const OpenTable* table, size_t s)
+{
+    uint64_t key;
+    memcpy(&key, open_table_slot(table, s), sizeof(key));
+    return key;
+}
+
+/**
+ * @brief Devuelve la posición inicial de la clave (hash de Fibonacci).
+ */
+static inline size_t open_table_home(const OpenTable* table, uint64_t key)
+{
+    return (size_t)((key * 0x9E3779B97F4A7C15ULL) >> 32) & table->mask;
+}
+
+/**
+ * @brief Busca una clave.
+ *
+ * @param table Tabla con al menos una ranura libre.
+ * @param key Clave distinta de 0.
+ * @return La ranura de la clave o, si no está, la ranura libre donde va.
+ */
+static inline size_t open_table_find(const OpenTable* table, uint64_t key)
+{
+    size_t s = open_table_home(table, key);
+    for (uint64_t found = open_table_key(table, s); found != 0 && found != key;
+         found = open_table_key(table, s))
+    {
+        s = (s + 1) & table->mask;
+    }
+    return s;
+}
+
+/**
+ * @brief Ocupa la ranura libre que devolvió open_table_find para la clave.
+ *
+ * Solo escribe la clave; el resto de la ranura queda a cargo del llamador.
+ */
+static inline void open_table_claim(OpenTable* table, size_t s, uint64_t key)
+{
+    memcpy(open_table_slot(table, s), &key, sizeof(key));
+    table->count++;
+}
+
+/**
+ * @brief Libera la ranura s, desplazando hacia atrás las que la siguen.
+ *
+ * Puede mover a s una ranura posterior: quien recorre la tabla borrando debe
+ * volver a revisar s antes de avanzar.
+ *
+ * @param table Tabla.
+ * @param s Ranura ocupada.
+ */
+void open_table_remove(OpenTable* table, size_t s);
+
+/**
+ * @brief Duplica la capacidad y reubica las ranuras ocupadas.
+ *
+ * @param table Tabla a agrandar.
+ * @return 0 si tuvo éxito, -1 si no hubo memoria; la tabla queda intacta.
+ */
+int open_table_grow(OpenTable* table);
+
+#endif // OPEN_TABLE_H
@@ -0,0 +1,123 @@
+/**
+ * @file proc_parse.h
+ * @brief Tokenizador y lector de enteros para archivos de /proc sin reservas
+ * de memoria.
+ *
+ * Reemplaza a sscanf en los recolectores. Recorre el búfer devuelto por
+ * proc_file_read sin modificarlo ni copiarlo: las líneas y los campos se
+ * representan como rangos [pos, end) dentro del mismo búfer. La búsqueda de
+ * saltos de línea y de separadores entre campos usa SSE2 cuando está
+ * disponible, con una versión escalar equivalente en otro caso.
+ */
+
+#ifndef PROC_PARSE_H
+#define PROC_PARSE_H
+
+#include <stddef.h>
+#include <string.h>
+
+/**
+ * @brief Rango de caracteres pendiente de analizar.
+ */
+typedef struct
+{
+    const char* pos; ///< Siguiente carácter a analizar
+    const char* end; ///< Fin del rango (exclusivo)
+} ProcCursor;
+
+/**
+ * @brief Inicializa un cursor sobre un búfer.
+ *
+ * @param cursor Cursor a inicializar.
+ * @param buffer Inicio del búfer.
+ * @param length Cantidad de bytes del búfer.
+ */
+static inline void proc_cursor_init(ProcCursor* cursor, const char* buffer, size_t length)
+{
+    cursor->pos = buffer;
+    cursor->end = buffer + length;
+}
+
+/**
+ * @brief Extrae la siguiente línea del cursor, sin el '\n' final.
+ *
+ * @param cursor Cursor sobre el archivo completo; avanza a la línea siguiente.
+ * @param line Recibe el rango de la línea.
+ * @return 1 si se extrajo una línea, 0 si no quedan más.
+ */
+int proc_next_line(ProcCursor* cursor, ProcCursor* line);
+
+/**
+ * @brief Avanza el cursor hasta el primer carácter que no sea espacio.
+ *
+ * @param cursor Cursor a avanzar.
+ */
+void proc_skip_spaces(ProcCursor* cursor);
+
+/**
+ * @brief Extrae el siguiente campo separado por espacios.
+ *
+ * @param cursor Cursor a avanzar; queda justo después del campo.
+ * @param field Recibe el rango del campo.
+ * @return 1 si se extrajo un campo, 0 si no quedan más.
+ */
+int proc_next_field(ProcCursor* cursor, ProcCursor* field);
+
+/**
+ * @brief Lee el siguiente entero sin signo, ignorando los espacios previos.
+ *
+ * @param cursor Cursor a avanzar; queda justo después del último dígito.
+ * @param value Recibe el valor leído.
+ * @return 1 si se leyó un entero, 0 si el siguiente campo no es numérico.
+ */
+int proc_parse_u64(ProcCursor* cursor, unsigned long long* value);
+
+/**
+ * @brief Lee hasta count enteros sin signo consecutivos.
+ *
+ * @param cursor Cursor a avanzar.
+ * @param values Arreglo que recibe los valores.
+ * @param count Cantidad máxima de valores a leer.
+ * @return Cantidad de valores leídos.
+ */
+size_t proc_parse_u64_array(ProcCursor* cursor, unsigned long long* values, size_t count);
+
+/**
+ * @brief Comprueba si el rango comienza con un prefijo y, en ese caso, lo salta.
+ *
+ * @param cursor Cursor a comprobar; solo avanza si el prefijo coincide.
+ * @param prefix Prefijo buscado.
+ * @param length Longitud del prefijo.
+ * @return 1 si el prefijo coincide, 0 en otro caso.
+ */
+static inline int proc_consume_prefix(ProcCursor* cursor, const char* prefix, size_t length)
+{
+    if ((size_t)(cursor->end - cursor->pos) < length || memcmp(cursor->pos, prefix, length) != 0)
+    {
+        return 0;
+    }
+    cursor->pos += length;
+    return 1;
+}
+
+/**
+ * @brief Avanza el cursor hasta después de la primera aparición de un carácter.
+ *
+ * @param cursor Cursor a avanzar.
+ * @param delimiter Carácter buscado.
+ * @param before Si no es NULL, recibe el rango anterior al carácter.
+ * @return 1 si se encontró el carácter, 0 en otro caso (el cursor no se mueve).
+ */
+int proc_split_at(ProcCursor* cursor, char delimiter, ProcCursor* before);
+
+/**
+ * @brief Copia un rango en un búfer terminado en '\0', truncando si no entra.
+ *
+ * @param field Rango a copiar.
+ * @param out Búfer de destino.
+ * @param size Tamaño del búfer de destino.
+ * @return Cantidad de caracteres copiados (sin contar el '\0').
+ */
+size_t proc_field_copy(const ProcCursor* field, char* out, size_t size);
+
+#endif // PROC_PARSE_H
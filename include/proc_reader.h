@@ -0,0 +1,51 @@
+/**
+ * @file proc_reader.h
+ * @brief Caché de descriptores persistentes para los archivos de /proc.
+ *
+ * Cada archivo de /proc que usan los recolectores se abre una única vez y se
+ * vuelve a leer con pread desde el desplazamiento 0 sobre un búfer reutilizable,
+ * evitando el fopen/fclose y la inicialización de stdio en cada lectura.
+ */
+
+#ifndef PROC_READER_H
+#define PROC_READER_H
+
+#include <stddef.h>
+
+/**
+ * @brief Identificadores de los archivos de /proc compartidos por los
+ * recolectores.
+ */
+typedef enum
+{
+    PROC_FILE_MEMINFO,   ///< /proc/meminfo
+    PROC_FILE_STAT,      ///< /proc/stat
+    PROC_FILE_DISKSTATS, ///< /proc/diskstats
+    PROC_FILE_NET_DEV,   ///< /proc/net/dev
+    PROC_FILE_COUNT      ///< Cantidad de archivos gestionados
+} ProcFileId;
+
+/**
+ * @brief Lee el contenido completo de un archivo de /proc.
+ *
+ * Abre el archivo la primera vez y lo relee con pread en las siguientes
+ * llamadas. El búfer crece si el contenido no entra y se conserva entre
+ * lecturas. Si la lectura falla, el descriptor se cierra y se reabre una vez
+ * antes de reportar el error.
+ *
+ * El búfer devuelto pertenece a la caché, termina en '\0' y solo es válido
+ * hasta la próxima lectura del mismo archivo. No es seguro entre hilos: todos
+ * los recolectores se ejecutan en el hilo principal.
+ *
+ * @param id Archivo a leer.
+ * @param length Si no es NULL, recibe la cantidad de bytes leídos.
+ * @return Puntero al contenido leído, o NULL en caso de error.
+ */
+const char *proc_file_read(ProcFileId id, size_t *length);
+
+/**
+ * @brief Cierra todos los descriptores y libera los búferes de la caché.
+ */
+void proc_files_close(void);
+
+#endif // PROC_READER_H
@@ -0,0 +1,142 @@
+/**
+ * @file proc_top.h
+ * @brief Recolector por proceso con selección de los N mayores.
+ *
+ * Cada barrido lista /proc con getdents64 sobre un descriptor del directorio
+ * abierto una sola vez y lee /proc/[pid]/stat con openat relativo a él, sin
+ * armar rutas absolutas ni pasar por opendir/readdir. De stat salen el nombre,
+ * el tiempo de CPU (utime + stime) y el RSS, que es el mismo valor que la
+ * segunda columna de statm.
+ *
+ * El estado de cada pid (su tiempo de CPU del barrido anterior, para calcular
+ * la tasa) vive en una tabla de direccionamiento abierto de 16 bytes por
+ * ranura, dimensionada una sola vez para max_pids procesos. Los pids que ya
+ * no aparecen se borran al final del barrido. Si la tabla está llena, los
+ * pids nuevos se cuentan como descartados y no se leen, así que memoria y
+ * trabajo por barrido quedan acotados por max_pids. Los N mayores por CPU y
+ * por RSS se eligen con dos montículos de mínimos de N elementos, sin ordenar
+ * todos los procesos.
+ *
+ * No es seguro entre hilos: se usa desde el hilo principal.
+ */
+
+#ifndef PROC_TOP_H
+#define PROC_TOP_H
+
+#include <stddef.h>
+
+/**
+ * @brief Procesos por ranking si no se indica otra cantidad.
+ */
+#define PROC_TOP_DEFAULT_N 10
+
+/**
+ * @brief Procesos que se siguen si no se indica otra cantidad.
+ */
+#define PROC_TOP_DEFAULT_MAX_PIDS 65536
+
+/**
+ * @brief Bytes del nombre de un proceso, incluido el '\0' (como TASK_COMM_LEN).
+ */
+#define PROC_TOP_COMM_SIZE 16
+
+/**
+ * @brief Configuración del recolector.
+ */
+typedef struct
+{
+    const char* root; ///< Directorio de procesos, normalmente "/proc"
+    size_t top_n;     ///< Procesos por ranking; 0 desactiva el recolector
+    size_t max_pids;  ///< Procesos que caben en la tabla
+} ProcTopConfig;
+
+/**
+ * @brief Un proceso de un ranking.
+ */
+typedef struct
+{
+    int pid;                       ///< Identificador del proceso
+    char comm[PROC_TOP_COMM_SIZE]; ///< Nombre del proceso
+    double cpu_usage;              ///< Segundos de CPU por segundo
+    unsigned long long rss_bytes;  ///< Memoria residente
+} ProcTopEntry;
+
+/**
+ * @brief Costo del último barrido.
+ */
+typedef struct
+{
+    size_t pids;         ///< Pids encontrados en el directorio
+    size_t tracked;      ///< Pids en la tabla
+    size_t dropped;      ///< Pids nuevos descartados por tabla llena
+    double cpu_seconds;  ///< Tiempo de CPU del hilo en el barrido
+    double wall_seconds; ///< Duración del barrido
+    size_t memory_bytes; ///< Memoria reservada por el recolector
+} ProcTopStats;
+
+/**
+ * @brief Lee la configuración de las variables de entorno.
+ *
+ * MONITOR_PROC_TOP_N fija los procesos por ranking (0 desactiva el
+ * recolector) y MONITOR_PROC_TOP_MAX_PIDS los procesos que se siguen.
+ *
+ * @param config Configuración a completar.
+ */
+void proc_top_config_from_env(ProcTopConfig* config);
+
+/**
+ * @brief Abre el directorio de procesos y reserva la tabla y los montículos.
+ *
+ * @param config Configuración.
+ * @return 0 si se inició, -1 en caso de error.
+ */
+int proc_top_start(const ProcTopConfig* config);
+
+/**
+ * @brief Recorre el directorio de procesos y actualiza los rankings.
+ *
+ * La tasa de CPU de un pid se calcula desde el barrido en que apareció, así
+ * que en el primero todos los procesos tienen tasa 0.
+ *
+ * @return 0 si se completó, -1 si el recolector no está iniciado o falló la
+ * lectura del directorio.
+ */
+int proc_top_scan();
+
+/**
+ * @brief Devuelve el ranking por uso de CPU del último barrido.
+ *
+ * @param entries Recibe los procesos, de mayor a menor; válidos hasta el
+ * próximo barrido.
+ * @return Cantidad de procesos, a lo sumo top_n.
+ */
+size_t proc_top_by_cpu(const ProcTopEntry** entries);
+
+/**
+ * @brief Devuelve el ranking por memoria residente del último barrido.
+ *
+ * @param entries Recibe los procesos, de mayor a menor; válidos hasta el
+ * próximo barrido.
+ * @return Cantidad de procesos, a lo sumo top_n.
+ */
+size_t proc_top_by_rss(const ProcTopEntry** entries);
+
+/**
+ * @brief Devuelve la cantidad de procesos por ranking, o 0 si el recolector
+ * no está iniciado.
+ */
+size_t proc_top_size();
+
+/**
+ * @brief Devuelve el costo del último barrido.
+ *
+ * @param stats Recibe las estadísticas.
+ */
+void proc_top_get_stats(ProcTopStats* stats);
+
+/**
+ * @brief Cierra el directorio y libera la memoria del recolector.
+ */
+void proc_top_stop();
+
+#endif // PROC_TOP_H
@@ -0,0 +1,96 @@
+/**
+ * @file scheduler.h
+ * @brief Planificador de recolectores con intervalos independientes.
+ *
+ * Cada tarea tiene su propio intervalo y sus vencimientos caen en múltiplos
+ * exactos del intervalo en el reloj de pared (una tarea de 1 s corre en cada
+ * segundo entero, una de 100 ms en cada décima). Un único timerfd absoluto
+ * despierta al hilo en el próximo vencimiento, así que el tiempo de trabajo no
+ * se suma al período y el bucle no deriva.
+ *
+ * Las tareas que vencen juntas corren en el orden de la tabla. Por cada tarea
+ * se cuentan las ejecuciones, el retraso respecto del vencimiento (jitter) y
+ * los vencimientos perdidos (overruns) cuando una ejecución o un despertar
+ * tardío pasan el siguiente vencimiento.
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stddef.h>
+
+/**
+ * @brief Tarea periódica del planificador.
+ *
+ * Los campos de estado los mantiene el planificador; la tabla solo debe
+ * completar name, run e interval_ms.
+ */
+typedef struct
+{
+    const char* name;               ///< Nombre; define MONITOR_INTERVAL_<NOMBRE>_MS
+    void (*run)(void);              ///< Trabajo de la tarea
+    unsigned int interval_ms;       ///< Intervalo por defecto; 0 desactiva la tarea
+    long long deadline_ns;          ///< Próximo vencimiento en CLOCK_REALTIME
+    unsigned long long runs;        ///< Ejecuciones desde el inicio
+    unsigned long long overruns;    ///< Vencimientos perdidos desde el inicio
+    double last_jitter_seconds;     ///< Retraso de la última ejecución
+    double max_jitter_seconds;      ///< Mayor retraso desde la última lectura
+} SchedulerTask;
+
+/**
+ * @brief Estadísticas de una tarea.
+ */
+typedef struct
+{
+    const char* name;            ///< Nombre de la tarea
+    unsigned int interval_ms;    ///< Intervalo efectivo
+    unsigned long long runs;     ///< Ejecuciones desde el inicio
+    unsigned long long overruns; ///< Vencimientos perdidos desde el inicio
+    double last_jitter_seconds;  ///< Retraso de la última ejecución
+    double max_jitter_seconds;   ///< Mayor retraso desde la lectura anterior
+} SchedulerStats;
+
+/**
+ * @brief Prepara el planificador sobre una tabla de tareas.
+ *
+ * Aplica MONITOR_INTERVAL_<NOMBRE>_MS (nombre en mayúsculas) a cada tarea y
+ * alinea su primer vencimiento al próximo múltiplo del intervalo.
+ *
+ * @param tasks Tabla de tareas; debe vivir mientras se use el planificador.
+ * @param count Cantidad de tareas.
+ * @return 0 si se inició, -1 si no se pudo crear el timerfd.
+ */
+int scheduler_init(SchedulerTask* tasks, size_t count);
+
+/**
+ * @brief Espera el próximo vencimiento y corre las tareas vencidas.
+ *
+ * Una señal interrumpe la espera sin correr tareas, para que el llamador pueda
+ * revisar si debe terminar. Si el reloj de pared salta, los vencimientos se
+ * vuelven a alinear.
+ *
+ * @return Cantidad de tareas ejecutadas, o -1 si falló la espera.
+ */
+int scheduler_run_once();
+
+/**
+ * @brief Devuelve la cantidad de tareas del planificador.
+ */
+size_t scheduler_task_count();
+
+/**
+ * @brief Lee las estadísticas de una tarea y reinicia su mayor retraso.
+ *
+ * Debe llamarse desde el hilo del planificador, por ejemplo desde una tarea.
+ *
+ * @param index Índice de la tarea en la tabla.
+ * @param stats Recibe las estadísticas.
+ */
+void scheduler_get_stats(size_t index, SchedulerStats* stats);
+
+/**
+ * @brief Cierra el timerfd del planificador.
+ */
+void scheduler_close();
+
+#endif // SCHEDULER_H
@@ -0,0 +1,95 @@
+/**
+ * @file segregated_fit.h
+ * @brief Política de listas libres segregadas por clase de tamaño.
+ *
+ * Los pedidos de hasta SEGREGATED_MAX_SIZE bytes se redondean a un múltiplo
+ * de SEGREGATED_CLASS_SIZE y se sirven desde la lista libre de su clase, sin
+ * recorrer bloques: reservar y liberar cuestan O(1). Cuando una clase se queda
+ * sin bloques se corta uno nuevo de su losa actual, y cuando la losa se agota
+ * se proyecta otra de SEGREGATED_SLAB_SIZE bytes con policy_reserve. Las
+ * losas no se devuelven. Los pedidos mayores reciben su propia proyección,
+ * que se devuelve al liberarlos. Ninguno pasa por las políticas de memory.h,
+ * así que no alteran sus estadísticas. Se elige con SEGREGATED_FIT en
+ * alloc_policy.h.
+ *
+ * Cada bloque lleva delante un encabezado de 8 bytes con el tamaño pedido, del
+ * que segregated_free deduce la clase. La fragmentación que se reporta es la
+ * fracción de las losas y proyecciones que no ocupan los bytes pedidos vivos:
+ * incluye el redondeo, los encabezados y los bloques libres en las listas.
+ *
+ * Como my_malloc, no es seguro entre hilos: los llamadores deben serializarlo
+ * igual que al resto del asignador (alloc_stress_lock).
+ */
+
+#ifndef SEGREGATED_FIT_H
+#define SEGREGATED_FIT_H
+
+#include "alloc_policy.h"
+#include <stddef.h>
+
+/**
+ * @brief Separación entre clases de tamaño.
+ */
+#define SEGREGATED_CLASS_SIZE 16
+
+/**
+ * @brief Mayor pedido servido por las clases; cubre los tamaños de
+ * simulate_memory_operations.
+ */
+#define SEGREGATED_MAX_SIZE 512
+
+/**
+ * @brief Cantidad de clases de tamaño.
+ */
+#define SEGREGATED_CLASSES (SEGREGATED_MAX_SIZE / SEGREGATED_CLASS_SIZE)
+
+/**
+ * @brief Bytes de cada losa pedida al asignador.
+ */
+#define SEGREGATED_SLAB_SIZE 16384
+
+/**
+ * @brief Estadísticas de la política, equivalentes a las de stats_memory.h.
+ */
+typedef struct
+{
+    unsigned long long allocations; ///< Reservas exitosas desde el inicio
+    double allocation_time;         ///< Tiempo total de las reservas (segundos)
+    size_t reserved_bytes;          ///< Bytes de las losas y proyecciones
+    size_t requested_bytes;         ///< Bytes pedidos vivos
+    size_t free_blocks;             ///< Bloques en las listas libres
+    size_t free_bytes;              ///< Bytes de clase de esos bloques
+    size_t largest_free_block;      ///< Clase más grande con bloques libres
+    size_t free_histogram[POLICY_FREE_BUCKETS]; ///< Bloques libres por tramo
+} SegregatedStats;
+
+/**
+ * @brief Reserva un bloque.
+ *
+ * @param size Bytes pedidos.
+ * @return El bloque, o NULL si no hay memoria.
+ */
+void* segregated_malloc(size_t size);
+
+/**
+ * @brief Libera un bloque devuelto por segregated_malloc.
+ *
+ * @param block Bloque, o NULL.
+ */
+void segregated_free(void* block);
+
+/**
+ * @brief Devuelve las estadísticas de la política.
+ *
+ * @param stats Recibe las estadísticas.
+ */
+void segregated_get_stats(SegregatedStats* stats);
+
+/**
+ * @brief Recorre las listas libres y las compara con las estadísticas.
+ *
+ * @return 0 si coinciden, -1 si no (el detalle va a stderr).
+ */
+int segregated_check();
+
+#endif // SEGREGATED_FIT_H
@@ -0,0 +1,28 @@
+/**
+ * @file xorshift.h
+ * @brief Generador xorshift64 de los hilos de estrés y de bench_allocator.
+ *
+ * Da la misma secuencia en todas las plataformas, a diferencia de rand(), y
+ * cada llamador lleva su propio estado, así no hay que sincronizar hilos.
+ */
+
+#ifndef XORSHIFT_H
+#define XORSHIFT_H
+
+#include <stdint.h>
+
+/**
+ * @brief Avanza el generador y devuelve el siguiente valor.
+ *
+ * @param state Estado del generador; nunca debe ser 0.
+ * @return Siguiente valor de la secuencia.
+ */
+static inline uint64_t xorshift64_next(uint64_t* state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+#endif // XORSHIFT_H
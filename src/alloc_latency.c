@@ -0,0 +1,101 @@
+#include "../include/alloc_latency.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @brief Contadores de un hilo. Solo ese hilo los escribe; el exportador los
+ * lee con cargas atómicas.
+ */
+typedef struct AllocLatencyBlock {
+  _Atomic uint64_t counts[ALLOC_LATENCY_STRATEGIES][ALLOC_OP_COUNT]
+                         [ALLOC_LATENCY_BUCKETS];
+  struct AllocLatencyBlock *next; ///< Bloque registrado antes
+} AllocLatencyBlock;
+
+/** Bloques de todos los hilos que registraron algo; solo se agregan */
+static _Atomic(AllocLatencyBlock *) blocks = NULL;
+
+/** Bloque del hilo actual */
+static _Thread_local AllocLatencyBlock *local_block = NULL;
+
+/** Totales ya entregados por alloc_latency_collect (solo el exportador) */
+static uint64_t collected[ALLOC_LATENCY_STRATEGIES][ALLOC_OP_COUNT]
+                         [ALLOC_LATENCY_BUCKETS];
+
+static size_t alloc_latency_index(uint64_t nanoseconds) {
+  if (nanoseconds < ALLOC_LATENCY_SUB_BUCKETS) {
+    return (size_t)nanoseconds;
+  }
+  unsigned int exponent = 63 - (unsigned int)__builtin_clzll(nanoseconds);
+  if (exponent > ALLOC_LATENCY_MAX_EXPONENT) {
+    return ALLOC_LATENCY_BUCKETS - 1;
+  }
+  unsigned int shift = exponent - ALLOC_LATENCY_SUB_BUCKET_BITS;
+  return ((size_t)(shift + 1) << ALLOC_LATENCY_SUB_BUCKET_BITS) |
+         ((nanoseconds >> shift) & (ALLOC_LATENCY_SUB_BUCKETS - 1));
+}
+
+// Punto medio del tramo, en segundos
+static double alloc_latency_value(size_t index) {
+  if (index < ALLOC_LATENCY_SUB_BUCKETS) {
+    return (double)index / 1e9;
+  }
+  unsigned int shift = (unsigned int)(index >> ALLOC_LATENCY_SUB_BUCKET_BITS) - 1;
+  uint64_t low = ((uint64_t)ALLOC_LATENCY_SUB_BUCKETS |
+                  (index & (ALLOC_LATENCY_SUB_BUCKETS - 1)))
+                 << shift;
+  return ((double)low + (double)(1ULL << shift) / 2.0) / 1e9;
+}
+
+static AllocLatencyBlock *alloc_latency_register(void) {
+  AllocLatencyBlock *block = calloc(1, sizeof(AllocLatencyBlock));
+  if (block == NULL) {
+    fprintf(stderr, "Error al reservar los contadores de latencia\n");
+    return NULL;
+  }
+  block->next = atomic_load_explicit(&blocks, memory_order_relaxed);
+  while (!atomic_compare_exchange_weak_explicit(
+      &blocks, &block->next, block, memory_order_release,
+      memory_order_relaxed)) {
+  }
+  return block;
+}
+
+void alloc_latency_record(int strategy, AllocOp op, uint64_t nanoseconds) {
+  if (strategy < 0 || strategy >= ALLOC_LATENCY_STRATEGIES) {
+    return;
+  }
+  if (local_block == NULL && (local_block = alloc_latency_register()) == NULL) {
+    return;
+  }
+  // Un único escritor por contador: carga y almacenamiento relajados, sin
+  // prefijo lock
+  _Atomic uint64_t *count =
+      &local_block->counts[strategy][op][alloc_latency_index(nanoseconds)];
+  atomic_store_explicit(
+      count, atomic_load_explicit(count, memory_order_relaxed) + 1,
+      memory_order_relaxed);
+}
+
+void alloc_latency_collect(AllocLatencyVisitor visit, void *ctx) {
+  AllocLatencyBlock *head = atomic_load_explicit(&blocks, memory_order_acquire);
+
+  for (int strategy = 0; strategy < ALLOC_LATENCY_STRATEGIES; strategy++) {
+    for (int op = 0; op < ALLOC_OP_COUNT; op++) {
+      for (size_t i = 0; i < ALLOC_LATENCY_BUCKETS; i++) {
+        uint64_t total = 0;
+        for (AllocLatencyBlock *block = head; block != NULL;
+             block = block->next) {
+          total += atomic_load_explicit(&block->counts[strategy][op][i],
+                                        memory_order_relaxed);
+        }
+        if (total > collected[strategy][op][i]) {
+          visit(strategy, (AllocOp)op, alloc_latency_value(i),
+                total - collected[strategy][op][i], ctx);
+          collected[strategy][op][i] = total;
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,147 @@
+#include "../include/alloc_policy.h"
+#include "../../../lib/memory/include/memory.h"
+#include "../../../lib/memory/include/stats_memory.h"
+#include "../include/indexed_fit.h"
+#include "../include/segregated_fit.h"
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/** Política de memory.h activa, o -1 antes de la primera selección */
+static int selected = -1;
+
+/** Fragmentación de las políticas de memory.h en el último recorrido */
+static double heap_rates[ALLOC_POLICY_COUNT];
+
+static int check_enabled;
+
+/** Bytes proyectados con policy_reserve y no devueltos */
+static size_t reserved_bytes;
+
+static void policy_select(int policy) {
+  if (policy != selected) {
+    malloc_control(policy);
+    selected = policy;
+  }
+}
+
+void *policy_malloc(int policy, size_t size) {
+  switch (policy) {
+  case SEGREGATED_FIT:
+    return segregated_malloc(size);
+  case INDEXED_BEST_FIT:
+    return indexed_malloc(size);
+  default:
+    policy_select(policy);
+    return my_malloc(size);
+  }
+}
+
+void policy_free(int policy, void *block) {
+  switch (policy) {
+  case SEGREGATED_FIT:
+    segregated_free(block);
+    break;
+  case INDEXED_BEST_FIT:
+    indexed_free(block);
+    break;
+  default:
+    policy_select(policy);
+    my_free(block);
+    break;
+  }
+}
+
+size_t policy_reserve_size(size_t bytes) {
+  static size_t page_size;
+  if (page_size == 0) {
+    page_size = (size_t)sysconf(_SC_PAGESIZE);
+  }
+  return (bytes + page_size - 1) & ~(page_size - 1);
+}
+
+void *policy_reserve(size_t bytes) {
+  void *memory = mmap(NULL, policy_reserve_size(bytes), PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (memory == MAP_FAILED) {
+    perror("Error al reservar memoria para la política");
+    return NULL;
+  }
+  reserved_bytes += policy_reserve_size(bytes);
+  return memory;
+}
+
+void policy_release(void *memory, size_t bytes) {
+  if (memory != NULL) {
+    munmap(memory, policy_reserve_size(bytes));
+    reserved_bytes -= policy_reserve_size(bytes);
+  }
+}
+
+size_t policy_reserved_bytes() { return reserved_bytes; }
+
+static double unused_percentage(size_t used, size_t reserved) {
+  return reserved > 0 ? 100.0 * (1.0 - (double)used / (double)reserved) : 0.0;
+}
+
+void policy_walk_heap(void) {
+  calculate_fragmentation_per_method(heap_rates);
+  if (check_enabled) {
+    segregated_check();
+    indexed_check();
+  }
+}
+
+void policy_fragmentation(double *rates) {
+  for (int policy = 0; policy < SEGREGATED_FIT; policy++) {
+    rates[policy] = heap_rates[policy];
+  }
+
+  SegregatedStats segregated;
+  segregated_get_stats(&segregated);
+  rates[SEGREGATED_FIT] = unused_percentage(segregated.requested_bytes,
+                                            segregated.reserved_bytes);
+
+  IndexedStats indexed;
+  indexed_get_stats(&indexed);
+  rates[INDEXED_BEST_FIT] =
+      unused_percentage(indexed.allocated_bytes, indexed.reserved_bytes);
+}
+
+size_t policy_free_bucket(size_t size) {
+  if (size <= (1UL << POLICY_FREE_MIN_SHIFT)) {
+    return 0;
+  }
+  // Redondeo hacia arriba del logaritmo: el límite del tramo es inclusivo
+  size_t bucket =
+      (size_t)(64 - __builtin_clzl(size - 1)) - POLICY_FREE_MIN_SHIFT;
+  return bucket < POLICY_FREE_BUCKETS - 1 ? bucket : POLICY_FREE_BUCKETS - 1;
+}
+
+int policy_free_stats(int policy, PolicyFreeStats *out) {
+  if (policy == SEGREGATED_FIT) {
+    SegregatedStats segregated;
+    segregated_get_stats(&segregated);
+    out->free_bytes = segregated.free_bytes;
+    out->largest_free_block = segregated.largest_free_block;
+    // Cada clase solo sirve a su tamaño: no hay bloque que se parta
+    out->largest_allocatable = segregated.largest_free_block;
+    out->free_blocks = segregated.free_blocks;
+    memcpy(out->histogram, segregated.free_histogram, sizeof(out->histogram));
+    return 0;
+  }
+  if (policy == INDEXED_BEST_FIT) {
+    IndexedStats indexed;
+    indexed_get_stats(&indexed);
+    out->free_bytes = indexed.free_bytes;
+    out->largest_free_block = indexed.largest_free_block;
+    out->largest_allocatable = indexed.largest_allocatable;
+    out->free_blocks = indexed.free_blocks;
+    memcpy(out->histogram, indexed.free_histogram, sizeof(out->histogram));
+    return 0;
+  }
+  return -1;
+}
+
+void policy_set_check(int enabled) { check_enabled = enabled; }
@@ -0,0 +1,244 @@
+#include "../include/alloc_stress.h"
+#include "../../../lib/memory/include/memory.h"
+#include "../include/alloc_latency.h"
+#include "../include/alloc_policy.h"
+#include "../include/alloc_trace.h"
+#include "../include/xorshift.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define NS_PER_SEC 1000000000ULL
+
+// Adelanto mínimo antes de dormir: a tasas altas se duerme por tandas y no
+// una vez por operación
+#define ALLOC_STRESS_MIN_SLEEP_NS 1000000ULL
+
+// Atraso tras el cual se abandona la tasa perdida en vez de recuperarla
+#define ALLOC_STRESS_MAX_BACKLOG_NS NS_PER_SEC
+
+#define ALLOC_STRESS_MIN_SIZE 16
+
+static const char *policy_names[] = {"first_fit", "best_fit", "worst_fit",
+                                     "segregated_fit", "indexed_best_fit"};
+static const int policy_methods[] = {FIRST_FIT, BEST_FIT, WORST_FIT,
+                                     SEGREGATED_FIT, INDEXED_BEST_FIT};
+
+/**
+ * @brief Estado de un hilo trabajador. Los contadores solo los escribe el
+ * hilo; el recolector los lee con cargas atómicas.
+ */
+typedef struct {
+  pthread_t tid;
+  char name[24];                ///< Número del hilo
+  int policy;                   ///< Índice en policy_methods
+  void **blocks;                ///< Conjunto de trabajo
+  uint64_t rng;                 ///< Estado de xorshift64
+  _Atomic uint64_t ops;         ///< Operaciones desde el inicio
+  _Atomic uint64_t lock_wait_ns; ///< Espera acumulada del mutex
+  _Atomic uint64_t failed;      ///< Reservas fallidas
+} AllocStressWorker;
+
+static pthread_mutex_t allocator_mutex = PTHREAD_MUTEX_INITIALIZER;
+static atomic_int running = 0;
+static AllocStressConfig stress_config;
+static AllocStressWorker *workers = NULL;
+static size_t worker_count = 0;
+
+static uint64_t stress_now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * NS_PER_SEC + (uint64_t)ts.tv_nsec;
+}
+
+// Un solo escritor por contador: no hace falta una suma atómica
+static void add_relaxed(_Atomic uint64_t *counter, uint64_t value) {
+  atomic_store_explicit(
+      counter, atomic_load_explicit(counter, memory_order_relaxed) + value,
+      memory_order_relaxed);
+}
+
+void alloc_stress_config_from_env(AllocStressConfig *config) {
+  config->threads = 0;
+  config->working_set = ALLOC_STRESS_DEFAULT_WORKING_SET;
+  config->rate = ALLOC_STRESS_DEFAULT_RATE;
+  config->max_size = ALLOC_STRESS_DEFAULT_MAX_SIZE;
+  config->policy = -1;
+
+  const char *threads = getenv("MONITOR_ALLOC_STRESS_THREADS");
+  if (threads != NULL && atoi(threads) >= 0) {
+    config->threads = (size_t)atoi(threads);
+  }
+
+  const char *working_set = getenv("MONITOR_ALLOC_STRESS_WORKING_SET");
+  if (working_set != NULL && atoi(working_set) > 0) {
+    config->working_set = (size_t)atoi(working_set);
+  }
+
+  const char *rate = getenv("MONITOR_ALLOC_STRESS_RATE");
+  if (rate != NULL && atoi(rate) >= 0) {
+    config->rate = (unsigned int)atoi(rate);
+  }
+
+  const char *max_size = getenv("MONITOR_ALLOC_STRESS_MAX_SIZE");
+  if (max_size != NULL && atoi(max_size) >= ALLOC_STRESS_MIN_SIZE) {
+    config->max_size = (size_t)atoi(max_size);
+  }
+
+  const char *policy = getenv("MONITOR_ALLOC_STRESS_POLICY");
+  if (policy != NULL) {
+    for (int p = 0; p < ALLOC_POLICY_COUNT; p++) {
+      if (strcmp(policy, policy_names[p]) == 0) {
+        config->policy = p;
+      }
+    }
+    if (config->policy < 0) {
+      fprintf(stderr, "Política de estrés desconocida: %s\n", policy);
+    }
+  }
+}
+
+uint64_t alloc_stress_lock() {
+  // Sin contención no se lee el reloj
+  if (pthread_mutex_trylock(&allocator_mutex) == 0) {
+    return 0;
+  }
+  uint64_t start = stress_now_ns();
+  pthread_mutex_lock(&allocator_mutex);
+  return stress_now_ns() - start;
+}
+
+void alloc_stress_unlock() { pthread_mutex_unlock(&allocator_mutex); }
+
+static void stress_operation(AllocStressWorker *worker) {
+  int method = policy_methods[worker->policy];
+  size_t slot = xorshift64_next(&worker->rng) % stress_config.working_set;
+  void *block = worker->blocks[slot];
+  size_t size =
+      block != NULL ? 0
+                    : ALLOC_STRESS_MIN_SIZE +
+                          xorshift64_next(&worker->rng) %
+                              (stress_config.max_size - ALLOC_STRESS_MIN_SIZE +
+                               1);
+
+  uint64_t wait = alloc_stress_lock();
+  uint64_t start = stress_now_ns();
+  if (block == NULL) {
+    block = policy_malloc(method, size);
+    uint64_t elapsed = stress_now_ns() - start;
+    alloc_trace_malloc(method, size, block);
+    alloc_stress_unlock();
+    alloc_latency_record(method, ALLOC_OP_MALLOC, elapsed);
+    if (block == NULL) {
+      add_relaxed(&worker->failed, 1);
+    }
+    worker->blocks[slot] = block;
+  } else {
+    alloc_trace_free(method, block);
+    policy_free(method, block);
+    uint64_t elapsed = stress_now_ns() - start;
+    alloc_stress_unlock();
+    alloc_latency_record(method, ALLOC_OP_FREE, elapsed);
+    worker->blocks[slot] = NULL;
+  }
+
+  add_relaxed(&worker->lock_wait_ns, wait);
+  add_relaxed(&worker->ops, 1);
+}
+
+static void *stress_worker(void *arg) {
+  AllocStressWorker *worker = arg;
+  uint64_t period =
+      stress_config.rate > 0 ? NS_PER_SEC / stress_config.rate : 0;
+  uint64_t next = stress_now_ns();
+
+  while (atomic_load_explicit(&running, memory_order_relaxed)) {
+    stress_operation(worker);
+    if (period == 0) {
+      continue;
+    }
+
+    next += period;
+    uint64_t now = stress_now_ns();
+    if (next > now + ALLOC_STRESS_MIN_SLEEP_NS) {
+      struct timespec deadline = {.tv_sec = (time_t)(next / NS_PER_SEC),
+                                  .tv_nsec = (long)(next % NS_PER_SEC)};
+      clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL);
+    } else if (now > next + ALLOC_STRESS_MAX_BACKLOG_NS) {
+      next = now;
+    }
+  }
+
+  alloc_stress_lock();
+  for (size_t i = 0; i < stress_config.working_set; i++) {
+    if (worker->blocks[i] != NULL) {
+      alloc_trace_free(policy_methods[worker->policy], worker->blocks[i]);
+      policy_free(policy_methods[worker->policy], worker->blocks[i]);
+    }
+  }
+  alloc_stress_unlock();
+  return NULL;
+}
+
+int alloc_stress_start(const AllocStressConfig *config) {
+  if (config->threads == 0 || workers != NULL) {
+    return -1;
+  }
+  stress_config = *config;
+  workers = calloc(config->threads, sizeof(AllocStressWorker));
+  if (workers == NULL) {
+    fprintf(stderr, "Error al reservar los hilos de estrés\n");
+    return -1;
+  }
+
+  atomic_store(&running, 1);
+  for (size_t i = 0; i < config->threads; i++) {
+    AllocStressWorker *worker = &workers[i];
+    snprintf(worker->name, sizeof(worker->name), "%zu", i);
+    worker->policy =
+        config->policy >= 0 ? config->policy : (int)(i % ALLOC_POLICY_COUNT);
+    worker->rng = 0x9E3779B97F4A7C15ULL * (i + 1);
+    worker->blocks = calloc(config->working_set, sizeof(void *));
+    if (worker->blocks == NULL ||
+        pthread_create(&worker->tid, NULL, stress_worker, worker) != 0) {
+      fprintf(stderr, "Error al iniciar el hilo de estrés %zu\n", i);
+      free(worker->blocks);
+      break;
+    }
+    worker_count++;
+  }
+
+  if (worker_count == 0) {
+    alloc_stress_stop();
+    return -1;
+  }
+  return 0;
+}
+
+void alloc_stress_stop() {
+  atomic_store(&running, 0);
+  for (size_t i = 0; i < worker_count; i++) {
+    pthread_join(workers[i].tid, NULL);
+    free(workers[i].blocks);
+  }
+  free(workers);
+  workers = NULL;
+  worker_count = 0;
+}
+
+size_t alloc_stress_thread_count() { return worker_count; }
+
+void alloc_stress_get_stats(size_t index, AllocStressStats *stats) {
+  AllocStressWorker *worker = &workers[index];
+  stats->thread = worker->name;
+  stats->strategy = policy_names[worker->policy];
+  stats->ops = atomic_load_explicit(&worker->ops, memory_order_relaxed);
+  stats->lock_wait_seconds =
+      (double)atomic_load_explicit(&worker->lock_wait_ns,
+                                   memory_order_relaxed) /
+      1e9;
+  stats->failed = atomic_load_explicit(&worker->failed, memory_order_relaxed);
+}
@@ -0,0 +1,212 @@
+#include "../include/alloc_trace.h"
+#include "../include/open_table.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Eventos acumulados antes de cada fwrite
+#define ALLOC_TRACE_BUFFER_EVENTS 4096
+
+// Capacidad inicial de la tabla de bloques vivos; siempre potencia de dos
+#define ALLOC_TRACE_INITIAL_SLOTS 1024
+
+/**
+ * @brief Bloque vivo: dirección e identificador.
+ */
+typedef struct {
+  uint64_t address; ///< Clave de open_table.h
+  uint32_t id;
+} AllocTraceSlot;
+
+static pthread_mutex_t trace_mutex = PTHREAD_MUTEX_INITIALIZER;
+/** Distinto de cero con la captura abierta; se consulta sin el mutex */
+static atomic_int trace_open = 0;
+static FILE *trace_file = NULL;
+static AllocTraceEvent buffer[ALLOC_TRACE_BUFFER_EVENTS];
+static size_t buffered = 0;
+static uint64_t last_ns = 0;
+
+/** Bloques vivos, por dirección */
+static OpenTable blocks;
+
+/** Identificadores liberados, reutilizados antes de crear uno nuevo */
+static uint32_t *free_ids = NULL;
+static size_t free_id_count = 0;
+static size_t free_id_capacity = 0;
+static uint32_t next_id = 0;
+
+static uint64_t trace_now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void trace_flush(void) {
+  if (buffered > 0 &&
+      fwrite(buffer, sizeof(AllocTraceEvent), buffered, trace_file) !=
+          buffered) {
+    perror("Error al escribir la traza del asignador");
+  }
+  buffered = 0;
+}
+
+static void trace_append(AllocTraceOp op, int policy, size_t size,
+                         uint32_t id) {
+  uint64_t now = trace_now_ns();
+  uint64_t delta = now - last_ns;
+  last_ns = now;
+
+  buffer[buffered++] = (AllocTraceEvent){
+      .delta_ns = delta > UINT32_MAX ? UINT32_MAX : (uint32_t)delta,
+      .id = id,
+      .size = size > UINT32_MAX ? UINT32_MAX : (uint32_t)size,
+      .op = (uint8_t)op,
+      .policy = (uint8_t)policy,
+  };
+  if (buffered == ALLOC_TRACE_BUFFER_EVENTS) {
+    trace_flush();
+  }
+}
+
+int alloc_trace_open(const char *path) {
+  pthread_mutex_lock(&trace_mutex);
+  if (trace_file != NULL) {
+    pthread_mutex_unlock(&trace_mutex);
+    return -1;
+  }
+
+  trace_file = open_table_init(&blocks, ALLOC_TRACE_INITIAL_SLOTS,
+                               sizeof(AllocTraceSlot)) == 0
+                   ? fopen(path, "wb")
+                   : NULL;
+  if (trace_file == NULL) {
+    perror("Error al abrir la traza del asignador");
+    open_table_free(&blocks);
+    pthread_mutex_unlock(&trace_mutex);
+    return -1;
+  }
+
+  struct timespec now;
+  clock_gettime(CLOCK_REALTIME, &now);
+  AllocTraceHeader header = {0};
+  memcpy(header.magic, ALLOC_TRACE_MAGIC, sizeof(header.magic));
+  header.byte_order = ALLOC_TRACE_BYTE_ORDER_MARK;
+  header.version = ALLOC_TRACE_VERSION;
+  header.header_size = sizeof(AllocTraceHeader);
+  header.event_size = sizeof(AllocTraceEvent);
+  header.start_ns = (int64_t)now.tv_sec * 1000000000LL + now.tv_nsec;
+  // El encabezado llega al archivo aunque el proceso termine sin cerrarlo
+  if (fwrite(&header, sizeof(header), 1, trace_file) != 1 ||
+      fflush(trace_file) != 0) {
+    perror("Error al escribir la traza del asignador");
+  }
+
+  last_ns = trace_now_ns();
+  atomic_store(&trace_open, 1);
+  pthread_mutex_unlock(&trace_mutex);
+  return 0;
+}
+
+void alloc_trace_malloc(int policy, size_t size, const void *block) {
+  if (!atomic_load_explicit(&trace_open, memory_order_relaxed) ||
+      block == NULL) {
+    return;
+  }
+
+  pthread_mutex_lock(&trace_mutex);
+  if (trace_file == NULL) {
+    pthread_mutex_unlock(&trace_mutex);
+    return;
+  }
+  // Carga máxima del 50%, para que las búsquedas sean cortas
+  if ((blocks.count + 1) * 2 > blocks.mask + 1 &&
+      open_table_grow(&blocks) != 0) {
+    fprintf(stderr, "Error al reservar la tabla de la traza\n");
+    pthread_mutex_unlock(&trace_mutex);
+    return;
+  }
+
+  uint32_t id = free_id_count > 0 ? free_ids[--free_id_count] : next_id++;
+  uint64_t address = (uintptr_t)block;
+  size_t s = open_table_find(&blocks, address);
+  if (open_table_key(&blocks, s) == 0) {
+    open_table_claim(&blocks, s, address);
+  }
+  ((AllocTraceSlot *)open_table_slot(&blocks, s))->id = id;
+
+  trace_append(ALLOC_TRACE_MALLOC, policy, size, id);
+  pthread_mutex_unlock(&trace_mutex);
+}
+
+void alloc_trace_free(int policy, const void *block) {
+  if (!atomic_load_explicit(&trace_open, memory_order_relaxed) ||
+      block == NULL) {
+    return;
+  }
+
+  pthread_mutex_lock(&trace_mutex);
+  if (trace_file == NULL) {
+    pthread_mutex_unlock(&trace_mutex);
+    return;
+  }
+  size_t s = open_table_find(&blocks, (uintptr_t)block);
+  // Bloques reservados antes de abrir la captura
+  if (open_table_key(&blocks, s) == 0) {
+    pthread_mutex_unlock(&trace_mutex);
+    return;
+  }
+
+  uint32_t id = ((AllocTraceSlot *)open_table_slot(&blocks, s))->id;
+  open_table_remove(&blocks, s);
+  if (free_id_count == free_id_capacity) {
+    size_t capacity = free_id_capacity ? free_id_capacity * 2 : 256;
+    uint32_t *grown = realloc(free_ids, capacity * sizeof(uint32_t));
+    if (grown != NULL) {
+      free_ids = grown;
+      free_id_capacity = capacity;
+    }
+  }
+  // Si no hubo memoria el identificador simplemente no se reutiliza
+  if (free_id_count < free_id_capacity) {
+    free_ids[free_id_count++] = id;
+  }
+
+  trace_append(ALLOC_TRACE_FREE, policy, 0, id);
+  pthread_mutex_unlock(&trace_mutex);
+}
+
+void alloc_trace_flush(void) {
+  if (!atomic_load_explicit(&trace_open, memory_order_relaxed)) {
+    return;
+  }
+
+  pthread_mutex_lock(&trace_mutex);
+  if (trace_file != NULL) {
+    trace_flush();
+    if (fflush(trace_file) != 0) {
+      perror("Error al escribir la traza del asignador");
+    }
+  }
+  pthread_mutex_unlock(&trace_mutex);
+}
+
+void alloc_trace_close(void) {
+  pthread_mutex_lock(&trace_mutex);
+  if (trace_file != NULL) {
+    atomic_store(&trace_open, 0);
+    trace_flush();
+    if (fclose(trace_file) != 0) {
+      perror("Error al cerrar la traza del asignador");
+    }
+    trace_file = NULL;
+  }
+  open_table_free(&blocks);
+  free(free_ids);
+  free_ids = NULL;
+  free_id_count = free_id_capacity = 0;
+  next_id = 0;
+  pthread_mutex_unlock(&trace_mutex);
+}
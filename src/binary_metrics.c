@@ -0,0 +1,82 @@
+#include "../include/binary_metrics.h"
+#include "../include/metrics.h"
+#include "../include/monitor_pipe.h"
+#include "../include/monitor_record.h"
+#include <time.h>
+
+/** Constructor reutilizado entre ticks; su búfer solo crece */
+static MonitorRecordBuilder builder;
+
+/** Número de tick del próximo registro */
+static unsigned long long sequence = 0;
+
+void init_binary_metrics() {
+  MonitorStreamHeader header;
+  monitor_stream_header_init(&header);
+  monitor_pipe_set_preamble(&header, sizeof(header));
+}
+
+const void *encode_metrics_as_binary(size_t *length) {
+  monitor_record_begin(&builder);
+
+  // Un registro por dispositivo de bloques, con los mismos campos que el JSON
+  const DiskTable *disk_table = get_disk_table();
+  for (size_t i = 0; i < disk_table->capacity; i++) {
+    const DiskDevice *device = &disk_table->slots[i];
+    if (!device->in_use) {
+      continue;
+    }
+    MonitorDiskEntry *disk = monitor_record_add_disk(&builder);
+    if (disk == NULL) {
+      break;
+    }
+    monitor_record_set_name(disk->device, device->name);
+    disk->reads = device->stats.reads;
+    disk->writes = device->stats.writes;
+    disk->read_time_seconds = device->stats.read_time / 1000.0;
+    disk->write_time_seconds = device->stats.write_time / 1000.0;
+    disk->utilization_percentage = device->utilization;
+    disk->await_ms = device->await;
+  }
+
+  // Un registro por interfaz de red, con tasas en bytes por segundo
+  const NetTable *network_table = get_network_table();
+  for (size_t i = 0; i < network_table->count; i++) {
+    const NetInterface *iface = &network_table->interfaces[i];
+    MonitorNetEntry *network = monitor_record_add_net(&builder);
+    if (network == NULL) {
+      break;
+    }
+    monitor_record_set_name(network->interface, iface->name);
+    network->bandwidth_rx = iface->rx_bytes_rate;
+    network->bandwidth_tx = iface->tx_bytes_rate;
+    network->packet_ratio = (iface->stats.packets_received > 0)
+                                ? (double)iface->stats.packets_transmitted /
+                                      iface->stats.packets_received
+                                : 0.0;
+  }
+
+  // El encabezado se completa al final: agregar entradas puede mover el búfer
+  MonitorRecordHeader *header = monitor_record_header(&builder);
+  if (header == NULL) {
+    return NULL;
+  }
+  struct timespec now;
+  clock_gettime(CLOCK_REALTIME, &now);
+  header->sequence = sequence++;
+  header->timestamp_ns = (int64_t)now.tv_sec * 1000000000LL + now.tv_nsec;
+  header->cpu_usage_percentage = get_cpu_usage();
+  header->memory_usage_percentage = get_memory_usage();
+  header->context_switches_total = get_context_switches();
+  header->running_processes_count = get_running_processes();
+
+  return monitor_record_finish(&builder, length);
+}
+
+void send_metrics_as_binary() {
+  size_t length;
+  const void *record = encode_metrics_as_binary(&length);
+  if (record != NULL) {
+    monitor_pipe_submit(record, length);
+  }
+}
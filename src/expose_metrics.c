@@ -1,29 +1,144 @@
 #include "../include/expose_metrics.h"
 #include "../../../lib/memory/include/memory.h"
 #include "../../../lib/memory/include/stats_memory.h"
+#include "../include/alloc_latency.h"
+#include "../include/alloc_policy.h"
+#include "../include/alloc_stress.h"
+#include "../include/exposition.h"
+#include "../include/history.h"
+#include "../include/indexed_fit.h"
+#include "../include/metrics_snapshot.h"
+#include "../include/monitor_pipe.h"
+#include "../include/proc_top.h"
+#include "../include/scheduler.h"
+#include "../include/segregated_fit.h"
 #include <prom_collector_registry.h>
 #include <prom_gauge.h>
+#include <prom_histogram.h>
 #include <pthread.h>
-
-/** Mutex para sincronización de hilos */
-pthread_mutex_t lock;
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 /** Métrica de Prometheus para el uso de CPU */
 static prom_gauge_t *cpu_usage_metric;
 
+/** Métrica de Prometheus para el uso por núcleo y modo de CPU */
+static prom_gauge_t *cpu_core_usage_metric;
+
+/** Modos de CPU exportados por núcleo y su valor para la etiqueta "mode" */
+static const struct {
+  CpuMode mode;
+  const char *label;
+} cpu_core_modes[] = {
+    {CPU_MODE_USER, "user"},       {CPU_MODE_SYSTEM, "system"},
+    {CPU_MODE_IOWAIT, "iowait"},   {CPU_MODE_STEAL, "steal"},
+    {CPU_MODE_IRQ, "irq"},         {CPU_MODE_SOFTIRQ, "softirq"},
+};
+#define CPU_CORE_MODE_COUNT (sizeof(cpu_core_modes) / sizeof(cpu_core_modes[0]))
+
+/** Etiquetas "core" ya formateadas, reutilizadas entre ticks */
+static char (*core_labels)[12];
+static size_t core_label_count;
+
+/* Agregados de la ventana de historia del uso de CPU total y por núcleo */
+static prom_gauge_t *cpu_usage_min_metric;
+static prom_gauge_t *cpu_usage_max_metric;
+static prom_gauge_t *cpu_usage_avg_metric;
+static prom_gauge_t *cpu_core_usage_min_metric;
+static prom_gauge_t *cpu_core_usage_max_metric;
+static prom_gauge_t *cpu_core_usage_avg_metric;
+
+/** Historia del uso de CPU, muestreada en cada tick del recolector de CPU */
+static HistoryConfig history_config;
+static HistoryRing cpu_history;
+
+/** Historias por núcleo y modo, en el orden core * CPU_CORE_MODE_COUNT + m */
+static HistoryRing *core_history;
+static size_t core_history_count;
+
 /** Métrica de Prometheus para el uso de memoria */
 static prom_gauge_t *memory_usage_metric;
 
-/* Metricas de Prometheus para esrituras y lecturas de disco */
+/* Metricas de Prometheus para esrituras y lecturas de disco, etiquetadas por
+ * dispositivo */
 static prom_gauge_t *disk_reads_metric;
 static prom_gauge_t *disk_writes_metric;
 static prom_gauge_t *disk_read_time_metric;
 static prom_gauge_t *disk_write_time_metric;
-
-/* Metricas de Prometheus para ancho de banda y promedio de paquetes */
+static prom_gauge_t *disk_read_bytes_metric;
+static prom_gauge_t *disk_written_bytes_metric;
+static prom_gauge_t *disk_merged_reads_metric;
+static prom_gauge_t *disk_merged_writes_metric;
+static prom_gauge_t *disk_io_in_progress_metric;
+static prom_gauge_t *disk_io_time_metric;
+static prom_gauge_t *disk_io_weighted_time_metric;
+static prom_gauge_t *disk_discards_metric;
+static prom_gauge_t *disk_discarded_bytes_metric;
+static prom_gauge_t *disk_discard_time_metric;
+static prom_gauge_t *disk_flushes_metric;
+static prom_gauge_t *disk_flush_time_metric;
+static prom_gauge_t *disk_utilization_metric;
+static prom_gauge_t *disk_read_await_metric;
+static prom_gauge_t *disk_write_await_metric;
+static prom_gauge_t *disk_await_metric;
+
+/** Tamaño de un sector en /proc/diskstats, independiente del dispositivo */
+#define DISK_SECTOR_SIZE 512.0
+
+/* Metricas de Prometheus para ancho de banda y promedio de paquetes,
+ * etiquetadas por interfaz */
 static prom_gauge_t *network_bandwidth_tx_metric;
 static prom_gauge_t *network_bandwidth_rx_metric;
 static prom_gauge_t *network_packet_ratio_metric;
+static prom_gauge_t *network_packets_rx_rate_metric;
+static prom_gauge_t *network_packets_tx_rate_metric;
+static prom_gauge_t *network_rx_errors_metric;
+static prom_gauge_t *network_tx_errors_metric;
+static prom_gauge_t *network_rx_dropped_metric;
+static prom_gauge_t *network_tx_dropped_metric;
+
+/* Metricas de Prometheus del publicador del pipe */
+static prom_gauge_t *pipe_queue_depth_metric;
+static prom_gauge_t *pipe_written_metric;
+static prom_gauge_t *pipe_dropped_metric;
+static prom_gauge_t *pipe_write_latency_metric;
+static prom_gauge_t *pipe_write_latency_max_metric;
+
+/* Metricas de Prometheus del planificador, etiquetadas por recolector */
+static prom_gauge_t *scheduler_runs_metric;
+static prom_gauge_t *scheduler_overruns_metric;
+static prom_gauge_t *scheduler_jitter_metric;
+static prom_gauge_t *scheduler_jitter_max_metric;
+static prom_gauge_t *scheduler_interval_metric;
+
+/* Rankings de procesos, etiquetados por posición */
+static prom_gauge_t *proc_top_cpu_usage_metric;
+static prom_gauge_t *proc_top_cpu_pid_metric;
+static prom_gauge_t *proc_top_rss_bytes_metric;
+static prom_gauge_t *proc_top_rss_pid_metric;
+
+/* Costo del barrido de procesos */
+static prom_gauge_t *proc_top_pids_metric;
+static prom_gauge_t *proc_top_tracked_metric;
+static prom_gauge_t *proc_top_dropped_metric;
+static prom_gauge_t *proc_top_cpu_seconds_metric;
+static prom_gauge_t *proc_top_wall_seconds_metric;
+static prom_gauge_t *proc_top_memory_metric;
+
+/* Metricas de Prometheus del modo de estrés, etiquetadas por hilo y estrategia */
+static prom_gauge_t *stress_ops_metric;
+static prom_gauge_t *stress_ops_rate_metric;
+static prom_gauge_t *stress_lock_wait_metric;
+static prom_gauge_t *stress_lock_wait_ratio_metric;
+static prom_gauge_t *stress_failed_metric;
+
+/** Contadores de cada hilo en la actualización anterior, para las tasas */
+static AllocStressStats *stress_previous = NULL;
+static size_t stress_previous_count = 0;
+static long long stress_previous_ns = 0;
 
 /* Metrica de prometheus para el conteo de procesos */
 static prom_gauge_t *count_processes_metric;
@@ -35,92 +150,389 @@ static prom_gauge_t *context_switches_metric;
 static prom_gauge_t *memory_fragmentation_first_fit_metric;
 static prom_gauge_t *memory_fragmentation_best_fit_metric;
 static prom_gauge_t *memory_fragmentation_worst_fit_metric;
+static prom_gauge_t *memory_fragmentation_segregated_fit_metric;
+static prom_gauge_t *memory_fragmentation_indexed_best_fit_metric;
+
+/* Bloques libres de las políticas que llevan sus totales, por estrategia */
+static prom_gauge_t *free_bytes_metric;
+static prom_gauge_t *largest_free_block_metric;
+static prom_gauge_t *free_blocks_metric;
+static prom_gauge_t *largest_allocatable_metric;
+
+/* Histograma de tamaños de los bloques libres: un gauge acumulado por tramo,
+ * como los _bucket de un histograma, porque describe el estado actual y no
+ * observaciones acumuladas */
+static prom_gauge_t *free_block_size_metric;
+
+/** Valor de la etiqueta "le" de cada tramo de PolicyFreeStats.histogram */
+static char free_bucket_labels[POLICY_FREE_BUCKETS][SNAPSHOT_LABEL_SIZE];
 
 /* Metrics for allocation counts per strategy */
 static prom_gauge_t *first_fit_allocations_metric;
 static prom_gauge_t *best_fit_allocations_metric;
 static prom_gauge_t *worst_fit_allocations_metric;
+static prom_gauge_t *segregated_fit_allocations_metric;
+static prom_gauge_t *indexed_best_fit_allocations_metric;
+
+/**
+ * @brief Histograma de latencia de my_malloc o my_free, etiquetado por
+ * estrategia.
+ *
+ * Los tramos de alloc_latency se pliegan aquí en los buckets de Prometheus una
+ * vez por tick y las series se agregan como texto al cuerpo de exposición, así
+ * que exportar cuesta según la cantidad de buckets y no de operaciones.
+ */
+typedef struct {
+  const char *name;
+  const char *help;
+  uint64_t *counts; ///< [estrategia][bucket] sin acumular; el último es +Inf
+  double sum[ALLOC_LATENCY_STRATEGIES];
+  uint64_t total[ALLOC_LATENCY_STRATEGIES];
+} LatencyHistogram;
+
+static LatencyHistogram latency_histograms[ALLOC_OP_COUNT] = {
+    [ALLOC_OP_MALLOC] = {"allocator_malloc_latency_seconds",
+                         "Latencia de my_malloc por estrategia (segundos)"},
+    [ALLOC_OP_FREE] = {"allocator_free_latency_seconds",
+                       "Latencia de my_free por estrategia (segundos)"},
+};
+
+/** Límites superiores de los buckets, sin +Inf; comunes a ambos histogramas */
+static const double *latency_bounds = NULL;
+static size_t latency_bound_count = 0;
+
+/**
+ * @brief Cuerpo de exposición al que se agregan líneas.
+ */
+typedef struct {
+  char *data;
+  size_t length;
+  size_t capacity;
+} ExpositionText;
+
+/** Valor de la etiqueta "strategy" de cada estrategia */
+static const char *alloc_strategy_labels[ALLOC_LATENCY_STRATEGIES] = {
+    [FIRST_FIT] = "first_fit",
+    [BEST_FIT] = "best_fit",
+    [WORST_FIT] = "worst_fit",
+    [SEGREGATED_FIT] = "segregated_fit",
+    [INDEXED_BEST_FIT] = "indexed_best_fit",
+};
 
 /* Metrics for average allocation time per strategy */
 static prom_gauge_t *first_fit_avg_allocation_time_metric;
 static prom_gauge_t *best_fit_avg_allocation_time_metric;
 static prom_gauge_t *worst_fit_avg_allocation_time_metric;
+static prom_gauge_t *segregated_fit_avg_allocation_time_metric;
+static prom_gauge_t *indexed_best_fit_avg_allocation_time_metric;
+
+static long long history_now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
 
 void update_cpu_gauge() {
   double usage = get_cpu_usage();
   if (usage >= 0) {
-    pthread_mutex_lock(&lock);
-    prom_gauge_set(cpu_usage_metric, usage, NULL);
-    pthread_mutex_unlock(&lock);
+    history_ring_push(&cpu_history, history_now_ns(), usage);
   } else {
     fprintf(stderr, "Error al obtener el uso de CPU\n");
   }
 }
 
+// Reserva etiquetas e historias para los núcleos que aparecieron
+static int core_history_reserve(size_t core_count) {
+  if (core_count > core_label_count) {
+    char(*labels)[12] = realloc(core_labels, core_count * 12);
+    if (labels == NULL) {
+      fprintf(stderr, "Error al reservar las etiquetas de núcleos\n");
+      return -1;
+    }
+    for (size_t core = core_label_count; core < core_count; core++) {
+      snprintf(labels[core], sizeof(labels[core]), "%zu", core);
+    }
+    core_labels = labels;
+    core_label_count = core_count;
+  }
+
+  size_t series = core_count * CPU_CORE_MODE_COUNT;
+  if (series > core_history_count) {
+    HistoryRing *rings = realloc(core_history, series * sizeof(HistoryRing));
+    if (rings == NULL) {
+      fprintf(stderr, "Error al reservar la historia por núcleo\n");
+      return -1;
+    }
+    core_history = rings;
+    for (; core_history_count < series; core_history_count++) {
+      if (history_ring_init(&core_history[core_history_count],
+                            &history_config) != 0) {
+        fprintf(stderr, "Error al reservar la historia por núcleo\n");
+        return -1;
+      }
+    }
+  }
+  return 0;
+}
+
+void update_cpu_core_metrics() {
+  const CpuCoreUsage *usage = get_cpu_core_usage();
+
+  // Formateamos las etiquetas de los núcleos nuevos una sola vez
+  if (core_history_reserve(usage->core_count) != 0) {
+    return;
+  }
+
+  long long now = history_now_ns();
+  for (size_t core = 0; core < usage->core_count; core++) {
+    for (size_t m = 0; m < CPU_CORE_MODE_COUNT; m++) {
+      history_ring_push(&core_history[core * CPU_CORE_MODE_COUNT + m], now,
+                        usage->percent[cpu_core_modes[m].mode][core]);
+    }
+  }
+}
+
+// Exporta el último valor y los agregados de la ventana de una serie
+static void history_gauge_set(const HistoryRing *ring, prom_gauge_t *last,
+                              prom_gauge_t *min, prom_gauge_t *max,
+                              prom_gauge_t *avg, const char **labels,
+                              size_t label_count) {
+  HistoryWindow window;
+  if (history_ring_window(ring, &window) != 0) {
+    return;
+  }
+  snapshot_gauge_set(last, window.last, labels, label_count);
+  snapshot_gauge_set(min, window.min, labels, label_count);
+  snapshot_gauge_set(max, window.max, labels, label_count);
+  snapshot_gauge_set(avg, window.avg, labels, label_count);
+}
+
+void update_cpu_window_metrics() {
+  history_gauge_set(&cpu_history, cpu_usage_metric, cpu_usage_min_metric,
+                    cpu_usage_max_metric, cpu_usage_avg_metric, NULL, 0);
+
+  size_t cores = core_history_count / CPU_CORE_MODE_COUNT;
+  for (size_t core = 0; core < cores; core++) {
+    for (size_t m = 0; m < CPU_CORE_MODE_COUNT; m++) {
+      const char *labels[] = {core_labels[core], cpu_core_modes[m].label};
+      history_gauge_set(&core_history[core * CPU_CORE_MODE_COUNT + m],
+                        cpu_core_usage_metric, cpu_core_usage_min_metric,
+                        cpu_core_usage_max_metric, cpu_core_usage_avg_metric,
+                        labels, 2);
+    }
+  }
+}
+
 void update_memory_gauge() {
   double usage = get_memory_usage();
   if (usage >= 0) {
-    pthread_mutex_lock(&lock);
-    prom_gauge_set(memory_usage_metric, usage, NULL);
-    pthread_mutex_unlock(&lock);
+    snapshot_gauge_set(memory_usage_metric, usage, NULL, 0);
   } else {
     fprintf(stderr, "Error al obtener el uso de memoria\n");
   }
 }
 
 void update_disk_metrics() {
-  DiskStats stats = get_disk_stats();
-
-  // Convertir las operaciones de lectura y escritura a miles (dividir entre
-  // 1000)
-  double reads_in_thousands = stats.reads / 1000.0;
-  double writes_in_thousands = stats.writes / 1000.0;
-  // Actualizar las métricas de lectura, escritura y tiempo dedicado en
-  // Prometheus
-  pthread_mutex_lock(&lock);
-  prom_gauge_set(disk_reads_metric, (double)stats.reads, NULL);
-  prom_gauge_set(disk_writes_metric, (double)stats.writes, NULL);
-  prom_gauge_set(disk_read_time_metric, reads_in_thousands, NULL);
-  prom_gauge_set(disk_write_time_metric, writes_in_thousands, NULL);
-  pthread_mutex_unlock(&lock);
+  const DiskTable *table = get_disk_table();
+
+  // Actualizar las métricas de cada dispositivo; los tiempos de
+  // /proc/diskstats están en milisegundos y se exportan en segundos
+  for (size_t i = 0; i < table->capacity; i++) {
+    const DiskDevice *device = &table->slots[i];
+    if (!device->in_use) {
+      continue;
+    }
+
+    const DiskStats *stats = &device->stats;
+    const char *labels[] = {device->name};
+    snapshot_gauge_set(disk_reads_metric, (double)stats->reads, labels, 1);
+    snapshot_gauge_set(disk_writes_metric, (double)stats->writes, labels, 1);
+    snapshot_gauge_set(disk_read_time_metric, stats->read_time / 1000.0, labels,
+                       1);
+    snapshot_gauge_set(disk_write_time_metric, stats->write_time / 1000.0,
+                       labels, 1);
+    snapshot_gauge_set(disk_read_bytes_metric,
+                       stats->sectors_read * DISK_SECTOR_SIZE, labels, 1);
+    snapshot_gauge_set(disk_written_bytes_metric,
+                       stats->sectors_written * DISK_SECTOR_SIZE, labels, 1);
+    snapshot_gauge_set(disk_merged_reads_metric, (double)stats->reads_merged,
+                       labels, 1);
+    snapshot_gauge_set(disk_merged_writes_metric, (double)stats->writes_merged,
+                       labels, 1);
+    snapshot_gauge_set(disk_io_in_progress_metric,
+                       (double)stats->ios_in_progress, labels, 1);
+    snapshot_gauge_set(disk_io_time_metric, stats->io_ticks / 1000.0, labels,
+                       1);
+    snapshot_gauge_set(disk_io_weighted_time_metric,
+                       stats->weighted_io_time / 1000.0, labels, 1);
+    snapshot_gauge_set(disk_discards_metric, (double)stats->discards, labels,
+                       1);
+    snapshot_gauge_set(disk_discarded_bytes_metric,
+                       stats->sectors_discarded * DISK_SECTOR_SIZE, labels, 1);
+    snapshot_gauge_set(disk_discard_time_metric, stats->discard_time / 1000.0,
+                       labels, 1);
+    snapshot_gauge_set(disk_flushes_metric, (double)stats->flushes, labels, 1);
+    snapshot_gauge_set(disk_flush_time_metric, stats->flush_time / 1000.0,
+                       labels, 1);
+    snapshot_gauge_set(disk_utilization_metric, device->utilization, labels, 1);
+    snapshot_gauge_set(disk_read_await_metric, device->read_await, labels, 1);
+    snapshot_gauge_set(disk_write_await_metric, device->write_await, labels, 1);
+    snapshot_gauge_set(disk_await_metric, device->await, labels, 1);
+  }
 }
 
 void update_network_metrics() {
-  static NetStats prev_stats = {0, 0, 0,
-                                0}; // Para almacenar los valores previos
-  NetStats current_stats = get_network_stats("wlp2s0");
+  const NetTable *table = get_network_table();
+
+  for (size_t i = 0; i < table->count; i++) {
+    const NetInterface *iface = &table->interfaces[i];
+    const char *labels[] = {iface->name};
 
-  // Calcular el ancho de banda (en bytes por segundo)
-  double bandwidth_rx =
-      (double)(current_stats.bytes_received - prev_stats.bytes_received);
-  double bandwidth_tx =
-      (double)(current_stats.bytes_transmitted - prev_stats.bytes_transmitted);
+    // Calcular la relación de paquetes
+    double packet_ratio = 0;
+    if (iface->stats.packets_received > 0) {
+      packet_ratio = (double)iface->stats.packets_transmitted /
+                     (double)iface->stats.packets_received;
+    }
+
+    snapshot_gauge_set(network_bandwidth_rx_metric, iface->rx_bytes_rate,
+                       labels, 1); // Ancho de banda en recepción
+    snapshot_gauge_set(network_bandwidth_tx_metric, iface->tx_bytes_rate,
+                       labels, 1); // Ancho de banda en transmisión
+    snapshot_gauge_set(network_packet_ratio_metric, packet_ratio, labels,
+                       1); // Relación de paquetes
+    snapshot_gauge_set(network_packets_rx_rate_metric, iface->rx_packets_rate,
+                       labels, 1);
+    snapshot_gauge_set(network_packets_tx_rate_metric, iface->tx_packets_rate,
+                       labels, 1);
+    snapshot_gauge_set(network_rx_errors_metric, (double)iface->stats.rx_errors,
+                       labels, 1);
+    snapshot_gauge_set(network_tx_errors_metric, (double)iface->stats.tx_errors,
+                       labels, 1);
+    snapshot_gauge_set(network_rx_dropped_metric,
+                       (double)iface->stats.rx_dropped, labels, 1);
+    snapshot_gauge_set(network_tx_dropped_metric,
+                       (double)iface->stats.tx_dropped, labels, 1);
+  }
+}
+
+void update_pipe_metrics() {
+  MonitorPipeStats stats;
+  monitor_pipe_get_stats(&stats);
+
+  snapshot_gauge_set(pipe_queue_depth_metric, (double)stats.queue_depth, NULL,
+                     0);
+  snapshot_gauge_set(pipe_written_metric, (double)stats.written, NULL, 0);
+  snapshot_gauge_set(pipe_dropped_metric, (double)stats.dropped, NULL, 0);
+  snapshot_gauge_set(pipe_write_latency_metric, stats.last_write_seconds, NULL,
+                     0);
+  snapshot_gauge_set(pipe_write_latency_max_metric, stats.max_write_seconds,
+                     NULL, 0);
+}
+
+void update_scheduler_metrics() {
+  for (size_t i = 0; i < scheduler_task_count(); i++) {
+    SchedulerStats stats;
+    scheduler_get_stats(i, &stats);
+    const char *labels[] = {stats.name};
+    snapshot_gauge_set(scheduler_runs_metric, (double)stats.runs, labels, 1);
+    snapshot_gauge_set(scheduler_overruns_metric, (double)stats.overruns,
+                       labels, 1);
+    snapshot_gauge_set(scheduler_jitter_metric, stats.last_jitter_seconds,
+                       labels, 1);
+    snapshot_gauge_set(scheduler_jitter_max_metric, stats.max_jitter_seconds,
+                       labels, 1);
+    snapshot_gauge_set(scheduler_interval_metric, stats.interval_ms / 1000.0,
+                       labels, 1);
+  }
+}
 
-  // Calcular la relación de paquetes
-  double packet_ratio = 0;
-  if (current_stats.packets_received > 0) {
-    packet_ratio = (double)current_stats.packets_transmitted /
-                   (double)current_stats.packets_received;
+void update_proc_top_metrics() {
+  size_t size = proc_top_size();
+  if (size == 0) {
+    return;
   }
 
-  pthread_mutex_lock(&lock);
-  prom_gauge_set(network_bandwidth_rx_metric, bandwidth_rx,
-                 NULL); // Ancho de banda en recepción
-  prom_gauge_set(network_bandwidth_tx_metric, bandwidth_tx,
-                 NULL); // Ancho de banda en transmisión
-  prom_gauge_set(network_packet_ratio_metric, packet_ratio,
-                 NULL); // Relación de paquetes
-  pthread_mutex_unlock(&lock);
+  // Las posiciones sin proceso quedan en 0, para no arrastrar el valor de un
+  // barrido anterior
+  const ProcTopEntry *by_cpu, *by_rss;
+  size_t cpu_count = proc_top_by_cpu(&by_cpu);
+  size_t rss_count = proc_top_by_rss(&by_rss);
+  for (size_t i = 0; i < size; i++) {
+    char rank[16];
+    snprintf(rank, sizeof(rank), "%zu", i + 1);
+    const char *labels[] = {rank};
+    snapshot_gauge_set(proc_top_cpu_usage_metric,
+                       i < cpu_count ? by_cpu[i].cpu_usage : 0.0, labels, 1);
+    snapshot_gauge_set(proc_top_cpu_pid_metric,
+                       i < cpu_count ? (double)by_cpu[i].pid : 0.0, labels, 1);
+    snapshot_gauge_set(proc_top_rss_bytes_metric,
+                       i < rss_count ? (double)by_rss[i].rss_bytes : 0.0,
+                       labels, 1);
+    snapshot_gauge_set(proc_top_rss_pid_metric,
+                       i < rss_count ? (double)by_rss[i].pid : 0.0, labels, 1);
+  }
+
+  ProcTopStats stats;
+  proc_top_get_stats(&stats);
+  snapshot_gauge_set(proc_top_pids_metric, (double)stats.pids, NULL, 0);
+  snapshot_gauge_set(proc_top_tracked_metric, (double)stats.tracked, NULL, 0);
+  snapshot_gauge_set(proc_top_dropped_metric, (double)stats.dropped, NULL, 0);
+  snapshot_gauge_set(proc_top_cpu_seconds_metric, stats.cpu_seconds, NULL, 0);
+  snapshot_gauge_set(proc_top_wall_seconds_metric, stats.wall_seconds, NULL,
+                     0);
+  snapshot_gauge_set(proc_top_memory_metric, (double)stats.memory_bytes, NULL,
+                     0);
+}
 
-  prev_stats = current_stats;
+void update_alloc_stress_metrics() {
+  size_t count = alloc_stress_thread_count();
+  if (count == 0) {
+    return;
+  }
+  if (count != stress_previous_count) {
+    AllocStressStats *previous =
+        realloc(stress_previous, count * sizeof(AllocStressStats));
+    if (previous == NULL) {
+      return;
+    }
+    stress_previous = previous;
+    stress_previous_count = count;
+    stress_previous_ns = 0;
+  }
+
+  long long now = history_now_ns();
+  double elapsed = (double)(now - stress_previous_ns) / 1e9;
+  for (size_t i = 0; i < count; i++) {
+    AllocStressStats stats;
+    alloc_stress_get_stats(i, &stats);
+    const char *labels[] = {stats.thread, stats.strategy};
+    snapshot_gauge_set(stress_ops_metric, (double)stats.ops, labels, 2);
+    snapshot_gauge_set(stress_lock_wait_metric, stats.lock_wait_seconds,
+                       labels, 2);
+    snapshot_gauge_set(stress_failed_metric, (double)stats.failed, labels, 2);
+
+    // La primera lectura solo deja la referencia de las tasas
+    if (stress_previous_ns != 0 && elapsed > 0.0) {
+      const AllocStressStats *previous = &stress_previous[i];
+      snapshot_gauge_set(stress_ops_rate_metric,
+                         (double)(stats.ops - previous->ops) / elapsed, labels,
+                         2);
+      snapshot_gauge_set(
+          stress_lock_wait_ratio_metric,
+          (stats.lock_wait_seconds - previous->lock_wait_seconds) / elapsed,
+          labels, 2);
+    }
+    stress_previous[i] = stats;
+  }
+  stress_previous_ns = now;
 }
 
 void update_count_processes() {
   int running_processes = get_running_processes();
   if (running_processes >= 0) {
-    pthread_mutex_lock(&lock);
-    prom_gauge_set(count_processes_metric, (double)running_processes, NULL);
-    pthread_mutex_unlock(&lock);
+    snapshot_gauge_set(count_processes_metric, (double)running_processes, NULL,
+                       0);
   } else {
     fprintf(stderr, "Error al obtener el numero de procesos en ejecucion\n");
   }
@@ -135,9 +547,7 @@ void update_context_switches_metric() {
     unsigned long long diff = current_context_switches - prev_context_switches;
 
     if (diff > 0) {
-      pthread_mutex_lock(&lock);
-      prom_gauge_set(context_switches_metric, (double)diff, NULL);
-      pthread_mutex_unlock(&lock);
+      snapshot_gauge_set(context_switches_metric, (double)diff, NULL, 0);
     }
 
     prev_context_switches = current_context_switches;
@@ -146,34 +556,167 @@ void update_context_switches_metric() {
   }
 }
 
+// Suma un tramo de alloc_latency, representado por su punto medio, al primer
+// bucket cuyo límite lo alcanza
+static void fold_alloc_latency(int strategy, AllocOp op, double seconds,
+                               uint64_t count, void *ctx) {
+  (void)ctx;
+  LatencyHistogram *histogram = &latency_histograms[op];
+  if (histogram->counts == NULL) {
+    return;
+  }
+  size_t low = 0, high = latency_bound_count;
+  while (low < high) {
+    size_t mid = low + (high - low) / 2;
+    if (latency_bounds[mid] < seconds) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  histogram->counts[(size_t)strategy * (latency_bound_count + 1) + low] += count;
+  histogram->sum[strategy] += seconds * (double)count;
+  histogram->total[strategy] += count;
+}
+
+static int exposition_text_append(ExpositionText *text, const char *format,
+                                  ...) {
+  for (;;) {
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(text->data + text->length,
+                            text->capacity - text->length, format, args);
+    va_end(args);
+    if (written < 0) {
+      return -1;
+    }
+    if ((size_t)written < text->capacity - text->length) {
+      text->length += (size_t)written;
+      return 0;
+    }
+    size_t capacity = text->capacity * 2 + (size_t)written;
+    char *data = realloc(text->data, capacity);
+    if (data == NULL) {
+      return -1;
+    }
+    text->data = data;
+    text->capacity = capacity;
+  }
+}
+
+// Escribe un histograma como lo haría libprom: los _bucket acumulados, _sum y
+// _count de cada estrategia con al menos una latencia registrada
+static int append_latency_histogram(ExpositionText *text,
+                                    const LatencyHistogram *histogram) {
+  if (exposition_text_append(text, "# HELP %s %s\n# TYPE %s histogram\n",
+                             histogram->name, histogram->help,
+                             histogram->name) != 0) {
+    return -1;
+  }
+  for (int strategy = 0; strategy < ALLOC_LATENCY_STRATEGIES; strategy++) {
+    const char *label = alloc_strategy_labels[strategy];
+    if (label == NULL || histogram->total[strategy] == 0) {
+      continue;
+    }
+    const uint64_t *counts =
+        &histogram->counts[(size_t)strategy * (latency_bound_count + 1)];
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < latency_bound_count; i++) {
+      cumulative += counts[i];
+      if (exposition_text_append(
+              text, "%s_bucket{strategy=\"%s\",le=\"%.15g\"} %llu\n",
+              histogram->name, label, latency_bounds[i],
+              (unsigned long long)cumulative) != 0) {
+        return -1;
+      }
+    }
+    if (exposition_text_append(
+            text,
+            "%s_bucket{strategy=\"%s\",le=\"+Inf\"} %llu\n"
+            "%s_sum{strategy=\"%s\"} %.17g\n"
+            "%s_count{strategy=\"%s\"} %llu\n",
+            histogram->name, label,
+            (unsigned long long)histogram->total[strategy], histogram->name,
+            label, histogram->sum[strategy], histogram->name, label,
+            (unsigned long long)histogram->total[strategy]) != 0) {
+      return -1;
+    }
+  }
+  return exposition_text_append(text, "\n");
+}
+
 void *expose_metrics(void *arg) {
   (void)arg; // Argumento no utilizado
 
-  // Aseguramos que el manejador HTTP esté adjunto al registro por defecto
-  promhttp_set_active_collector_registry(NULL);
+  // Cantidad de workers HTTP, configurable con MONITOR_HTTP_THREADS
+  size_t threads = EXPOSITION_DEFAULT_THREADS;
+  const char *threads_env = getenv("MONITOR_HTTP_THREADS");
+  if (threads_env != NULL && atoi(threads_env) > 0) {
+    threads = (size_t)atoi(threads_env);
+  }
 
   // Iniciamos el servidor HTTP en el puerto 8000
-  struct MHD_Daemon *daemon =
-      promhttp_start_daemon(MHD_USE_SELECT_INTERNALLY, 8000, NULL, NULL);
-  if (daemon == NULL) {
+  if (exposition_start(8000, threads) != 0) {
     fprintf(stderr, "Error al iniciar el servidor HTTP\n");
     return NULL;
   }
 
-  // Mantenemos el servidor en ejecución
+  // Volcamos al registro cada instantánea que publica el recolector. Solo este
+  // hilo escribe en los gauges, así que el recolector nunca espera a un scrape
   while (1) {
-    sleep(1);
+    snapshot_wait();
+    const MetricsSnapshot *snapshot = snapshot_acquire();
+    if (snapshot == NULL) {
+      continue;
+    }
+
+    for (size_t i = 0; i < snapshot->count; i++) {
+      const SnapshotSample *sample = &snapshot->samples[i];
+      const char *labels[SNAPSHOT_MAX_LABELS];
+      for (size_t l = 0; l < sample->label_count; l++) {
+        labels[l] = sample->labels[l];
+      }
+      prom_gauge_set(sample->metric, sample->value,
+                     sample->label_count ? labels : NULL);
+    }
+
+    // Plegamos las latencias registradas por el asignador desde el tick
+    // anterior en los buckets de los histogramas
+    alloc_latency_collect(fold_alloc_latency, NULL);
+
+    // Formateamos la exposición una sola vez por tick; cada scrape hasta el
+    // próximo tick recibe este mismo cuerpo
+    char *body =
+        (char *)prom_collector_registry_bridge(PROM_COLLECTOR_REGISTRY_DEFAULT);
+    if (body == NULL) {
+      fprintf(stderr, "Error al formatear las métricas\n");
+      continue;
+    }
+
+    // Los histogramas de latencia no pasan por el registro: se agregan al
+    // final del cuerpo ya formateado
+    size_t registry_length = strlen(body);
+    ExpositionText text = {body, registry_length, registry_length + 1};
+    for (int op = 0; op < ALLOC_OP_COUNT && latency_bounds != NULL; op++) {
+      if (append_latency_histogram(&text, &latency_histograms[op]) != 0) {
+        fprintf(stderr, "Error al formatear los histogramas de latencia\n");
+        text.length = registry_length;
+        text.data[registry_length] = '\0';
+        break;
+      }
+    }
+    exposition_publish(text.data, text.length);
   }
 
   // Nunca debería llegar aquí
-  MHD_stop_daemon(daemon);
+  exposition_stop();
   return NULL;
 }
 
 void init_metrics() {
-  // Inicializamos el mutex
-  if (pthread_mutex_init(&lock, NULL) != 0) {
-    fprintf(stderr, "Error al inicializar el mutex\n");
+  // Inicializamos el intercambio de instantáneas con el hilo exportador
+  if (snapshot_init() != 0) {
+    fprintf(stderr, "Error al inicializar las instantáneas de métricas\n");
   }
 
   // Inicializamos el registro de coleccionistas de Prometheus
@@ -193,6 +736,21 @@ void init_metrics() {
     fprintf(stderr, "Error al registrar las métricas de CPU\n");
   }
 
+  // Creamos la métrica para el uso por núcleo, etiquetada por núcleo y modo
+  const char *cpu_core_labels[] = {"core", "mode"};
+  cpu_core_usage_metric = prom_gauge_new(
+      "cpu_core_usage_percentage",
+      "Porcentaje de uso de CPU por núcleo y modo", 2, cpu_core_labels);
+  if (cpu_core_usage_metric == NULL) {
+    fprintf(stderr, "Error al crear la métrica de uso de CPU por núcleo\n");
+  }
+
+  // Registramos la métrica de CPU por núcleo
+  if (prom_collector_registry_must_register_metric(cpu_core_usage_metric) !=
+      0) {
+    fprintf(stderr, "Error al registrar las métricas de CPU por núcleo\n");
+  }
+
   // Creamos la métrica para el uso de memoria
   memory_usage_metric = prom_gauge_new("memory_usage_percentage",
                                        "Porcentaje de uso de memoria", 0, NULL);
@@ -224,6 +782,52 @@ void init_metrics() {
   prom_collector_registry_must_register_metric(
       memory_fragmentation_worst_fit_metric);
 
+  memory_fragmentation_segregated_fit_metric = prom_gauge_new(
+      "memory_fragmentation_rate_segregated_fit",
+      "Memory fragmentation rate (%) for Segregated Fit", 0, NULL);
+  prom_collector_registry_must_register_metric(
+      memory_fragmentation_segregated_fit_metric);
+
+  memory_fragmentation_indexed_best_fit_metric = prom_gauge_new(
+      "memory_fragmentation_rate_indexed_best_fit",
+      "Memory fragmentation rate (%) for Indexed Best Fit", 0, NULL);
+  prom_collector_registry_must_register_metric(
+      memory_fragmentation_indexed_best_fit_metric);
+
+  static const char *strategy_labels[] = {"strategy"};
+  const struct {
+    prom_gauge_t **metric;
+    const char *name;
+    const char *help;
+  } free_metrics[] = {
+      {&free_bytes_metric, "allocator_free_bytes",
+       "Bytes en bloques libres de la estrategia"},
+      {&largest_free_block_metric, "allocator_largest_free_block_bytes",
+       "Mayor bloque libre de la estrategia (bytes)"},
+      {&free_blocks_metric, "allocator_free_blocks",
+       "Bloques libres de la estrategia"},
+      {&largest_allocatable_metric, "allocator_largest_allocatable_bytes",
+       "Mayor pedido que la estrategia sirve sin pedir más memoria (bytes)"},
+  };
+  for (size_t i = 0; i < sizeof(free_metrics) / sizeof(free_metrics[0]);
+       i++) {
+    *free_metrics[i].metric = prom_gauge_new(
+        free_metrics[i].name, free_metrics[i].help, 1, strategy_labels);
+    prom_collector_registry_must_register_metric(*free_metrics[i].metric);
+  }
+
+  static const char *bucket_labels[] = {"strategy", "le"};
+  free_block_size_metric = prom_gauge_new(
+      "allocator_free_block_size_bucket",
+      "Bloques libres de la estrategia de hasta le bytes", 2, bucket_labels);
+  prom_collector_registry_must_register_metric(free_block_size_metric);
+  for (size_t i = 0; i < POLICY_FREE_BUCKETS - 1; i++) {
+    snprintf(free_bucket_labels[i], SNAPSHOT_LABEL_SIZE, "%lu",
+             1UL << (i + POLICY_FREE_MIN_SHIFT));
+  }
+  snprintf(free_bucket_labels[POLICY_FREE_BUCKETS - 1], SNAPSHOT_LABEL_SIZE,
+           "+Inf");
+
   // Initialize allocation counts metrics
   first_fit_allocations_metric =
       prom_gauge_new("first_fit_allocations_total",
@@ -240,6 +844,18 @@ void init_metrics() {
                      "Total allocations using Worst Fit", 0, NULL);
   prom_collector_registry_must_register_metric(worst_fit_allocations_metric);
 
+  segregated_fit_allocations_metric =
+      prom_gauge_new("segregated_fit_allocations_total",
+                     "Total allocations using Segregated Fit", 0, NULL);
+  prom_collector_registry_must_register_metric(
+      segregated_fit_allocations_metric);
+
+  indexed_best_fit_allocations_metric =
+      prom_gauge_new("indexed_best_fit_allocations_total",
+                     "Total allocations using Indexed Best Fit", 0, NULL);
+  prom_collector_registry_must_register_metric(
+      indexed_best_fit_allocations_metric);
+
   // Initialize average allocation time metrics
   first_fit_avg_allocation_time_metric = prom_gauge_new(
       "first_fit_avg_allocation_time",
@@ -258,90 +874,388 @@ void init_metrics() {
       "Average allocation time for Worst Fit (seconds)", 0, NULL);
   prom_collector_registry_must_register_metric(
       worst_fit_avg_allocation_time_metric);
+
+  segregated_fit_avg_allocation_time_metric = prom_gauge_new(
+      "segregated_fit_avg_allocation_time",
+      "Average allocation time for Segregated Fit (seconds)", 0, NULL);
+  prom_collector_registry_must_register_metric(
+      segregated_fit_avg_allocation_time_metric);
+
+  indexed_best_fit_avg_allocation_time_metric = prom_gauge_new(
+      "indexed_best_fit_avg_allocation_time",
+      "Average allocation time for Indexed Best Fit (seconds)", 0, NULL);
+  prom_collector_registry_must_register_metric(
+      indexed_best_fit_avg_allocation_time_metric);
 }
 
 void init_disk_metrics() {
-  // Creamos la métrica para operaciones de lectura en disco
-  disk_reads_metric = prom_gauge_new(
-      "disk_reads_operations",
-      "Número de operaciones de lectura en el disco (en miles)", 0, NULL);
-  if (disk_reads_metric == NULL) {
-    fprintf(stderr,
-            "Error al crear la métrica de operaciones de lectura de disco\n");
+  // Todas las métricas de disco llevan la etiqueta "device"
+  static const char *disk_labels[] = {"device"};
+  const struct {
+    prom_gauge_t **metric;
+    const char *name;
+    const char *help;
+  } disk_metrics[] = {
+      {&disk_reads_metric, "disk_reads_operations",
+       "Número de operaciones de lectura completadas"},
+      {&disk_writes_metric, "disk_writes_operations",
+       "Número de operaciones de escritura completadas"},
+      {&disk_read_time_metric, "disk_read_time",
+       "Tiempo dedicado a operaciones de lectura (segundos)"},
+      {&disk_write_time_metric, "disk_write_time",
+       "Tiempo dedicado a operaciones de escritura (segundos)"},
+      {&disk_read_bytes_metric, "disk_read_bytes", "Bytes leídos del disco"},
+      {&disk_written_bytes_metric, "disk_written_bytes",
+       "Bytes escritos en el disco"},
+      {&disk_merged_reads_metric, "disk_reads_merged",
+       "Lecturas fusionadas con otras adyacentes"},
+      {&disk_merged_writes_metric, "disk_writes_merged",
+       "Escrituras fusionadas con otras adyacentes"},
+      {&disk_io_in_progress_metric, "disk_io_in_progress",
+       "Operaciones de E/S en curso"},
+      {&disk_io_time_metric, "disk_io_time",
+       "Tiempo con al menos una operación de E/S en curso (segundos)"},
+      {&disk_io_weighted_time_metric, "disk_io_weighted_time",
+       "Tiempo de E/S ponderado por operaciones en curso (segundos)"},
+      {&disk_discards_metric, "disk_discards_operations",
+       "Número de descartes completados"},
+      {&disk_discarded_bytes_metric, "disk_discarded_bytes",
+       "Bytes descartados"},
+      {&disk_discard_time_metric, "disk_discard_time",
+       "Tiempo dedicado a descartes (segundos)"},
+      {&disk_flushes_metric, "disk_flushes_operations",
+       "Número de flushes completados"},
+      {&disk_flush_time_metric, "disk_flush_time",
+       "Tiempo dedicado a flushes (segundos)"},
+      {&disk_utilization_metric, "disk_utilization_percentage",
+       "Porcentaje del último intervalo con E/S en curso"},
+      {&disk_read_await_metric, "disk_read_await_ms",
+       "Tiempo medio por lectura en el último intervalo (ms)"},
+      {&disk_write_await_metric, "disk_write_await_ms",
+       "Tiempo medio por escritura en el último intervalo (ms)"},
+      {&disk_await_metric, "disk_await_ms",
+       "Tiempo medio por operación en el último intervalo (ms)"},
+  };
+
+  for (size_t i = 0; i < sizeof(disk_metrics) / sizeof(disk_metrics[0]); i++) {
+    // Creamos la métrica de disco
+    *disk_metrics[i].metric = prom_gauge_new(
+        disk_metrics[i].name, disk_metrics[i].help, 1, disk_labels);
+    if (*disk_metrics[i].metric == NULL) {
+      fprintf(stderr, "Error al crear la métrica de disco %s\n",
+              disk_metrics[i].name);
+      continue;
+    }
+
+    // Registramos la métrica de disco
+    if (prom_collector_registry_must_register_metric(
+            *disk_metrics[i].metric) != 0) {
+      fprintf(stderr, "Error al registrar la métrica de disco %s\n",
+              disk_metrics[i].name);
+    }
+  }
+}
+
+void init_network_metrics() {
+  // Todas las métricas de red llevan la etiqueta "interface"
+  static const char *network_labels[] = {"interface"};
+  const struct {
+    prom_gauge_t **metric;
+    const char *name;
+    const char *help;
+  } network_metrics[] = {
+      {&network_bandwidth_rx_metric, "network_bandwidth_receive",
+       "Ancho de banda de recepción (bytes/segundo)"},
+      {&network_bandwidth_tx_metric, "network_bandwidth_transmit",
+       "Ancho de banda de transmisión (bytes/segundo)"},
+      {&network_packet_ratio_metric, "network_packet_ratio",
+       "Relación de paquetes transmitidos/recibidos"},
+      {&network_packets_rx_rate_metric, "network_packets_receive_rate",
+       "Paquetes recibidos por segundo"},
+      {&network_packets_tx_rate_metric, "network_packets_transmit_rate",
+       "Paquetes transmitidos por segundo"},
+      {&network_rx_errors_metric, "network_receive_errors",
+       "Errores de recepción acumulados"},
+      {&network_tx_errors_metric, "network_transmit_errors",
+       "Errores de transmisión acumulados"},
+      {&network_rx_dropped_metric, "network_receive_dropped",
+       "Paquetes recibidos descartados acumulados"},
+      {&network_tx_dropped_metric, "network_transmit_dropped",
+       "Paquetes a transmitir descartados acumulados"},
+  };
+
+  // Creamos y registramos las métricas en el registro por defecto
+  for (size_t i = 0; i < sizeof(network_metrics) / sizeof(network_metrics[0]);
+       i++) {
+    *network_metrics[i].metric = prom_gauge_new(
+        network_metrics[i].name, network_metrics[i].help, 1, network_labels);
+    if (*network_metrics[i].metric == NULL) {
+      fprintf(stderr, "Error al crear la métrica de red %s\n",
+              network_metrics[i].name);
+      continue;
+    }
+    prom_collector_registry_must_register_metric(*network_metrics[i].metric);
   }
+}
 
-  // Registramos la métrica de lectura de disco
-  if (prom_collector_registry_must_register_metric(disk_reads_metric) != 0) {
-    fprintf(
-        stderr,
-        "Error al registrar las métricas de operaciones de lectura de disco\n");
+void init_pipe_metrics() {
+  const struct {
+    prom_gauge_t **metric;
+    const char *name;
+    const char *help;
+  } pipe_metrics[] = {
+      {&pipe_queue_depth_metric, "monitor_pipe_queue_depth",
+       "Registros esperando ser escritos en el pipe"},
+      {&pipe_written_metric, "monitor_pipe_written_records",
+       "Registros escritos en el pipe desde el inicio"},
+      {&pipe_dropped_metric, "monitor_pipe_dropped_records",
+       "Registros descartados por desborde o error desde el inicio"},
+      {&pipe_write_latency_metric, "monitor_pipe_write_seconds",
+       "Duración de la última escritura en el pipe (segundos)"},
+      {&pipe_write_latency_max_metric, "monitor_pipe_write_max_seconds",
+       "Mayor duración de escritura desde el tick anterior (segundos)"},
+  };
+
+  for (size_t i = 0; i < sizeof(pipe_metrics) / sizeof(pipe_metrics[0]); i++) {
+    *pipe_metrics[i].metric =
+        prom_gauge_new(pipe_metrics[i].name, pipe_metrics[i].help, 0, NULL);
+    if (*pipe_metrics[i].metric == NULL) {
+      fprintf(stderr, "Error al crear la métrica del pipe %s\n",
+              pipe_metrics[i].name);
+      continue;
+    }
+    prom_collector_registry_must_register_metric(*pipe_metrics[i].metric);
   }
+}
 
-  // Creamos la métrica para operaciones de escritura en disco
-  disk_writes_metric = prom_gauge_new(
-      "disk_writes_operations",
-      "Número de operaciones de escritura en el disco (en miles)", 0, NULL);
-  if (disk_writes_metric == NULL) {
-    fprintf(stderr,
-            "Error al crear la métrica de operaciones de escritura de disco\n");
+void init_history_metrics() {
+  history_config_from_env(&history_config);
+  if (history_ring_init(&cpu_history, &history_config) != 0) {
+    fprintf(stderr, "Error al reservar la historia de CPU\n");
   }
 
-  // Registramos la métrica de escritura de disco
-  if (prom_collector_registry_must_register_metric(disk_writes_metric) != 0) {
-    fprintf(stderr, "Error al registrar las métricas de operaciones de "
-                    "escritura de disco\n");
+  static const char *cpu_core_labels[] = {"core", "mode"};
+  const struct {
+    prom_gauge_t **metric;
+    const char *name;
+    const char *help;
+    size_t label_count;
+  } history_metrics[] = {
+      {&cpu_usage_min_metric, "cpu_usage_percentage_min",
+       "Mínimo del uso de CPU en la ventana de historia", 0},
+      {&cpu_usage_max_metric, "cpu_usage_percentage_max",
+       "Máximo del uso de CPU en la ventana de historia", 0},
+      {&cpu_usage_avg_metric, "cpu_usage_percentage_avg",
+       "Promedio del uso de CPU en la ventana de historia", 0},
+      {&cpu_core_usage_min_metric, "cpu_core_usage_percentage_min",
+       "Mínimo del uso por núcleo y modo en la ventana de historia", 2},
+      {&cpu_core_usage_max_metric, "cpu_core_usage_percentage_max",
+       "Máximo del uso por núcleo y modo en la ventana de historia", 2},
+      {&cpu_core_usage_avg_metric, "cpu_core_usage_percentage_avg",
+       "Promedio del uso por núcleo y modo en la ventana de historia", 2},
+  };
+
+  for (size_t i = 0; i < sizeof(history_metrics) / sizeof(history_metrics[0]);
+       i++) {
+    *history_metrics[i].metric = prom_gauge_new(
+        history_metrics[i].name, history_metrics[i].help,
+        history_metrics[i].label_count,
+        history_metrics[i].label_count ? cpu_core_labels : NULL);
+    if (*history_metrics[i].metric == NULL) {
+      fprintf(stderr, "Error al crear la métrica de historia %s\n",
+              history_metrics[i].name);
+      continue;
+    }
+    prom_collector_registry_must_register_metric(*history_metrics[i].metric);
   }
+}
 
-  // Creamos la métrica para el tiempo dedicado a operaciones de lectura
-  disk_read_time_metric = prom_gauge_new(
-      "disk_read_time", "Tiempo dedicado a operaciones de lectura (segundos)",
-      0, NULL);
-  if (disk_read_time_metric == NULL) {
-    fprintf(stderr,
-            "Error al crear la métrica de tiempo de lectura de disco\n");
+// Lee MONITOR_ALLOC_BUCKETS: "exponential:inicio,factor,cantidad",
+// "linear:inicio,ancho,cantidad" o una lista creciente de límites en segundos
+static prom_histogram_buckets_t *alloc_latency_buckets_from_env(void) {
+  const char *spec = getenv("MONITOR_ALLOC_BUCKETS");
+  double start, step;
+  unsigned int count;
+
+  if (spec == NULL) {
+    return prom_histogram_buckets_exponential(
+        ALLOC_LATENCY_DEFAULT_BUCKET_START, ALLOC_LATENCY_DEFAULT_BUCKET_FACTOR,
+        ALLOC_LATENCY_DEFAULT_BUCKET_COUNT);
+  }
+  if (sscanf(spec, "exponential:%lf,%lf,%u", &start, &step, &count) == 3 &&
+      start > 0.0 && step > 1.0 && count > 0) {
+    return prom_histogram_buckets_exponential(start, step, count);
+  }
+  if (sscanf(spec, "linear:%lf,%lf,%u", &start, &step, &count) == 3 &&
+      step > 0.0 && count > 0) {
+    return prom_histogram_buckets_linear(start, step, count);
   }
 
-  // Registramos la métrica de tiempo de lectura de disco
-  if (prom_collector_registry_must_register_metric(disk_read_time_metric) !=
-      0) {
-    fprintf(stderr,
-            "Error al registrar las métricas de tiempo de lectura de disco\n");
+  // Lista explícita: se arma la estructura pública de libprom
+  size_t capacity = 1;
+  for (const char *c = spec; *c; c++) {
+    capacity += *c == ',';
+  }
+  double *bounds = malloc(capacity * sizeof(double));
+  prom_histogram_buckets_t *buckets = malloc(sizeof(*buckets));
+  size_t parsed = 0;
+  const char *cursor = spec;
+  while (bounds != NULL && parsed < capacity) {
+    char *end;
+    double bound = strtod(cursor, &end);
+    if (end == cursor || (parsed > 0 && bound <= bounds[parsed - 1])) {
+      break;
+    }
+    bounds[parsed++] = bound;
+    if (*end != ',') {
+      cursor = end;
+      break;
+    }
+    cursor = end + 1;
+  }
+  if (bounds == NULL || buckets == NULL || parsed != capacity ||
+      *cursor != '\0') {
+    fprintf(stderr, "Buckets de latencia inválidos: %s\n", spec);
+    free(bounds);
+    free(buckets);
+    return prom_histogram_buckets_exponential(
+        ALLOC_LATENCY_DEFAULT_BUCKET_START, ALLOC_LATENCY_DEFAULT_BUCKET_FACTOR,
+        ALLOC_LATENCY_DEFAULT_BUCKET_COUNT);
   }
+  buckets->count = (int)parsed;
+  buckets->upper_bounds = bounds;
+  return buckets;
+}
 
-  // Creamos la métrica para el tiempo dedicado a operaciones de escritura
-  disk_write_time_metric = prom_gauge_new(
-      "disk_write_time",
-      "Tiempo dedicado a operaciones de escritura (segundos)", 0, NULL);
-  if (disk_write_time_metric == NULL) {
-    fprintf(stderr,
-            "Error al crear la métrica de tiempo de escritura de disco\n");
+void init_alloc_latency_metrics() {
+  prom_histogram_buckets_t *buckets = alloc_latency_buckets_from_env();
+  if (buckets == NULL) {
+    fprintf(stderr, "Error al crear los histogramas de latencia\n");
+    return;
   }
 
-  // Registramos la métrica de tiempo de escritura de disco
-  if (prom_collector_registry_must_register_metric(disk_write_time_metric) !=
-      0) {
-    fprintf(
-        stderr,
-        "Error al registrar las métricas de tiempo de escritura de disco\n");
+  for (int op = 0; op < ALLOC_OP_COUNT; op++) {
+    latency_histograms[op].counts =
+        calloc(ALLOC_LATENCY_STRATEGIES * ((size_t)buckets->count + 1),
+               sizeof(uint64_t));
+    if (latency_histograms[op].counts == NULL) {
+      fprintf(stderr, "Error al crear los histogramas de latencia\n");
+      return;
+    }
   }
+  latency_bounds = buckets->upper_bounds;
+  latency_bound_count = (size_t)buckets->count;
 }
 
-void init_network_metrics() {
-  // Creamos las métricas para el ancho de banda
-  network_bandwidth_rx_metric =
-      prom_gauge_new("network_bandwidth_receive",
-                     "Ancho de banda de recepción (bytes/segundo)", 0, NULL);
-  network_bandwidth_tx_metric =
-      prom_gauge_new("network_bandwidth_transmit",
-                     "Ancho de banda de transmisión (bytes/segundo)", 0, NULL);
-  network_packet_ratio_metric =
-      prom_gauge_new("network_packet_ratio",
-                     "Relación de paquetes transmitidos/recibidos", 0, NULL);
-
-  // Registramos las métricas en el registro por defecto
-  prom_collector_registry_must_register_metric(network_bandwidth_rx_metric);
-  prom_collector_registry_must_register_metric(network_bandwidth_tx_metric);
-  prom_collector_registry_must_register_metric(network_packet_ratio_metric);
+void init_alloc_stress_metrics() {
+  static const char *stress_labels[] = {"thread", "strategy"};
+  const struct {
+    prom_gauge_t **metric;
+    const char *name;
+    const char *help;
+  } stress_metrics[] = {
+      {&stress_ops_metric, "allocator_stress_ops_total",
+       "Operaciones del hilo de estrés desde el inicio"},
+      {&stress_ops_rate_metric, "allocator_stress_ops_per_second",
+       "Operaciones por segundo del hilo de estrés"},
+      {&stress_lock_wait_metric, "allocator_stress_lock_wait_seconds_total",
+       "Espera acumulada del mutex del asignador (segundos)"},
+      {&stress_lock_wait_ratio_metric, "allocator_stress_lock_wait_ratio",
+       "Fracción del último intervalo esperando el mutex del asignador"},
+      {&stress_failed_metric, "allocator_stress_failed_allocations_total",
+       "my_malloc del hilo de estrés que devolvieron NULL"},
+  };
+
+  for (size_t i = 0; i < sizeof(stress_metrics) / sizeof(stress_metrics[0]);
+       i++) {
+    *stress_metrics[i].metric = prom_gauge_new(
+        stress_metrics[i].name, stress_metrics[i].help, 2, stress_labels);
+    if (*stress_metrics[i].metric == NULL) {
+      fprintf(stderr, "Error al crear la métrica de estrés %s\n",
+              stress_metrics[i].name);
+      continue;
+    }
+    prom_collector_registry_must_register_metric(*stress_metrics[i].metric);
+  }
+}
+
+void init_scheduler_metrics() {
+  static const char *scheduler_labels[] = {"collector"};
+  const struct {
+    prom_gauge_t **metric;
+    const char *name;
+    const char *help;
+  } scheduler_metrics[] = {
+      {&scheduler_runs_metric, "monitor_scheduler_runs",
+       "Ejecuciones del recolector desde el inicio"},
+      {&scheduler_overruns_metric, "monitor_scheduler_overruns",
+       "Vencimientos perdidos por el recolector desde el inicio"},
+      {&scheduler_jitter_metric, "monitor_scheduler_jitter_seconds",
+       "Retraso de la última ejecución respecto de su vencimiento (segundos)"},
+      {&scheduler_jitter_max_metric, "monitor_scheduler_jitter_max_seconds",
+       "Mayor retraso desde la publicación anterior (segundos)"},
+      {&scheduler_interval_metric, "monitor_scheduler_interval_seconds",
+       "Intervalo configurado del recolector (segundos)"},
+  };
+
+  for (size_t i = 0;
+       i < sizeof(scheduler_metrics) / sizeof(scheduler_metrics[0]); i++) {
+    *scheduler_metrics[i].metric =
+        prom_gauge_new(scheduler_metrics[i].name, scheduler_metrics[i].help, 1,
+                       scheduler_labels);
+    if (*scheduler_metrics[i].metric == NULL) {
+      fprintf(stderr, "Error al crear la métrica del planificador %s\n",
+              scheduler_metrics[i].name);
+      continue;
+    }
+    prom_collector_registry_must_register_metric(
+        *scheduler_metrics[i].metric);
+  }
+}
+
+void init_proc_top_metrics() {
+  static const char *rank_labels[] = {"rank"};
+  const struct {
+    prom_gauge_t **metric;
+    const char *name;
+    const char *help;
+    size_t label_count;
+  } proc_top_metrics[] = {
+      {&proc_top_cpu_usage_metric, "process_top_cpu_usage",
+       "Segundos de CPU por segundo del proceso en esa posición", 1},
+      {&proc_top_cpu_pid_metric, "process_top_cpu_pid",
+       "Pid del proceso en esa posición por uso de CPU", 1},
+      {&proc_top_rss_bytes_metric, "process_top_rss_bytes",
+       "Memoria residente del proceso en esa posición (bytes)", 1},
+      {&proc_top_rss_pid_metric, "process_top_rss_pid",
+       "Pid del proceso en esa posición por memoria residente", 1},
+      {&proc_top_pids_metric, "process_scan_pids",
+       "Procesos encontrados en el último barrido", 0},
+      {&proc_top_tracked_metric, "process_scan_tracked_pids",
+       "Procesos seguidos en la tabla", 0},
+      {&proc_top_dropped_metric, "process_scan_dropped_pids",
+       "Procesos nuevos que no se leyeron por tabla llena", 0},
+      {&proc_top_cpu_seconds_metric, "process_scan_cpu_seconds",
+       "Tiempo de CPU del último barrido (segundos)", 0},
+      {&proc_top_wall_seconds_metric, "process_scan_duration_seconds",
+       "Duración del último barrido (segundos)", 0},
+      {&proc_top_memory_metric, "process_scan_memory_bytes",
+       "Memoria reservada por el recolector de procesos (bytes)", 0},
+  };
+
+  for (size_t i = 0;
+       i < sizeof(proc_top_metrics) / sizeof(proc_top_metrics[0]); i++) {
+    *proc_top_metrics[i].metric = prom_gauge_new(
+        proc_top_metrics[i].name, proc_top_metrics[i].help,
+        proc_top_metrics[i].label_count,
+        proc_top_metrics[i].label_count ? rank_labels : NULL);
+    if (*proc_top_metrics[i].metric == NULL) {
+      fprintf(stderr, "Error al crear la métrica de procesos %s\n",
+              proc_top_metrics[i].name);
+      continue;
+    }
+    prom_collector_registry_must_register_metric(*proc_top_metrics[i].metric);
+  }
 }
 
 void init_count_processes() {
@@ -374,29 +1288,63 @@ void init_context_switches_metric() {
   }
 }
 
-void destroy_mutex() { pthread_mutex_destroy(&lock); }
-
 void update_memory_fragmentation_metric() {
-  double fragmentation_rates[3] = {0.0, 0.0, 0.0};
-  calculate_fragmentation_per_method(fragmentation_rates);
-
-  pthread_mutex_lock(&lock);
-  prom_gauge_set(memory_fragmentation_first_fit_metric,
-                 fragmentation_rates[FIRST_FIT], NULL);
-  prom_gauge_set(memory_fragmentation_best_fit_metric,
-                 fragmentation_rates[BEST_FIT], NULL);
-  prom_gauge_set(memory_fragmentation_worst_fit_metric,
-                 fragmentation_rates[WORST_FIT], NULL);
-  pthread_mutex_unlock(&lock);
+  double fragmentation_rates[ALLOC_POLICY_COUNT] = {0.0};
+  policy_fragmentation(fragmentation_rates);
+
+  snapshot_gauge_set(memory_fragmentation_first_fit_metric,
+                     fragmentation_rates[FIRST_FIT], NULL, 0);
+  snapshot_gauge_set(memory_fragmentation_best_fit_metric,
+                     fragmentation_rates[BEST_FIT], NULL, 0);
+  snapshot_gauge_set(memory_fragmentation_worst_fit_metric,
+                     fragmentation_rates[WORST_FIT], NULL, 0);
+  snapshot_gauge_set(memory_fragmentation_segregated_fit_metric,
+                     fragmentation_rates[SEGREGATED_FIT], NULL, 0);
+  snapshot_gauge_set(memory_fragmentation_indexed_best_fit_metric,
+                     fragmentation_rates[INDEXED_BEST_FIT], NULL, 0);
+
+  // Solo las políticas propias llevan estos totales; memory.h no los expone
+  for (int policy = 0; policy < ALLOC_POLICY_COUNT; policy++) {
+    PolicyFreeStats free_stats;
+    if (policy_free_stats(policy, &free_stats) != 0) {
+      continue;
+    }
+    const char *labels[] = {alloc_strategy_labels[policy]};
+    snapshot_gauge_set(free_bytes_metric, (double)free_stats.free_bytes,
+                       labels, 1);
+    snapshot_gauge_set(largest_free_block_metric,
+                       (double)free_stats.largest_free_block, labels, 1);
+    snapshot_gauge_set(free_blocks_metric, (double)free_stats.free_blocks,
+                       labels, 1);
+    snapshot_gauge_set(largest_allocatable_metric,
+                       (double)free_stats.largest_allocatable, labels, 1);
+
+    size_t cumulative = 0;
+    for (size_t i = 0; i < POLICY_FREE_BUCKETS; i++) {
+      cumulative += free_stats.histogram[i];
+      const char *bucket[] = {labels[0], free_bucket_labels[i]};
+      snapshot_gauge_set(free_block_size_metric, (double)cumulative, bucket,
+                         2);
+    }
+  }
 }
 
 void update_allocation_policy_metrics() {
-  pthread_mutex_lock(&lock);
-
   // Update allocation counts
-  prom_gauge_set(first_fit_allocations_metric, (double)first_fit_count, NULL);
-  prom_gauge_set(best_fit_allocations_metric, (double)best_fit_count, NULL);
-  prom_gauge_set(worst_fit_allocations_metric, (double)worst_fit_count, NULL);
+  snapshot_gauge_set(first_fit_allocations_metric, (double)first_fit_count,
+                     NULL, 0);
+  snapshot_gauge_set(best_fit_allocations_metric, (double)best_fit_count, NULL,
+                     0);
+  snapshot_gauge_set(worst_fit_allocations_metric, (double)worst_fit_count,
+                     NULL, 0);
+  SegregatedStats segregated;
+  segregated_get_stats(&segregated);
+  snapshot_gauge_set(segregated_fit_allocations_metric,
+                     (double)segregated.allocations, NULL, 0);
+  IndexedStats indexed;
+  indexed_get_stats(&indexed);
+  snapshot_gauge_set(indexed_best_fit_allocations_metric,
+                     (double)indexed.allocations, NULL, 0);
 
   // Calculate average allocation times
   double first_fit_avg_time =
@@ -413,11 +1361,20 @@ void update_allocation_policy_metrics() {
           : 0.0;
 
   // Update average allocation time metrics
-  prom_gauge_set(first_fit_avg_allocation_time_metric, first_fit_avg_time,
-                 NULL);
-  prom_gauge_set(best_fit_avg_allocation_time_metric, best_fit_avg_time, NULL);
-  prom_gauge_set(worst_fit_avg_allocation_time_metric, worst_fit_avg_time,
-                 NULL);
-
-  pthread_mutex_unlock(&lock);
+  snapshot_gauge_set(first_fit_avg_allocation_time_metric, first_fit_avg_time,
+                     NULL, 0);
+  snapshot_gauge_set(best_fit_avg_allocation_time_metric, best_fit_avg_time,
+                     NULL, 0);
+  snapshot_gauge_set(worst_fit_avg_allocation_time_metric, worst_fit_avg_time,
+                     NULL, 0);
+  snapshot_gauge_set(segregated_fit_avg_allocation_time_metric,
+                     segregated.allocations > 0
+                         ? segregated.allocation_time / segregated.allocations
+                         : 0.0,
+                     NULL, 0);
+  snapshot_gauge_set(indexed_best_fit_avg_allocation_time_metric,
+                     indexed.allocations > 0
+                         ? indexed.allocation_time / indexed.allocations
+                         : 0.0,
+                     NULL, 0);
 }
@@ -0,0 +1,420 @@
+#include "../include/exposition.h"
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <zlib.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+// A partir de 0.9.71 los manejadores devuelven enum MHD_Result
+#if MHD_VERSION >= 0x00097002
+typedef enum MHD_Result MhdResult;
+#else
+typedef int MhdResult;
+#endif
+
+#define EXPOSITION_CONTENT_TYPE "text/plain; version=0.0.4; charset=utf-8"
+
+// Niveles de compresión: se comprime una vez por tick, fuera del camino de
+// los scrapes, así que priorizamos el tamaño sin llegar a los niveles lentos
+#define EXPOSITION_GZIP_LEVEL 6
+#define EXPOSITION_ZSTD_LEVEL 3
+
+/**
+ * @brief Codificaciones en las que se ofrece el cuerpo.
+ */
+typedef enum {
+  EXPOSITION_IDENTITY, ///< Texto sin comprimir
+  EXPOSITION_GZIP,     ///< gzip
+  EXPOSITION_ZSTD,     ///< zstd (solo si se compiló con HAVE_ZSTD)
+  EXPOSITION_ENCODING_COUNT
+} ExpositionEncoding;
+
+/** Valor de Content-Encoding de cada codificación */
+static const char *const encoding_names[EXPOSITION_ENCODING_COUNT] = {
+    [EXPOSITION_IDENTITY] = NULL,
+    [EXPOSITION_GZIP] = "gzip",
+    [EXPOSITION_ZSTD] = "zstd",
+};
+
+/**
+ * @brief Contenido del cuerpo en una codificación.
+ */
+typedef struct {
+  char *data;    ///< Contenido reservado con malloc, o NULL si no está
+  size_t length; ///< Longitud en bytes
+} ExpositionVariant;
+
+/**
+ * @brief Cuerpo de exposición de un tick, compartido por todos los workers.
+ *
+ * Lleva el texto y sus versiones comprimidas, generadas una sola vez al
+ * publicarlo. Lo mantiene vivo una referencia del publicador mientras es el
+ * vigente y una por cada respuesta de MHD construida sobre él.
+ */
+typedef struct {
+  ExpositionVariant variants[EXPOSITION_ENCODING_COUNT]; ///< Por codificación
+  atomic_uint refs;                                      ///< Referencias vivas
+} ExpositionBody;
+
+/**
+ * @brief Worker del exportador: un daemon de MHD con su propio socket.
+ */
+typedef struct {
+  struct MHD_Daemon *daemon; ///< Daemon con su hilo de epoll
+  ExpositionBody *body;      ///< Cuerpo sobre el que se construyeron responses
+  struct MHD_Response
+      *responses[EXPOSITION_ENCODING_COUNT]; ///< Respuestas vigentes
+} ExpositionWorker;
+
+/** Cuerpo vigente */
+static _Atomic(ExpositionBody *) current = NULL;
+
+/** Workers que están tomando una referencia sobre current */
+static atomic_uint acquiring = 0;
+
+/** Workers iniciados */
+static ExpositionWorker *workers = NULL;
+static size_t worker_count = 0;
+
+/** Respuestas fijas, creadas una vez al iniciar y compartidas */
+static struct MHD_Response *ok_response = NULL;
+static struct MHD_Response *bad_method_response = NULL;
+static struct MHD_Response *bad_request_response = NULL;
+
+/** Estado de compresión reutilizado entre ticks (solo el publicador) */
+static z_stream gzip_stream;
+static int gzip_ready = 0;
+#ifdef HAVE_ZSTD
+static ZSTD_CCtx *zstd_context = NULL;
+#endif
+
+static void exposition_body_release(ExpositionBody *body) {
+  if (atomic_fetch_sub_explicit(&body->refs, 1, memory_order_acq_rel) == 1) {
+    for (size_t i = 0; i < EXPOSITION_ENCODING_COUNT; i++) {
+      free(body->variants[i].data);
+    }
+    free(body);
+  }
+}
+
+// Comprime el texto en formato gzip. El z_stream se inicializa una vez y se
+// reinicia en cada tick para no volver a reservar sus tablas.
+static void exposition_compress_gzip(const ExpositionVariant *text,
+                                     ExpositionVariant *out) {
+  if (!gzip_ready) {
+    // 15 + 16: ventana máxima con encabezado gzip en lugar de zlib
+    if (deflateInit2(&gzip_stream, EXPOSITION_GZIP_LEVEL, Z_DEFLATED, 15 + 16,
+                     8, Z_DEFAULT_STRATEGY) != Z_OK) {
+      fprintf(stderr, "Error al inicializar gzip\n");
+      return;
+    }
+    gzip_ready = 1;
+  } else if (deflateReset(&gzip_stream) != Z_OK) {
+    return;
+  }
+
+  uLong capacity = deflateBound(&gzip_stream, (uLong)text->length);
+  char *data = malloc(capacity);
+  if (data == NULL) {
+    return;
+  }
+  gzip_stream.next_in = (Bytef *)text->data;
+  gzip_stream.avail_in = (uInt)text->length;
+  gzip_stream.next_out = (Bytef *)data;
+  gzip_stream.avail_out = (uInt)capacity;
+  if (deflate(&gzip_stream, Z_FINISH) != Z_STREAM_END) {
+    fprintf(stderr, "Error al comprimir la exposición con gzip\n");
+    free(data);
+    return;
+  }
+  out->data = data;
+  out->length = gzip_stream.total_out;
+}
+
+#ifdef HAVE_ZSTD
+static void exposition_compress_zstd(const ExpositionVariant *text,
+                                     ExpositionVariant *out) {
+  if (zstd_context == NULL && (zstd_context = ZSTD_createCCtx()) == NULL) {
+    fprintf(stderr, "Error al inicializar zstd\n");
+    return;
+  }
+
+  size_t capacity = ZSTD_compressBound(text->length);
+  char *data = malloc(capacity);
+  if (data == NULL) {
+    return;
+  }
+  size_t length = ZSTD_compressCCtx(zstd_context, data, capacity, text->data,
+                                    text->length, EXPOSITION_ZSTD_LEVEL);
+  if (ZSTD_isError(length)) {
+    fprintf(stderr, "Error al comprimir la exposición con zstd: %s\n",
+            ZSTD_getErrorName(length));
+    free(data);
+    return;
+  }
+  out->data = data;
+  out->length = length;
+}
+#endif
+
+// Elige la codificación según Accept-Encoding. Entre las aceptadas con q > 0
+// gana la de mayor q y, a igualdad, zstd sobre gzip. Cualquier codificación
+// comprimida aceptada gana sobre el texto plano.
+static ExpositionEncoding exposition_negotiate(const ExpositionBody *body,
+                                               const char *accept) {
+  double quality[EXPOSITION_ENCODING_COUNT] = {0.0, -1.0, -1.0};
+  double wildcard = -1.0;
+
+  while (accept != NULL && *accept != '\0') {
+    accept += strspn(accept, " \t,");
+    size_t name_length = strcspn(accept, " \t;,");
+    if (name_length == 0) {
+      break;
+    }
+
+    // Parámetro q opcional; sin él la calidad es 1
+    double q = 1.0;
+    const char *end = accept + strcspn(accept, ",");
+    const char *param = memchr(accept, ';', (size_t)(end - accept));
+    if (param != NULL) {
+      param += 1 + strspn(param + 1, " \t");
+      if ((param[0] == 'q' || param[0] == 'Q') && param[1] == '=') {
+        q = strtod(param + 2, NULL);
+      }
+    }
+
+    if (name_length == 1 && accept[0] == '*') {
+      wildcard = q;
+    } else if ((name_length == 4 && strncasecmp(accept, "gzip", 4) == 0) ||
+               (name_length == 6 && strncasecmp(accept, "x-gzip", 6) == 0)) {
+      quality[EXPOSITION_GZIP] = q;
+    } else if (name_length == 4 && strncasecmp(accept, "zstd", 4) == 0) {
+      quality[EXPOSITION_ZSTD] = q;
+    }
+    accept = end;
+  }
+
+  ExpositionEncoding best = EXPOSITION_IDENTITY;
+  double best_quality = 0.0;
+  static const ExpositionEncoding preference[] = {EXPOSITION_ZSTD,
+                                                  EXPOSITION_GZIP};
+  for (size_t i = 0; i < sizeof(preference) / sizeof(preference[0]); i++) {
+    ExpositionEncoding encoding = preference[i];
+    double q = quality[encoding] >= 0.0 ? quality[encoding] : wildcard;
+    if (body->variants[encoding].data != NULL && q > best_quality) {
+      best = encoding;
+      best_quality = q;
+    }
+  }
+  return best;
+}
+
+// MHD la invoca cuando termina la última conexión que usaba la respuesta
+static void exposition_response_free(void *cls) {
+  exposition_body_release((ExpositionBody *)cls);
+}
+
+// Toma una referencia sobre el cuerpo vigente. El contador acquiring le indica
+// al publicador que no suelte el cuerpo anterior hasta que terminemos.
+static ExpositionBody *exposition_body_acquire() {
+  atomic_fetch_add(&acquiring, 1);
+  ExpositionBody *body = atomic_load(&current);
+  if (body != NULL) {
+    atomic_fetch_add_explicit(&body->refs, 1, memory_order_relaxed);
+  }
+  atomic_fetch_sub_explicit(&acquiring, 1, memory_order_release);
+  return body;
+}
+
+// Reconstruye la respuesta del worker si se publicó un cuerpo nuevo. El
+// worker conserva una referencia sobre su cuerpo, así que la dirección no se
+// reutiliza mientras la comparamos.
+static void exposition_worker_refresh(ExpositionWorker *worker) {
+  if (atomic_load_explicit(&current, memory_order_relaxed) == worker->body) {
+    return;
+  }
+
+  ExpositionBody *body = exposition_body_acquire();
+  if (body == NULL) {
+    return;
+  }
+
+  // Una respuesta por codificación disponible; cada una retiene el cuerpo. La
+  // referencia tomada en acquire pasa a la primera.
+  int adopted = 0;
+  for (size_t i = 0; i < EXPOSITION_ENCODING_COUNT; i++) {
+    // Las respuestas anteriores sueltan su cuerpo cuando MHD termina de
+    // enviarlas
+    if (worker->responses[i] != NULL) {
+      MHD_destroy_response(worker->responses[i]);
+      worker->responses[i] = NULL;
+    }
+
+    const ExpositionVariant *variant = &body->variants[i];
+    if (variant->data == NULL) {
+      continue;
+    }
+    if (adopted) {
+      atomic_fetch_add_explicit(&body->refs, 1, memory_order_relaxed);
+    }
+    struct MHD_Response *response =
+        MHD_create_response_from_buffer_with_free_callback_cls(
+            variant->length, variant->data, exposition_response_free, body);
+    if (response == NULL) {
+      fprintf(stderr, "Error al crear la respuesta de métricas\n");
+      if (adopted) {
+        exposition_body_release(body);
+      }
+      continue;
+    }
+    adopted = 1;
+
+    MHD_add_response_header(response, MHD_HTTP_HEADER_CONTENT_TYPE,
+                            EXPOSITION_CONTENT_TYPE);
+    MHD_add_response_header(response, MHD_HTTP_HEADER_VARY,
+                            MHD_HTTP_HEADER_ACCEPT_ENCODING);
+    if (encoding_names[i] != NULL) {
+      MHD_add_response_header(response, MHD_HTTP_HEADER_CONTENT_ENCODING,
+                              encoding_names[i]);
+    }
+    worker->responses[i] = response;
+  }
+
+  if (!adopted) {
+    exposition_body_release(body);
+  }
+  worker->body = body;
+}
+
+// Manejador de peticiones. Cada daemon tiene un único hilo, dueño de su worker.
+static MhdResult exposition_handler(void *cls, struct MHD_Connection *connection,
+                                    const char *url, const char *method,
+                                    const char *version,
+                                    const char *upload_data,
+                                    size_t *upload_data_size, void **con_cls) {
+  ExpositionWorker *worker = cls;
+  (void)version;
+  (void)upload_data;
+  (void)upload_data_size;
+  (void)con_cls;
+
+  if (strcmp(method, MHD_HTTP_METHOD_GET) != 0) {
+    return MHD_queue_response(connection, MHD_HTTP_BAD_REQUEST,
+                              bad_method_response);
+  }
+  if (strcmp(url, "/") == 0) {
+    return MHD_queue_response(connection, MHD_HTTP_OK, ok_response);
+  }
+  if (strcmp(url, "/metrics") != 0) {
+    return MHD_queue_response(connection, MHD_HTTP_BAD_REQUEST,
+                              bad_request_response);
+  }
+
+  exposition_worker_refresh(worker);
+  if (worker->responses[EXPOSITION_IDENTITY] == NULL) {
+    // Todavía no terminó el primer tick
+    return MHD_queue_response(connection, MHD_HTTP_OK, ok_response);
+  }
+
+  ExpositionEncoding encoding = exposition_negotiate(
+      worker->body, MHD_lookup_connection_value(connection, MHD_HEADER_KIND,
+                                                MHD_HTTP_HEADER_ACCEPT_ENCODING));
+  if (worker->responses[encoding] == NULL) {
+    encoding = EXPOSITION_IDENTITY;
+  }
+  return MHD_queue_response(connection, MHD_HTTP_OK,
+                            worker->responses[encoding]);
+}
+
+static struct MHD_Response *exposition_static_response(const char *text) {
+  return MHD_create_response_from_buffer(strlen(text), (void *)text,
+                                         MHD_RESPMEM_PERSISTENT);
+}
+
+int exposition_start(unsigned short port, size_t threads) {
+  ok_response = exposition_static_response("OK\n");
+  bad_method_response = exposition_static_response("Invalid HTTP Method\n");
+  bad_request_response = exposition_static_response("Bad Request\n");
+  if (ok_response == NULL || bad_method_response == NULL ||
+      bad_request_response == NULL) {
+    fprintf(stderr, "Error al crear las respuestas HTTP\n");
+    return -1;
+  }
+
+  if (threads == 0) {
+    threads = 1;
+  }
+  workers = calloc(threads, sizeof(ExpositionWorker));
+  if (workers == NULL) {
+    fprintf(stderr, "Error al reservar los workers HTTP\n");
+    return -1;
+  }
+
+  // Cada worker abre su propio socket con SO_REUSEPORT; el kernel reparte las
+  // conexiones entrantes entre ellos y cada uno las atiende con epoll
+  for (worker_count = 0; worker_count < threads; worker_count++) {
+    ExpositionWorker *worker = &workers[worker_count];
+    worker->daemon = MHD_start_daemon(
+        MHD_USE_EPOLL_INTERNAL_THREAD, port, NULL, NULL, exposition_handler,
+        worker, MHD_OPTION_LISTENING_ADDRESS_REUSE, (unsigned int)1,
+        MHD_OPTION_CONNECTION_TIMEOUT,
+        (unsigned int)EXPOSITION_KEEPALIVE_TIMEOUT, MHD_OPTION_END);
+    if (worker->daemon == NULL) {
+      fprintf(stderr, "Error al iniciar el worker HTTP %zu\n", worker_count);
+      exposition_stop();
+      return -1;
+    }
+  }
+  return 0;
+}
+
+void exposition_stop() {
+  for (size_t i = 0; i < worker_count; i++) {
+    MHD_stop_daemon(workers[i].daemon);
+    for (size_t e = 0; e < EXPOSITION_ENCODING_COUNT; e++) {
+      if (workers[i].responses[e] != NULL) {
+        MHD_destroy_response(workers[i].responses[e]);
+      }
+    }
+  }
+  free(workers);
+  workers = NULL;
+  worker_count = 0;
+}
+
+void exposition_publish(char *data, size_t length) {
+  ExpositionBody *body = calloc(1, sizeof(ExpositionBody));
+  if (body == NULL) {
+    fprintf(stderr, "Error al reservar el cuerpo de exposición\n");
+    free(data);
+    return;
+  }
+  ExpositionVariant *text = &body->variants[EXPOSITION_IDENTITY];
+  text->data = data;
+  text->length = length;
+
+  // Comprimimos una sola vez por tick; si falla, esa codificación no se ofrece
+  exposition_compress_gzip(text, &body->variants[EXPOSITION_GZIP]);
+#ifdef HAVE_ZSTD
+  exposition_compress_zstd(text, &body->variants[EXPOSITION_ZSTD]);
+#endif
+  atomic_init(&body->refs, 1); // Referencia del publicador
+
+  ExpositionBody *previous = atomic_exchange(&current, body);
+  if (previous == NULL) {
+    return;
+  }
+
+  // Un worker que leyó el cuerpo anterior puede estar a punto de tomar su
+  // referencia; la ventana es de pocas instrucciones y solo ocurre una vez por
+  // tick y worker
+  while (atomic_load(&acquiring) != 0) {
+    sched_yield();
+  }
+  exposition_body_release(previous);
+}
@@ -0,0 +1,117 @@
+#include "../include/history.h"
+#include <stdlib.h>
+
+#define NS_PER_MS 1000000LL
+
+void history_config_from_env(HistoryConfig *config) {
+  config->samples = HISTORY_DEFAULT_SAMPLES;
+  config->window_ms = HISTORY_DEFAULT_WINDOW_MS;
+
+  const char *samples = getenv("MONITOR_HISTORY_SAMPLES");
+  if (samples != NULL && atoi(samples) > 0) {
+    config->samples = (size_t)atoi(samples);
+  }
+
+  const char *window_ms = getenv("MONITOR_HISTORY_WINDOW_MS");
+  if (window_ms != NULL && atoi(window_ms) > 0) {
+    config->window_ms = (unsigned int)atoi(window_ms);
+  }
+}
+
+int history_ring_init(HistoryRing *ring, const HistoryConfig *config) {
+  *ring = (HistoryRing){0};
+  ring->capacity = config->samples ? config->samples : 1;
+  ring->window_ns = (long long)config->window_ms * NS_PER_MS;
+  ring->samples = malloc(ring->capacity * sizeof(HistorySample));
+  ring->min_queue = malloc(ring->capacity * sizeof(uint64_t));
+  ring->max_queue = malloc(ring->capacity * sizeof(uint64_t));
+  if (ring->samples == NULL || ring->min_queue == NULL ||
+      ring->max_queue == NULL) {
+    history_ring_free(ring);
+    return -1;
+  }
+  return 0;
+}
+
+static const HistorySample *history_at(const HistoryRing *ring,
+                                       uint64_t sequence) {
+  return &ring->samples[sequence % ring->capacity];
+}
+
+// Saca la muestra más antigua de la ventana y de las colas
+static void history_evict(HistoryRing *ring) {
+  ring->sum -= history_at(ring, ring->head)->value;
+  if (ring->min_head < ring->min_tail &&
+      ring->min_queue[ring->min_head % ring->capacity] == ring->head) {
+    ring->min_head++;
+  }
+  if (ring->max_head < ring->max_tail &&
+      ring->max_queue[ring->max_head % ring->capacity] == ring->head) {
+    ring->max_head++;
+  }
+  ring->head++;
+}
+
+void history_ring_push(HistoryRing *ring, long long time_ns, double value) {
+  if (ring->tail - ring->head == ring->capacity) {
+    history_evict(ring);
+  }
+
+  uint64_t sequence = ring->tail++;
+  ring->samples[sequence % ring->capacity] =
+      (HistorySample){.time_ns = time_ns, .value = value};
+
+  // La suma se recalcula al completar cada vuelta del anillo para que el
+  // error de redondeo no se acumule; amortizado sigue siendo O(1)
+  if (sequence % ring->capacity == 0) {
+    ring->sum = 0.0;
+    for (uint64_t s = ring->head; s < sequence; s++) {
+      ring->sum += history_at(ring, s)->value;
+    }
+  }
+  ring->sum += value;
+
+  // Las muestras que ya no pueden ser mínimo (o máximo) salen por el fondo
+  while (ring->min_tail > ring->min_head &&
+         history_at(ring,
+                    ring->min_queue[(ring->min_tail - 1) % ring->capacity])
+                 ->value >= value) {
+    ring->min_tail--;
+  }
+  ring->min_queue[ring->min_tail++ % ring->capacity] = sequence;
+  while (ring->max_tail > ring->max_head &&
+         history_at(ring,
+                    ring->max_queue[(ring->max_tail - 1) % ring->capacity])
+                 ->value <= value) {
+    ring->max_tail--;
+  }
+  ring->max_queue[ring->max_tail++ % ring->capacity] = sequence;
+
+  // Descartamos lo que quedó fuera de la ventana; la muestra nueva siempre
+  // queda
+  while (ring->tail - ring->head > 1 &&
+         history_at(ring, ring->head)->time_ns <= time_ns - ring->window_ns) {
+    history_evict(ring);
+  }
+}
+
+int history_ring_window(const HistoryRing *ring, HistoryWindow *window) {
+  if (ring->tail == ring->head) {
+    return -1;
+  }
+  window->count = (size_t)(ring->tail - ring->head);
+  window->last = history_at(ring, ring->tail - 1)->value;
+  window->min =
+      history_at(ring, ring->min_queue[ring->min_head % ring->capacity])->value;
+  window->max =
+      history_at(ring, ring->max_queue[ring->max_head % ring->capacity])->value;
+  window->avg = ring->sum / (double)window->count;
+  return 0;
+}
+
+void history_ring_free(HistoryRing *ring) {
+  free(ring->samples);
+  free(ring->min_queue);
+  free(ring->max_queue);
+  *ring = (HistoryRing){0};
+}
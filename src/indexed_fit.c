@@ -0,0 +1,342 @@
+#include "../include/indexed_fit.h"
+#include "../include/alloc_policy.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+// Los tamaños menores que 2^INDEXED_FL_SHIFT comparten el primer nivel 0,
+// dividido en tramos de INDEXED_ALIGN bytes
+#define INDEXED_ALIGN_SHIFT 4
+#define INDEXED_FL_SHIFT (INDEXED_SL_BITS + INDEXED_ALIGN_SHIFT)
+#define INDEXED_SMALL_SIZE (1UL << INDEXED_FL_SHIFT)
+
+// Bloques de hasta 2^INDEXED_FL_MAX bytes
+#define INDEXED_FL_MAX 40
+#define INDEXED_FL_COUNT (INDEXED_FL_MAX - INDEXED_FL_SHIFT + 1)
+
+#define INDEXED_FREE 1UL
+
+/**
+ * @brief Encabezado de un bloque. Los campos de la lista libre ocupan la
+ * carga útil, así que solo existen mientras el bloque está libre.
+ */
+typedef struct IndexedBlock {
+  struct IndexedBlock *prev_phys; ///< Vecino anterior en la arena, o NULL
+  size_t size;                    ///< Bytes de la carga útil | INDEXED_FREE
+  struct IndexedBlock *next_free; ///< Siguiente en su lista
+  struct IndexedBlock *prev_free; ///< Anterior en su lista
+} IndexedBlock;
+
+/**
+ * @brief Comienzo de cada arena, para poder recorrerlas todas.
+ */
+typedef struct IndexedArena {
+  struct IndexedArena *next; ///< Arena agregada antes, o NULL
+} IndexedArena;
+
+#define INDEXED_HEADER_SIZE offsetof(IndexedBlock, next_free)
+#define INDEXED_MIN_SIZE (sizeof(IndexedBlock) - INDEXED_HEADER_SIZE)
+
+_Static_assert(INDEXED_HEADER_SIZE % INDEXED_ALIGN == 0, "IndexedBlock");
+_Static_assert(sizeof(IndexedArena) <= INDEXED_ALIGN, "IndexedArena");
+
+/** Un bit por primer nivel con alguna lista no vacía */
+static uint64_t fl_bitmap;
+/** Un bit por lista no vacía dentro de cada primer nivel */
+static uint32_t sl_bitmap[INDEXED_FL_COUNT];
+static IndexedBlock *heads[INDEXED_FL_COUNT][INDEXED_SL_COUNT];
+
+/** Última arena agregada */
+static IndexedArena *arenas;
+
+static IndexedStats stats;
+
+static double indexed_now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static size_t block_size(const IndexedBlock *block) {
+  return block->size & ~INDEXED_FREE;
+}
+
+static int block_is_free(const IndexedBlock *block) {
+  return (block->size & INDEXED_FREE) != 0;
+}
+
+static IndexedBlock *next_phys(const IndexedBlock *block) {
+  return (IndexedBlock *)((char *)block + INDEXED_HEADER_SIZE +
+                          block_size(block));
+}
+
+static int fls_size(size_t size) { return 63 - __builtin_clzl(size); }
+
+// Menor tamaño de la lista (fl, sl); inversa de mapping_insert
+static size_t class_base(int fl, int sl) {
+  if (fl == 0) {
+    return (size_t)sl << INDEXED_ALIGN_SHIFT;
+  }
+  int bit = fl + INDEXED_FL_SHIFT - 1;
+  return (1UL << bit) + ((size_t)sl << (bit - INDEXED_SL_BITS));
+}
+
+static void mapping_insert(size_t size, int *fl, int *sl) {
+  if (size < INDEXED_SMALL_SIZE) {
+    *fl = 0;
+    *sl = (int)(size >> INDEXED_ALIGN_SHIFT);
+  } else {
+    int bit = fls_size(size);
+    *sl = (int)(size >> (bit - INDEXED_SL_BITS)) ^ INDEXED_SL_COUNT;
+    *fl = bit - INDEXED_FL_SHIFT + 1;
+  }
+}
+
+// Redondea al próximo tramo para que cualquier bloque de la lista alcance
+static void mapping_search(size_t size, int *fl, int *sl) {
+  if (size >= INDEXED_SMALL_SIZE) {
+    size += (1UL << (fls_size(size) - INDEXED_SL_BITS)) - 1;
+  }
+  mapping_insert(size, fl, sl);
+}
+
+static IndexedBlock *find_suitable(int *fl, int *sl) {
+  uint32_t sl_map = sl_bitmap[*fl] & (~0U << *sl);
+  if (sl_map == 0) {
+    uint64_t fl_map = fl_bitmap & (~0ULL << (*fl + 1));
+    if (fl_map == 0) {
+      return NULL;
+    }
+    *fl = __builtin_ctzll(fl_map);
+    sl_map = sl_bitmap[*fl];
+  }
+  *sl = __builtin_ctz(sl_map);
+  return heads[*fl][*sl];
+}
+
+static void remove_free(IndexedBlock *block, int fl, int sl) {
+  if (block->prev_free != NULL) {
+    block->prev_free->next_free = block->next_free;
+  } else {
+    heads[fl][sl] = block->next_free;
+    if (heads[fl][sl] == NULL) {
+      sl_bitmap[fl] &= ~(1U << sl);
+      if (sl_bitmap[fl] == 0) {
+        fl_bitmap &= ~(1ULL << fl);
+      }
+    }
+  }
+  if (block->next_free != NULL) {
+    block->next_free->prev_free = block->prev_free;
+  }
+  stats.free_blocks--;
+  stats.free_bytes -= block_size(block);
+  stats.free_histogram[policy_free_bucket(block_size(block))]--;
+}
+
+static void remove_block(IndexedBlock *block) {
+  int fl, sl;
+  mapping_insert(block_size(block), &fl, &sl);
+  remove_free(block, fl, sl);
+}
+
+static void insert_block(IndexedBlock *block) {
+  int fl, sl;
+  mapping_insert(block_size(block), &fl, &sl);
+  block->size |= INDEXED_FREE;
+  block->prev_free = NULL;
+  block->next_free = heads[fl][sl];
+  if (block->next_free != NULL) {
+    block->next_free->prev_free = block;
+  }
+  heads[fl][sl] = block;
+  sl_bitmap[fl] |= 1U << sl;
+  fl_bitmap |= 1ULL << fl;
+  stats.free_blocks++;
+  stats.free_bytes += block_size(block);
+  stats.free_histogram[policy_free_bucket(block_size(block))]++;
+}
+
+// Agrega una arena con un bloque libre y un centinela ocupado al final, que
+// evita unir bloques de arenas distintas
+static int add_arena(size_t size) {
+  // El enlace de la arena, un encabezado para el bloque, otro para el
+  // centinela y margen para alinear ambos extremos
+  size_t needed = size + 2 * INDEXED_HEADER_SIZE + 3 * INDEXED_ALIGN;
+  size_t bytes = policy_reserve_size(needed > INDEXED_ARENA_SIZE
+                                         ? needed
+                                         : INDEXED_ARENA_SIZE);
+  char *arena = policy_reserve(bytes);
+  if (arena == NULL) {
+    return -1;
+  }
+  stats.reserved_bytes += bytes;
+
+  uintptr_t link =
+      ((uintptr_t)arena + INDEXED_ALIGN - 1) & ~(uintptr_t)(INDEXED_ALIGN - 1);
+  ((IndexedArena *)link)->next = arenas;
+  arenas = (IndexedArena *)link;
+  uintptr_t start = link + INDEXED_ALIGN;
+  uintptr_t end = ((uintptr_t)arena + bytes - INDEXED_HEADER_SIZE) &
+                  ~(uintptr_t)(INDEXED_ALIGN - 1);
+  IndexedBlock *block = (IndexedBlock *)start;
+  block->prev_phys = NULL;
+  block->size = end - start - INDEXED_HEADER_SIZE;
+  IndexedBlock *sentinel = (IndexedBlock *)end;
+  sentinel->prev_phys = block;
+  sentinel->size = 0;
+  insert_block(block);
+  return 0;
+}
+
+static size_t adjust_size(size_t size) {
+  size = (size + INDEXED_ALIGN - 1) & ~(size_t)(INDEXED_ALIGN - 1);
+  return size < INDEXED_MIN_SIZE ? INDEXED_MIN_SIZE : size;
+}
+
+void *indexed_malloc(size_t size) {
+  double start = indexed_now();
+  size_t adjusted = adjust_size(size);
+  // Con el redondeo de mapping_search debe quedar dentro del primer nivel
+  if (adjusted >> (INDEXED_FL_MAX - 1)) {
+    return NULL;
+  }
+
+  int fl, sl;
+  mapping_search(adjusted, &fl, &sl);
+  IndexedBlock *block = find_suitable(&fl, &sl);
+  if (block == NULL) {
+    if (add_arena(adjusted + (adjusted >> INDEXED_SL_BITS)) != 0) {
+      return NULL;
+    }
+    mapping_search(adjusted, &fl, &sl);
+    if ((block = find_suitable(&fl, &sl)) == NULL) {
+      return NULL;
+    }
+  }
+  remove_free(block, fl, sl);
+  block->size &= ~INDEXED_FREE;
+
+  // El sobrante vuelve al índice si alcanza para un bloque
+  size_t available = block_size(block);
+  if (available >= adjusted + INDEXED_HEADER_SIZE + INDEXED_MIN_SIZE) {
+    IndexedBlock *rest =
+        (IndexedBlock *)((char *)block + INDEXED_HEADER_SIZE + adjusted);
+    rest->prev_phys = block;
+    rest->size = available - adjusted - INDEXED_HEADER_SIZE;
+    next_phys(rest)->prev_phys = rest;
+    block->size = adjusted;
+    insert_block(rest);
+  }
+
+  stats.allocated_bytes += block_size(block);
+  stats.allocations++;
+  stats.allocation_time += indexed_now() - start;
+  return (char *)block + INDEXED_HEADER_SIZE;
+}
+
+void indexed_free(void *pointer) {
+  if (pointer == NULL) {
+    return;
+  }
+  IndexedBlock *block = (IndexedBlock *)((char *)pointer - INDEXED_HEADER_SIZE);
+  stats.allocated_bytes -= block_size(block);
+
+  IndexedBlock *prev = block->prev_phys;
+  if (prev != NULL && block_is_free(prev)) {
+    remove_block(prev);
+    prev->size = block_size(prev) + INDEXED_HEADER_SIZE + block_size(block);
+    block = prev;
+  }
+  IndexedBlock *next = next_phys(block);
+  if (block_is_free(next)) {
+    remove_block(next);
+    block->size = block_size(block) + INDEXED_HEADER_SIZE + block_size(next);
+  }
+  next_phys(block)->prev_phys = block;
+  insert_block(block);
+}
+
+void indexed_get_stats(IndexedStats *out) {
+  *out = stats;
+  out->largest_free_block = 0;
+  out->largest_allocatable = 0;
+  if (fl_bitmap == 0) {
+    return;
+  }
+  // La lista no vacía más alta sale de los mapas de bits, sin recorrerla: su
+  // límite inferior es el mayor pedido que mapping_search lleva a ella
+  int fl = 63 - __builtin_clzll(fl_bitmap);
+  int sl = 31 - __builtin_clz(sl_bitmap[fl]);
+  out->largest_free_block = class_base(fl, sl);
+  out->largest_allocatable = out->largest_free_block;
+}
+
+int indexed_check() {
+  int result = 0;
+
+  // Bloques libres según las arenas
+  size_t walked_blocks = 0, walked_bytes = 0;
+  size_t histogram[POLICY_FREE_BUCKETS] = {0};
+  for (IndexedArena *arena = arenas; arena != NULL; arena = arena->next) {
+    IndexedBlock *prev = NULL;
+    IndexedBlock *block = (IndexedBlock *)((char *)arena + INDEXED_ALIGN);
+    while (block_size(block) != 0) {
+      if (block->prev_phys != prev) {
+        fprintf(stderr, "indexed_fit: vecino anterior inválido en %p\n",
+                (void *)block);
+        result = -1;
+      }
+      if (block_is_free(block)) {
+        if (prev != NULL && block_is_free(prev)) {
+          fprintf(stderr, "indexed_fit: bloques libres sin unir en %p\n",
+                  (void *)block);
+          result = -1;
+        }
+        walked_blocks++;
+        walked_bytes += block_size(block);
+        histogram[policy_free_bucket(block_size(block))]++;
+      }
+      prev = block;
+      block = next_phys(block);
+    }
+  }
+
+  // Bloques libres según el índice
+  size_t listed_blocks = 0, listed_bytes = 0;
+  for (int fl = 0; fl < INDEXED_FL_COUNT; fl++) {
+    for (int sl = 0; sl < INDEXED_SL_COUNT; sl++) {
+      int listed = heads[fl][sl] != NULL;
+      if (listed != (int)((sl_bitmap[fl] >> sl) & 1) ||
+          (listed && !((fl_bitmap >> fl) & 1))) {
+        fprintf(stderr,
+                "indexed_fit: bitmap de la lista %d/%d desactualizado\n", fl,
+                sl);
+        result = -1;
+      }
+      for (IndexedBlock *block = heads[fl][sl]; block != NULL;
+           block = block->next_free) {
+        listed_blocks++;
+        listed_bytes += block_size(block);
+      }
+    }
+  }
+
+  if (walked_blocks != stats.free_blocks || walked_bytes != stats.free_bytes ||
+      listed_blocks != stats.free_blocks || listed_bytes != stats.free_bytes) {
+    fprintf(stderr,
+            "indexed_fit: %zu bloques libres (%zu bytes) en las arenas y %zu "
+            "(%zu bytes) en el índice, las estadísticas dicen %zu (%zu "
+            "bytes)\n",
+            walked_blocks, walked_bytes, listed_blocks, listed_bytes,
+            stats.free_blocks, stats.free_bytes);
+    result = -1;
+  }
+  if (memcmp(histogram, stats.free_histogram, sizeof(histogram)) != 0) {
+    fprintf(stderr,
+            "indexed_fit: histograma de bloques libres desactualizado\n");
+    result = -1;
+  }
+  return result;
+}
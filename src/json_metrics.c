@@ -1,58 +1,74 @@
 #include "../include/json_metrics.h"
+#include "../include/json_writer.h"
 #include "../include/metrics.h"
-#include <cjson/cJSON.h>
-#include <stdio.h>
+#include "../include/monitor_pipe.h"
+
+/** Emisor reutilizado entre ticks; su búfer solo crece */
+static JsonWriter writer;
 
 void send_metrics_as_json() {
-  cJSON *root = cJSON_CreateObject();
+  json_writer_reset(&writer);
+  json_object_begin(&writer, NULL);
 
   // Recolectar las métricas de CPU, memoria, disco, red, procesos y cambios de
   // contexto
   double cpu_usage = get_cpu_usage();
   double memory_usage = get_memory_usage();
-  DiskStats disk_stats = get_disk_stats();
-  NetStats network_stats = get_network_stats("wlp2s0");
+  const DiskTable *disk_table = get_disk_table();
+  const NetTable *network_table = get_network_table();
   int running_processes = get_running_processes();
   unsigned long long context_switches = get_context_switches();
 
   // Añadir métricas al objeto JSON
-  cJSON_AddNumberToObject(root, "cpu_usage_percentage", cpu_usage);
-  cJSON_AddNumberToObject(root, "memory_usage_percentage", memory_usage);
-  cJSON_AddNumberToObject(root, "disk_reads", disk_stats.reads);
-  cJSON_AddNumberToObject(root, "disk_writes", disk_stats.writes);
-  cJSON_AddNumberToObject(root, "disk_read_time_seconds",
-                          disk_stats.read_time / 1000.0);
-  cJSON_AddNumberToObject(root, "disk_write_time_seconds",
-                          disk_stats.write_time / 1000.0);
-  cJSON_AddNumberToObject(root, "network_bandwidth_rx",
-                          network_stats.bytes_received);
-  cJSON_AddNumberToObject(root, "network_bandwidth_tx",
-                          network_stats.bytes_transmitted);
-  cJSON_AddNumberToObject(root, "network_packet_ratio",
-                          (network_stats.packets_received > 0)
-                              ? (double)network_stats.packets_transmitted /
-                                    network_stats.packets_received
-                              : 0.0);
-  cJSON_AddNumberToObject(root, "running_processes_count", running_processes);
-  cJSON_AddNumberToObject(root, "context_switches_total", context_switches);
-
-  // Convertir el objeto JSON a string y enviarlo al pipe
-  char *json_data = cJSON_Print(root);
-  if (json_data != NULL) {
-    FILE *pipe =
-        fopen("/tmp/monitor_pipe",
-              "a"); // "a" mantiene el pipe abierto para múltiples escrituras
-    if (pipe) {
-      fprintf(pipe, "%s\n", json_data);
-      fflush(pipe); // Asegura que los datos se escriban inmediatamente
-      fclose(pipe);
-    } else {
-      perror("Error al abrir el pipe para enviar métricas");
+  json_write_number(&writer, "cpu_usage_percentage", cpu_usage);
+  json_write_number(&writer, "memory_usage_percentage", memory_usage);
+
+  // Un objeto por dispositivo de bloques
+  json_array_begin(&writer, "disks");
+  for (size_t i = 0; i < disk_table->capacity; i++) {
+    const DiskDevice *device = &disk_table->slots[i];
+    if (!device->in_use) {
+      continue;
     }
+    json_object_begin(&writer, NULL);
+    json_write_string(&writer, "device", device->name);
+    json_write_uint(&writer, "reads", device->stats.reads);
+    json_write_uint(&writer, "writes", device->stats.writes);
+    json_write_number(&writer, "read_time_seconds",
+                      device->stats.read_time / 1000.0);
+    json_write_number(&writer, "write_time_seconds",
+                      device->stats.write_time / 1000.0);
+    json_write_number(&writer, "utilization_percentage", device->utilization);
+    json_write_number(&writer, "await_ms", device->await);
+    json_object_end(&writer);
+  }
+  json_array_end(&writer);
 
-    free(json_data);
+  // Un objeto por interfaz de red, con tasas en bytes por segundo
+  json_array_begin(&writer, "network");
+  for (size_t i = 0; i < network_table->count; i++) {
+    const NetInterface *iface = &network_table->interfaces[i];
+    json_object_begin(&writer, NULL);
+    json_write_string(&writer, "interface", iface->name);
+    json_write_number(&writer, "bandwidth_rx", iface->rx_bytes_rate);
+    json_write_number(&writer, "bandwidth_tx", iface->tx_bytes_rate);
+    json_write_number(&writer, "packet_ratio",
+                      (iface->stats.packets_received > 0)
+                          ? (double)iface->stats.packets_transmitted /
+                                iface->stats.packets_received
+                          : 0.0);
+    json_object_end(&writer);
   }
+  json_array_end(&writer);
 
-  // Limpiar el objeto JSON
-  cJSON_Delete(root);
+  json_write_number(&writer, "running_processes_count", running_processes);
+  json_write_uint(&writer, "context_switches_total", context_switches);
+  json_object_end(&writer);
+
+  // Un registro compacto por línea; el hilo publicador lo escribe en el pipe
+  size_t length;
+  const char *json_data = json_writer_finish(&writer, &length);
+  if (json_data != NULL) {
+    monitor_pipe_submit(json_data, length);
+  }
 }
@@ -0,0 +1,217 @@
+#include "../include/json_writer.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Capacidad inicial del búfer; alcanza para un registro típico del monitor
+#define JSON_WRITER_INITIAL_CAPACITY 4096
+
+// Asegura espacio para extra bytes más el '\0' final
+static int json_reserve(JsonWriter *writer, size_t extra) {
+  if (writer->failed) {
+    return -1;
+  }
+  if (writer->length + extra + 1 <= writer->capacity) {
+    return 0;
+  }
+
+  size_t capacity =
+      writer->capacity ? writer->capacity : JSON_WRITER_INITIAL_CAPACITY;
+  while (writer->length + extra + 1 > capacity) {
+    capacity *= 2;
+  }
+  char *data = realloc(writer->data, capacity);
+  if (data == NULL) {
+    writer->failed = 1;
+    return -1;
+  }
+  writer->data = data;
+  writer->capacity = capacity;
+  return 0;
+}
+
+static void json_append(JsonWriter *writer, const char *text, size_t length) {
+  if (json_reserve(writer, length) == 0) {
+    memcpy(writer->data + writer->length, text, length);
+    writer->length += length;
+  }
+}
+
+static void json_append_char(JsonWriter *writer, char c) {
+  if (json_reserve(writer, 1) == 0) {
+    writer->data[writer->length++] = c;
+  }
+}
+
+static void json_append_escaped(JsonWriter *writer, const char *text) {
+  static const char hex[] = "0123456789abcdef";
+
+  json_append_char(writer, '"');
+  for (const char *run = text;; text++) {
+    unsigned char c = (unsigned char)*text;
+    if (c >= 0x20 && c != '"' && c != '\\') {
+      continue;
+    }
+
+    // Copiamos de una vez el tramo que no necesita escape
+    json_append(writer, run, (size_t)(text - run));
+    if (c == '\0') {
+      break;
+    }
+    run = text + 1;
+
+    char escape[6] = {'\\', (char)c};
+    size_t escape_length = 2;
+    switch (c) {
+    case '"':
+    case '\\':
+      break;
+    case '\n':
+      escape[1] = 'n';
+      break;
+    case '\r':
+      escape[1] = 'r';
+      break;
+    case '\t':
+      escape[1] = 't';
+      break;
+    default:
+      escape[1] = 'u';
+      escape[2] = '0';
+      escape[3] = '0';
+      escape[4] = hex[c >> 4];
+      escape[5] = hex[c & 0xf];
+      escape_length = 6;
+      break;
+    }
+    json_append(writer, escape, escape_length);
+  }
+  json_append_char(writer, '"');
+}
+
+static void json_append_uint(JsonWriter *writer, unsigned long long value) {
+  char digits[24];
+  size_t length = 0;
+  do {
+    digits[sizeof(digits) - ++length] = (char)('0' + value % 10);
+    value /= 10;
+  } while (value != 0);
+  json_append(writer, digits + sizeof(digits) - length, length);
+}
+
+// Escribe la coma separadora (si el nivel ya tiene elementos) y la clave
+static void json_element(JsonWriter *writer, const char *key) {
+  unsigned long long bit = 1ULL << writer->depth;
+  if (writer->started & bit) {
+    json_append_char(writer, ',');
+  }
+  writer->started |= bit;
+
+  if (key != NULL) {
+    json_append_escaped(writer, key);
+    json_append_char(writer, ':');
+  }
+}
+
+static void json_open(JsonWriter *writer, const char *key, char bracket) {
+  json_element(writer, key);
+  json_append_char(writer, bracket);
+  if (writer->depth + 1 >= JSON_WRITER_MAX_DEPTH) {
+    writer->failed = 1;
+    return;
+  }
+  writer->depth++;
+  writer->started &= ~(1ULL << writer->depth);
+}
+
+static void json_close(JsonWriter *writer, char bracket) {
+  if (writer->depth == 0) {
+    writer->failed = 1;
+    return;
+  }
+  writer->depth--;
+  json_append_char(writer, bracket);
+}
+
+void json_writer_reset(JsonWriter *writer) {
+  writer->length = 0;
+  writer->depth = 0;
+  writer->started = 0;
+  writer->failed = 0;
+}
+
+void json_writer_free(JsonWriter *writer) {
+  free(writer->data);
+  writer->data = NULL;
+  writer->capacity = 0;
+  json_writer_reset(writer);
+}
+
+void json_object_begin(JsonWriter *writer, const char *key) {
+  json_open(writer, key, '{');
+}
+
+void json_object_end(JsonWriter *writer) { json_close(writer, '}'); }
+
+void json_array_begin(JsonWriter *writer, const char *key) {
+  json_open(writer, key, '[');
+}
+
+void json_array_end(JsonWriter *writer) { json_close(writer, ']'); }
+
+void json_write_number(JsonWriter *writer, const char *key, double value) {
+  json_element(writer, key);
+  if (!isfinite(value)) {
+    json_append(writer, "null", 4);
+    return;
+  }
+
+  // Los enteros exactos se escriben sin parte decimal, como hacía cJSON. El
+  // rango va primero: convertir a long long un valor fuera de él es indefinido
+  if (fabs(value) < 1e15 && value == (double)(long long)value) {
+    if (value < 0) {
+      json_append_char(writer, '-');
+      value = -value;
+    }
+    json_append_uint(writer, (unsigned long long)value);
+    return;
+  }
+
+  // 15 dígitos alcanzan casi siempre; si no vuelven a dar el mismo valor
+  // usamos 17, que siempre lo hacen
+  char number[32];
+  int length = snprintf(number, sizeof(number), "%.15g", value);
+  if (strtod(number, NULL) != value) {
+    length = snprintf(number, sizeof(number), "%.17g", value);
+  }
+  json_append(writer, number, (size_t)length);
+}
+
+void json_write_uint(JsonWriter *writer, const char *key,
+                     unsigned long long value) {
+  json_element(writer, key);
+  json_append_uint(writer, value);
+}
+
+void json_write_string(JsonWriter *writer, const char *key,
+                       const char *value) {
+  json_element(writer, key);
+  json_append_escaped(writer, value);
+}
+
+const char *json_writer_finish(JsonWriter *writer, size_t *length) {
+  if (writer->depth != 0) {
+    writer->failed = 1;
+  }
+  json_append_char(writer, '\n');
+  if (writer->failed) {
+    return NULL;
+  }
+
+  writer->data[writer->length] = '\0';
+  if (length != NULL) {
+    *length = writer->length;
+  }
+  return writer->data;
+}
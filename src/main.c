@@ -9,9 +9,20 @@
 
 #include "../../../lib/memory/include/memory.h"
 #include "../../../lib/memory/include/stats_memory.h"
+#include "../include/alloc_latency.h"
+#include "../include/alloc_policy.h"
+#include "../include/alloc_stress.h"
+#include "../include/alloc_trace.h"
+#include "../include/binary_metrics.h"
 #include "../include/expose_metrics.h"
 #include "../include/json_metrics.h"
 #include "../include/metrics.h"
+#include "../include/metrics_snapshot.h"
+#include "../include/monitor_pipe.h"
+#include "../include/monitor_shm.h"
+#include "../include/proc_reader.h"
+#include "../include/proc_top.h"
+#include "../include/scheduler.h"
 #include <complex.h>
 #include <pthread.h>
 #include <signal.h>
@@ -19,8 +30,125 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#define SLEEP_TIME                                                             \
-  1 ///< Intervalo de tiempo en segundos entre cada actualización de métricas.
+#include <time.h>
+
+volatile sig_atomic_t keep_running = 1;
+
+// Termina el bucle principal para que corra el cierre ordenado
+static void stop_running(int signum) {
+  (void)signum;
+  keep_running = 0;
+}
+
+void simulate_memory_operations();
+
+/** Configuración de las salidas, compartida con la tarea de publicación */
+static MonitorPipeConfig pipe_config;
+static int shm_enabled = 0;
+
+// Una lectura de /proc/stat alimenta CPU, procesos y cambios de contexto
+static void collect_cpu(void) {
+  refresh_proc_stat();
+  update_cpu_gauge();
+  update_cpu_core_metrics();
+}
+
+static void collect_memory(void) { update_memory_gauge(); }
+
+static void collect_disk(void) {
+  refresh_disk_stats();
+  update_disk_metrics();
+}
+
+static void collect_network(void) {
+  refresh_network_stats();
+  update_network_metrics();
+}
+
+// Toman los contadores de la última lectura de /proc/stat de collect_cpu
+static void collect_processes(void) { update_count_processes(); }
+
+static void collect_proc_top(void) {
+  if (proc_top_scan() == 0) {
+    update_proc_top_metrics();
+  }
+}
+
+static void collect_context_switches(void) {
+  update_context_switches_metric();
+}
+
+// Recorre el heap de memory.h; las lecturas de collect_allocator toman su
+// último resultado
+static void collect_allocator_heap(void) {
+  alloc_stress_lock();
+  policy_walk_heap();
+  alloc_stress_unlock();
+}
+
+static void collect_allocator(void) {
+  simulate_memory_operations();
+  // Los totales de las políticas no pueden cruzarse con los hilos de estrés
+  alloc_stress_lock();
+  update_memory_fragmentation_metric();
+  update_allocation_policy_metrics();
+  alloc_stress_unlock();
+  update_alloc_stress_metrics();
+  // Una terminación abrupta pierde como mucho el último intervalo de la traza
+  alloc_trace_flush();
+}
+
+// Entrega lo recolectado desde la publicación anterior al exportador, al pipe
+// y al anillo en memoria compartida
+static void publish_metrics(void) {
+  update_cpu_window_metrics();
+  update_pipe_metrics();
+  update_scheduler_metrics();
+
+  // Entregamos los valores al hilo exportador sin bloquear
+  snapshot_publish();
+
+  // El registro binario se codifica una vez para el pipe y el anillo
+  const void *record = NULL;
+  size_t record_length = 0;
+  if (shm_enabled || pipe_config.format == MONITOR_PIPE_BINARY) {
+    record = encode_metrics_as_binary(&record_length);
+  }
+  if (pipe_config.format == MONITOR_PIPE_BINARY) {
+    if (record != NULL) {
+      monitor_pipe_submit(record, record_length);
+    }
+  } else {
+    send_metrics_as_json();
+  }
+  if (shm_enabled && record != NULL) {
+    monitor_shm_publish(record, record_length);
+  }
+}
+
+/**
+ * @brief Recolectores con su intervalo por defecto, configurable con
+ * MONITOR_INTERVAL_<NOMBRE>_MS.
+ *
+ * La publicación va última para que, cuando vence junto con otros
+ * recolectores, incluya sus valores de ese mismo instante.
+ */
+static SchedulerTask tasks[] = {
+    {.name = "cpu", .run = collect_cpu, .interval_ms = 100},
+    {.name = "memory", .run = collect_memory, .interval_ms = 1000},
+    {.name = "disk", .run = collect_disk, .interval_ms = 10000},
+    {.name = "network", .run = collect_network, .interval_ms = 1000},
+    {.name = "processes", .run = collect_processes, .interval_ms = 1000},
+    {.name = "proc_top", .run = collect_proc_top, .interval_ms = 5000},
+    {.name = "context_switches",
+     .run = collect_context_switches,
+     .interval_ms = 1000},
+    {.name = "allocator_heap",
+     .run = collect_allocator_heap,
+     .interval_ms = 10000},
+    {.name = "allocator", .run = collect_allocator, .interval_ms = 1000},
+    {.name = "publish", .run = publish_metrics, .interval_ms = 1000},
+};
 
 /**
  * @brief Función principal del programa.
@@ -29,26 +157,40 @@
  * cambios de contexto) y crea un hilo para exponer las métricas a través de un
  * servidor HTTP en el puerto 8000.
  *
- * El programa entra en un bucle infinito, actualizando las métricas
- * periódicamente.
+ * El programa entra en un bucle infinito en el que el planificador corre cada
+ * recolector en su propio intervalo.
  *
  * @param argc Número de argumentos de línea de comandos (no utilizados).
  * @param argv Lista de argumentos de línea de comandos (no utilizados).
  * @return `EXIT_SUCCESS` si el programa se ejecuta correctamente,
  * `EXIT_FAILURE` si ocurre un error.
  */
-volatile sig_atomic_t keep_running = 1;
-
-void simulate_memory_operations();
-
 int main(int argc, char *argv[]) {
 
+  // SIGINT y SIGTERM solo se atienden en este hilo: los hilos creados
+  // heredan la máscara y la señal interrumpe la espera del planificador
+  struct sigaction stop_action = {.sa_handler = stop_running};
+  sigemptyset(&stop_action.sa_mask);
+  sigaction(SIGINT, &stop_action, NULL);
+  sigaction(SIGTERM, &stop_action, NULL);
+  sigset_t stop_signals;
+  sigemptyset(&stop_signals);
+  sigaddset(&stop_signals, SIGINT);
+  sigaddset(&stop_signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &stop_signals, NULL);
+
   // Inicialización de las métricas del sistema
   init_metrics();
-  // init_disk_metrics();
-  // init_network_metrics();
-  // init_count_processes();
-  // init_context_switches_metric();
+  init_disk_metrics();
+  init_network_metrics();
+  init_pipe_metrics();
+  init_history_metrics();
+  init_alloc_latency_metrics();
+  init_alloc_stress_metrics();
+  init_scheduler_metrics();
+  init_proc_top_metrics();
+  init_count_processes();
+  init_context_switches_metric();
 
   // Iniciar el hilo para exponer las métricas
   pthread_t tid;
@@ -57,56 +199,126 @@ int main(int argc, char *argv[]) {
     return EXIT_FAILURE;
   }
 
+  // Iniciar el publicador del pipe, para que un lector lento no detenga el
+  // bucle de recolección
+  monitor_pipe_config_from_env(&pipe_config);
+  if (pipe_config.format == MONITOR_PIPE_BINARY) {
+    init_binary_metrics();
+  }
+  if (monitor_pipe_start(&pipe_config) != 0) {
+    fprintf(stderr, "Error al iniciar el publicador del pipe\n");
+  }
+
+  // Anillo en memoria compartida para consumidores locales
+  MonitorShmConfig shm_config;
+  monitor_shm_config_from_env(&shm_config);
+  shm_enabled = shm_config.slots > 0 && monitor_shm_start(&shm_config) == 0;
+
+  // Rankings de procesos por CPU y memoria residente
+  ProcTopConfig proc_top_config;
+  proc_top_config_from_env(&proc_top_config);
+  if (proc_top_config.top_n > 0 && proc_top_start(&proc_top_config) != 0) {
+    fprintf(stderr, "Error al iniciar el recolector de procesos\n");
+  }
+
+  // Captura de las operaciones del asignador, para reproducirlas con
+  // bench_replay
+  const char *trace_path = getenv("MONITOR_ALLOC_TRACE");
+  if (trace_path != NULL && alloc_trace_open(trace_path) != 0) {
+    fprintf(stderr, "Error al iniciar la traza del asignador\n");
+  }
+
+  // Contrasta los totales de fragmentación con un recorrido completo en cada
+  // recorrido del heap; solo para depurar
+  if (getenv("MONITOR_ALLOC_CHECK") != NULL) {
+    policy_set_check(1);
+  }
+
+  if (scheduler_init(tasks, sizeof(tasks) / sizeof(tasks[0])) != 0) {
+    return EXIT_FAILURE;
+  }
+
+  // Primera lectura de cada recolector, para que las tasas del primer
+  // intervalo tengan una referencia
+  refresh_proc_stat();
+  refresh_disk_stats();
+  refresh_network_stats();
+
   enable_unmapping = 0;
-  // Bucle principal para actualizar las métricas
-  while (keep_running) {
-    // update_disk_metrics();
-    // update_cpu_gauge();
-    // update_memory_gauge();
-    // update_network_metrics();
-    // update_count_processes();
-    // update_context_switches_metric();
 
-    simulate_memory_operations();
-    update_memory_fragmentation_metric();
-    update_allocation_policy_metrics();
+  // Hilos que compiten por el asignador, si se configuraron
+  AllocStressConfig stress_config;
+  alloc_stress_config_from_env(&stress_config);
+  if (stress_config.threads > 0 && alloc_stress_start(&stress_config) != 0) {
+    fprintf(stderr, "Error al iniciar el modo de estrés del asignador\n");
+  }
 
-    send_metrics_as_json();
+  pthread_sigmask(SIG_UNBLOCK, &stop_signals, NULL);
 
-    sleep(SLEEP_TIME);
+  // Bucle principal: cada vuelta espera el próximo vencimiento
+  while (keep_running) {
+    if (scheduler_run_once() < 0) {
+      break;
+    }
   }
 
+  scheduler_close();
+  alloc_stress_stop();
+  monitor_pipe_stop();
+  monitor_shm_stop();
+  alloc_trace_close();
+  proc_top_stop();
+  proc_files_close();
   return EXIT_SUCCESS;
 }
 
+static uint64_t monotonic_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
 void simulate_memory_operations() {
   // Array of allocation methods
-  int methods[] = {FIRST_FIT, BEST_FIT, WORST_FIT};
-  const char *method_names[] = {"First Fit", "Best Fit", "Worst Fit"};
+  int methods[] = {FIRST_FIT, BEST_FIT, WORST_FIT, SEGREGATED_FIT,
+                   INDEXED_BEST_FIT};
+  const char *method_names[] = {"First Fit", "Best Fit", "Worst Fit",
+                                "Segregated Fit", "Indexed Best Fit"};
 
   // Arrays to keep track of allocations for each method
-  static void *allocated_blocks[3][100];
-  static int num_allocated[3] = {0, 0, 0};
+  static void *allocated_blocks[ALLOC_POLICY_COUNT][100];
+  static int num_allocated[ALLOC_POLICY_COUNT] = {0};
 
-  // Loop over each allocation method
-  for (int m = 0; m < 3; m++) {
-    malloc_control(methods[m]);
+  // malloc_control es global: los hilos de estrés esperan a que termine la
+  // vuelta completa
+  alloc_stress_lock();
 
+  // Loop over each allocation method
+  for (int m = 0; m < ALLOC_POLICY_COUNT; m++) {
     // Randomly decide to allocate or free memory
     if (rand() % 2 == 0 && num_allocated[m] < 100) {
       // Allocate a new block of random size
       size_t size = (rand() % 256) + 16; // Sizes between 16 and 271 bytes
-      void *ptr = my_malloc(size);
+      uint64_t start = monotonic_ns();
+      void *ptr = policy_malloc(methods[m], size);
+      alloc_latency_record(methods[m], ALLOC_OP_MALLOC,
+                           monotonic_ns() - start);
+      alloc_trace_malloc(methods[m], size, ptr);
       if (ptr) {
         allocated_blocks[m][num_allocated[m]++] = ptr;
       }
     } else if (num_allocated[m] > 0) {
       // Free a random block
       int index = rand() % num_allocated[m];
-      my_free(allocated_blocks[m][index]);
+      alloc_trace_free(methods[m], allocated_blocks[m][index]);
+      uint64_t start = monotonic_ns();
+      policy_free(methods[m], allocated_blocks[m][index]);
+      alloc_latency_record(methods[m], ALLOC_OP_FREE, monotonic_ns() - start);
       // Remove the freed block from the list
       allocated_blocks[m][index] = allocated_blocks[m][num_allocated[m] - 1];
       num_allocated[m]--;
     }
   }
+
+  alloc_stress_unlock();
 }
@@ -1,46 +1,44 @@
 #include "../include/metrics.h"
 #include "../../../lib/memory/include/memory.h"
 #include "../../../lib/memory/include/stats_memory.h"
+#include "../include/proc_parse.h"
+#include "../include/proc_reader.h"
+#include <stddef.h>
+#include <time.h>
 
 // Definir constantes simbólicas para evitar magic numbers
-#define MEMINFO_BUFFER_SIZE 256
-#define STAT_BUFFER_SIZE 1024
-#define DISKSTATS_BUFFER_SIZE 512
-#define NETDEV_BUFFER_SIZE 512
-#define LOADAVG_BUFFER_SIZE 128
 #define PROC_MEMINFO "/proc/meminfo"
 #define PROC_STAT "/proc/stat"
 #define PROC_DISKSTATS "/proc/diskstats"
 #define PROC_NET_DEV "/proc/net/dev"
-#define PROC_LOADAVG "/proc/loadavg"
-#define INTERFACE_NAME_SIZE 32
-#define SDA_DISK "sda"
+#define DISK_TABLE_INITIAL_CAPACITY 64
+#define NET_INDEX_INITIAL_CAPACITY 32
 
 // Función para obtener el uso de memoria
 double get_memory_usage() {
-  FILE *fp;
-  char buffer[MEMINFO_BUFFER_SIZE];
+  ProcCursor cursor, line;
+  size_t length;
   unsigned long long total_mem = 0, free_mem = 0;
 
-  // Abrir el archivo /proc/meminfo
-  fp = fopen(PROC_MEMINFO, "r");
-  if (fp == NULL) {
-    perror("Error al abrir " PROC_MEMINFO);
+  // Releer /proc/meminfo desde el descriptor persistente
+  const char *buffer = proc_file_read(PROC_FILE_MEMINFO, &length);
+  if (buffer == NULL) {
     return -1.0;
   }
+  proc_cursor_init(&cursor, buffer, length);
 
   // Leer los valores de memoria total y disponible
-  while (fgets(buffer, sizeof(buffer), fp) != NULL) {
-    if (sscanf(buffer, "MemTotal: %llu kB", &total_mem) == 1) {
+  while (proc_next_line(&cursor, &line)) {
+    if (proc_consume_prefix(&line, "MemTotal:", 9)) {
+      proc_parse_u64(&line, &total_mem);
       continue; // MemTotal encontrado
     }
-    if (sscanf(buffer, "MemAvailable: %llu kB", &free_mem) == 1) {
+    if (proc_consume_prefix(&line, "MemAvailable:", 13)) {
+      proc_parse_u64(&line, &free_mem);
       break; // MemAvailable encontrado, podemos dejar de leer
     }
   }
 
-  fclose(fp);
-
   // Verificar si se encontraron ambos valores
   if (total_mem == 0 || free_mem == 0) {
     fprintf(stderr,
@@ -55,202 +53,638 @@ double get_memory_usage() {
   return mem_usage_percent;
 }
 
-double get_cpu_usage() {
-  static unsigned long long prev_user = 0, prev_nice = 0, prev_system = 0,
-                            prev_idle = 0, prev_iowait = 0, prev_irq = 0,
-                            prev_softirq = 0, prev_steal = 0;
-  unsigned long long user, nice, system, idle, iowait, irq, softirq, steal;
-  unsigned long long totald, idled;
-  static double cpu_usage_percent =
-      0.0; // Valor inicial para mantener el último valor válido
+// Instantáneas de /proc/stat: la actual y la del tick anterior
+static ProcStatSnapshot stat_snapshots[2];
+static int current_snapshot = 0;
+
+// Si la última lectura de /proc/stat fue correcta
+static int stat_valid = 0;
+
+// Contadores de una sola columna de /proc/stat y su campo en la instantánea
+static const struct {
+  const char *key;
+  size_t key_length;
+  size_t offset;
+} stat_counters[] = {
+    {"ctxt ", 5, offsetof(ProcStatSnapshot, ctxt)},
+    {"intr ", 5, offsetof(ProcStatSnapshot, intr)},
+    {"softirq ", 8, offsetof(ProcStatSnapshot, softirq)},
+    {"processes ", 10, offsetof(ProcStatSnapshot, processes)},
+    {"procs_running ", 14, offsetof(ProcStatSnapshot, procs_running)},
+    {"procs_blocked ", 14, offsetof(ProcStatSnapshot, procs_blocked)},
+};
+#define STAT_COUNTER_COUNT (sizeof(stat_counters) / sizeof(stat_counters[0]))
+
+// Uso por núcleo del tick actual
+static CpuCoreUsage core_usage;
+
+// Suma de las diferencias de todos los modos por núcleo (búfer de trabajo)
+static double *core_total_delta;
+
+// Parsea los ocho valores de una línea "cpu" o "cpuN"
+static int parse_cpu_times(ProcCursor *values,
+                           unsigned long long times[CPU_MODE_COUNT]) {
+  return proc_parse_u64_array(values, times, CPU_MODE_COUNT) == CPU_MODE_COUNT
+             ? 0
+             : -1;
+}
+
+// Asegura espacio en las columnas por modo y de presencia para el núcleo
+// "cpu". Todas las columnas comparten un único bloque para mantenerlas
+// contiguas en memoria.
+static int snapshot_reserve_cpu(ProcStatSnapshot *snapshot, unsigned int cpu) {
+  if (cpu < snapshot->cpu_capacity) {
+    return 0;
+  }
+
+  size_t new_capacity = snapshot->cpu_capacity ? snapshot->cpu_capacity : 8;
+  while (new_capacity <= cpu) {
+    new_capacity *= 2;
+  }
+
+  unsigned long long *block =
+      calloc((CPU_MODE_COUNT + 1) * new_capacity, sizeof(unsigned long long));
+  if (block == NULL) {
+    return -1;
+  }
+  unsigned long long *present = block + CPU_MODE_COUNT * new_capacity;
+  if (snapshot->cpu_present != NULL) {
+    memcpy(present, snapshot->cpu_present,
+           snapshot->cpu_count * sizeof(unsigned long long));
+  }
+  snapshot->cpu_present = present;
+  // La primera columna apunta al inicio del bloque anterior
+  unsigned long long *old_block = snapshot->cpu_times[0];
+  for (int mode = 0; mode < CPU_MODE_COUNT; mode++) {
+    unsigned long long *column = block + mode * new_capacity;
+    if (snapshot->cpu_times[mode] != NULL) {
+      memcpy(column, snapshot->cpu_times[mode],
+             snapshot->cpu_count * sizeof(unsigned long long));
+    }
+    snapshot->cpu_times[mode] = column;
+  }
+  free(old_block);
+  snapshot->cpu_capacity = new_capacity;
+  return 0;
+}
+
+// Asegura espacio en las columnas de uso por núcleo
+static int core_usage_reserve(size_t count) {
+  if (count <= core_usage.capacity) {
+    return 0;
+  }
+
+  double *block = calloc((CPU_MODE_COUNT + 1) * count, sizeof(double));
+  if (block == NULL) {
+    return -1;
+  }
+  free(core_total_delta);
+  core_total_delta = block;
+  for (int mode = 0; mode < CPU_MODE_COUNT; mode++) {
+    core_usage.percent[mode] = block + (mode + 1) * count;
+  }
+  core_usage.capacity = count;
+  return 0;
+}
+
+// Calcula el porcentaje de cada modo por núcleo entre dos instantáneas. Cada
+// bucle recorre columnas planas sin dependencias entre iteraciones, de modo
+// que el compilador puede vectorizarlo.
+static void compute_core_usage(const ProcStatSnapshot *prev,
+                               const ProcStatSnapshot *cur) {
+  size_t n = prev->cpu_count < cur->cpu_count ? prev->cpu_count
+                                              : cur->cpu_count;
+  if (core_usage_reserve(n) != 0) {
+    core_usage.core_count = 0;
+    return;
+  }
+
+  double *restrict total = core_total_delta;
+  const unsigned long long *restrict cur_present = cur->cpu_present;
+  const unsigned long long *restrict prev_present = prev->cpu_present;
+  for (size_t i = 0; i < n; i++) {
+    total[i] = 0.0;
+  }
+
+  for (int mode = 0; mode < CPU_MODE_COUNT; mode++) {
+    const unsigned long long *restrict c = cur->cpu_times[mode];
+    const unsigned long long *restrict p = prev->cpu_times[mode];
+    double *restrict delta = core_usage.percent[mode];
+    for (size_t i = 0; i < n; i++) {
+      // Un núcleo que falta en alguna lectura (fuera de línea o un hueco en
+      // la numeración) no tiene diferencias válidas: la máscara las deja en 0
+      unsigned long long mask = 0ULL - (cur_present[i] & prev_present[i]);
+      // La diferencia de un intervalo cabe en 32 bits; convertir desde int
+      // permite usar la conversión vectorial a double
+      delta[i] = (double)(int)((c[i] - p[i]) & mask);
+      total[i] += delta[i];
+    }
+  }
+
+  // Convertimos el total en un factor de escala. Si el núcleo no avanzó, todas
+  // sus diferencias son 0 y dividir por 1 evita la rama dentro del bucle.
+  for (size_t i = 0; i < n; i++) {
+    total[i] = 100.0 / (total[i] + (double)(total[i] == 0.0));
+  }
 
-  // Abrir el archivo /proc/stat
-  FILE *fp = fopen(PROC_STAT, "r");
-  if (fp == NULL) {
-    perror("Error al abrir " PROC_STAT);
-    return cpu_usage_percent;
+  for (int mode = 0; mode < CPU_MODE_COUNT; mode++) {
+    double *restrict percent = core_usage.percent[mode];
+    for (size_t i = 0; i < n; i++) {
+      percent[i] *= total[i];
+    }
   }
 
-  char buffer[STAT_BUFFER_SIZE];
-  if (fgets(buffer, sizeof(buffer), fp) == NULL) {
-    perror("Error al leer " PROC_STAT);
-    fclose(fp);
-    return cpu_usage_percent;
+  core_usage.core_count = n;
+}
+
+int refresh_proc_stat() {
+  ProcCursor cursor, line;
+  size_t length;
+
+  // Releer /proc/stat desde el descriptor persistente
+  const char *buffer = proc_file_read(PROC_FILE_STAT, &length);
+  if (buffer == NULL) {
+    stat_valid = 0;
+    return -1;
+  }
+  proc_cursor_init(&cursor, buffer, length);
+
+  // La instantánea actual pasa a ser la anterior; reutilizamos la otra
+  current_snapshot ^= 1;
+  ProcStatSnapshot *snapshot = &stat_snapshots[current_snapshot];
+  if (snapshot->cpu_present != NULL) {
+    memset(snapshot->cpu_present, 0,
+           snapshot->cpu_capacity * sizeof(unsigned long long));
   }
-  fclose(fp);
+  snapshot->cpu_count = 0;
+
+  while (proc_next_line(&cursor, &line)) {
+    unsigned long long times[CPU_MODE_COUNT];
+    unsigned long long cpu;
+
+    if (proc_consume_prefix(&line, "cpu", 3)) {
+      if (line.pos < line.end && *line.pos == ' ') {
+        if (parse_cpu_times(&line, times) != 0) {
+          fprintf(stderr, "Error al parsear " PROC_STAT "\n");
+          continue;
+        }
+        snapshot->total =
+            (CpuTimes){times[CPU_MODE_USER],    times[CPU_MODE_NICE],
+                       times[CPU_MODE_SYSTEM],  times[CPU_MODE_IDLE],
+                       times[CPU_MODE_IOWAIT],  times[CPU_MODE_IRQ],
+                       times[CPU_MODE_SOFTIRQ], times[CPU_MODE_STEAL]};
+      } else if (proc_parse_u64(&line, &cpu) &&
+                 parse_cpu_times(&line, times) == 0 &&
+                 snapshot_reserve_cpu(snapshot, (unsigned int)cpu) == 0) {
+        // Dispersamos la línea en las columnas por modo
+        for (int mode = 0; mode < CPU_MODE_COUNT; mode++) {
+          snapshot->cpu_times[mode][cpu] = times[mode];
+        }
+        snapshot->cpu_present[cpu] = 1;
+        if (cpu >= snapshot->cpu_count) {
+          snapshot->cpu_count = cpu + 1;
+        }
+      }
+      continue;
+    }
 
-  // Analizar los valores de tiempo de CPU
-  int ret =
-      sscanf(buffer, "cpu  %llu %llu %llu %llu %llu %llu %llu %llu", &user,
-             &nice, &system, &idle, &iowait, &irq, &softirq, &steal);
-  if (ret < 8) {
-    fprintf(stderr, "Error al parsear " PROC_STAT "\n");
-    return cpu_usage_percent;
+    for (size_t i = 0; i < STAT_COUNTER_COUNT; i++) {
+      if (proc_consume_prefix(&line, stat_counters[i].key,
+                              stat_counters[i].key_length)) {
+        unsigned long long *value =
+            (unsigned long long *)((char *)snapshot + stat_counters[i].offset);
+        proc_parse_u64(&line, value);
+        break;
+      }
+    }
   }
 
+  compute_core_usage(&stat_snapshots[current_snapshot ^ 1], snapshot);
+  stat_valid = 1;
+  return 0;
+}
+
+const ProcStatSnapshot *get_proc_stat_snapshot() {
+  return &stat_snapshots[current_snapshot];
+}
+
+const CpuCoreUsage *get_cpu_core_usage() { return &core_usage; }
+
+double get_cpu_usage() {
+  static double cpu_usage_percent =
+      0.0; // Valor inicial para mantener el último valor válido
+  const CpuTimes *prev = &stat_snapshots[current_snapshot ^ 1].total;
+  const CpuTimes *cur = &stat_snapshots[current_snapshot].total;
+
   // Calcular las diferencias entre las lecturas actuales y anteriores
-  unsigned long long prev_idle_total = prev_idle + prev_iowait;
-  unsigned long long idle_total = idle + iowait;
+  unsigned long long prev_idle_total = prev->idle + prev->iowait;
+  unsigned long long idle_total = cur->idle + cur->iowait;
 
-  unsigned long long prev_non_idle = prev_user + prev_nice + prev_system +
-                                     prev_irq + prev_softirq + prev_steal;
-  unsigned long long non_idle = user + nice + system + irq + softirq + steal;
+  unsigned long long prev_non_idle = prev->user + prev->nice + prev->system +
+                                     prev->irq + prev->softirq + prev->steal;
+  unsigned long long non_idle =
+      cur->user + cur->nice + cur->system + cur->irq + cur->softirq + cur->steal;
 
   unsigned long long prev_total = prev_idle_total + prev_non_idle;
   unsigned long long total = idle_total + non_idle;
 
-  totald = total - prev_total;
-  idled = idle_total - prev_idle_total;
+  unsigned long long totald = total - prev_total;
+  unsigned long long idled = idle_total - prev_idle_total;
 
   if (totald == 0) {
-    fprintf(stderr,
-            "Totald es cero, manteniendo el último valor de uso de CPU\n");
     return cpu_usage_percent; // Retorna el último valor válido en lugar de -1
   }
 
   // Calcular el porcentaje de uso de CPU
   cpu_usage_percent = ((double)(totald - idled) / totald) * 100.0;
 
-  // Actualizar los valores anteriores para la siguiente lectura
-  prev_user = user;
-  prev_nice = nice;
-  prev_system = system;
-  prev_idle = idle;
-  prev_iowait = iowait;
-  prev_irq = irq;
-  prev_softirq = softirq;
-  prev_steal = steal;
-
   return cpu_usage_percent;
 }
 
-// Función para obtener estadísticas de disco
-DiskStats get_disk_stats() {
-  FILE *fp;
-  char buffer[DISKSTATS_BUFFER_SIZE];
-  DiskStats stats = {0, 0, 0, 0}; // Inicializar a 0
-
-  // Abrir el archivo /proc/diskstats
-  fp = fopen(PROC_DISKSTATS, "r");
-  if (fp == NULL) {
-    perror("Error al abrir " PROC_DISKSTATS);
-    return stats;
-  }
-
-  // Leer estadísticas de disco para el disco 'sda'
-  while (fgets(buffer, sizeof(buffer), fp) != NULL) {
-    unsigned int major, minor;
-    char device_name[INTERFACE_NAME_SIZE];
-    unsigned long long rd_ios, rd_merges, rd_sectors, rd_ticks, wr_ios,
-        wr_merges, wr_sectors, wr_ticks;
-
-    // leer las columnas relevantes de /proc/diskstats
-    int ret =
-        sscanf(buffer, "%u %u %s %llu %llu %llu %llu %llu %llu %llu %llu",
-               &major, &minor, device_name, &rd_ios, &rd_merges, &rd_sectors,
-               &rd_ticks, &wr_ios, &wr_merges, &wr_sectors, &wr_ticks);
-
-    // Verifica si sscanf logró capturar todas las columnas esperadas
-    if (ret >= 11) {
-
-      if (strcmp(device_name, SDA_DISK) == 0) {
-
-        stats.reads = rd_ios;
-        stats.writes = wr_ios;
-        stats.read_time = rd_ticks;
-        stats.write_time = wr_ticks;
-        break; // Encontrado el disco, salir del bucle
+// Las columnas de /proc/diskstats se leen directamente sobre DiskStats
+_Static_assert(sizeof(DiskStats) ==
+                   DISK_STATS_FIELD_COUNT * sizeof(unsigned long long),
+               "DiskStats debe coincidir con las columnas de " PROC_DISKSTATS);
+
+// Tabla de dispositivos de bloques y momento del último refresco
+static DiskTable disk_table;
+static struct timespec disk_last_refresh;
+
+// Posición inicial de un dispositivo en una tabla de "capacity" entradas
+static size_t disk_slot_index(unsigned int major, unsigned int minor,
+                              size_t capacity) {
+  // Igual que dev_t en el kernel: el número menor ocupa 20 bits
+  unsigned long long key = ((unsigned long long)major << 20) | minor;
+  return (size_t)((key * 0x9E3779B97F4A7C15ULL) >> 32) & (capacity - 1);
+}
+
+// Busca un dispositivo por major:minor; si no existe y "insert" es distinto de
+// 0, ocupa la primera entrada libre de su secuencia de sondeo
+static DiskDevice *disk_table_lookup(DiskTable *table, unsigned int major,
+                                     unsigned int minor, int insert) {
+  size_t mask = table->capacity - 1;
+  size_t index = disk_slot_index(major, minor, table->capacity);
+
+  while (table->slots[index].in_use) {
+    DiskDevice *device = &table->slots[index];
+    if (device->major == major && device->minor == minor) {
+      return device;
+    }
+    index = (index + 1) & mask;
+  }
+
+  if (!insert) {
+    return NULL;
+  }
+
+  DiskDevice *device = &table->slots[index];
+  memset(device, 0, sizeof(*device));
+  device->major = major;
+  device->minor = minor;
+  device->in_use = 1;
+  table->count++;
+  return device;
+}
+
+// Reconstruye la tabla con otra capacidad. Con "drop_stale" distinto de 0 se
+// descartan los dispositivos que no aparecieron en el refresco actual.
+static int disk_table_rehash(DiskTable *table, size_t capacity,
+                             int drop_stale) {
+  DiskDevice *old_slots = table->slots;
+  size_t old_capacity = table->capacity;
+
+  DiskDevice *slots = calloc(capacity, sizeof(DiskDevice));
+  if (slots == NULL) {
+    return -1;
+  }
+  table->slots = slots;
+  table->capacity = capacity;
+  table->count = 0;
+
+  for (size_t i = 0; i < old_capacity; i++) {
+    DiskDevice *old = &old_slots[i];
+    if (!old->in_use ||
+        (drop_stale && old->last_seen != table->generation)) {
+      continue;
+    }
+    *disk_table_lookup(table, old->major, old->minor, 1) = *old;
+  }
+
+  free(old_slots);
+  return 0;
+}
+
+// Calcula utilización y latencias del intervalo a partir de stats y prev
+static void disk_compute_rates(DiskDevice *device, double interval_ms) {
+  const DiskStats *cur = &device->stats;
+  const DiskStats *prev = &device->prev;
+
+  double reads = (double)(cur->reads - prev->reads);
+  double writes = (double)(cur->writes - prev->writes);
+  double read_time = (double)(cur->read_time - prev->read_time);
+  double write_time = (double)(cur->write_time - prev->write_time);
+  double io_ticks = (double)(cur->io_ticks - prev->io_ticks);
+
+  device->utilization =
+      interval_ms > 0.0 ? io_ticks * 100.0 / interval_ms : 0.0;
+  if (device->utilization > 100.0) {
+    device->utilization = 100.0;
+  }
+  device->read_await = reads > 0.0 ? read_time / reads : 0.0;
+  device->write_await = writes > 0.0 ? write_time / writes : 0.0;
+  device->await = reads + writes > 0.0
+                      ? (read_time + write_time) / (reads + writes)
+                      : 0.0;
+}
+
+int refresh_disk_stats() {
+  ProcCursor cursor, line, device_name;
+  size_t length;
+  struct timespec now;
+
+  // Releer /proc/diskstats desde el descriptor persistente
+  const char *buffer = proc_file_read(PROC_FILE_DISKSTATS, &length);
+  if (buffer == NULL) {
+    return -1;
+  }
+  proc_cursor_init(&cursor, buffer, length);
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  disk_table.interval_ms =
+      disk_table.generation == 0
+          ? 0.0
+          : (double)(now.tv_sec - disk_last_refresh.tv_sec) * 1000.0 +
+                (double)(now.tv_nsec - disk_last_refresh.tv_nsec) / 1e6;
+  disk_last_refresh = now;
+  disk_table.generation++;
+
+  size_t seen = 0;
+  while (proc_next_line(&cursor, &line)) {
+    unsigned long long major, minor;
+
+    if (!proc_parse_u64(&line, &major) || !proc_parse_u64(&line, &minor) ||
+        !proc_next_field(&line, &device_name)) {
+      fprintf(stderr, "Línea de " PROC_DISKSTATS " incompleta\n");
+      continue;
+    }
+
+    // Mantenemos la ocupación por debajo del 75% para sondeos cortos
+    if ((disk_table.count + 1) * 4 > disk_table.capacity * 3 &&
+        disk_table_rehash(&disk_table,
+                          disk_table.capacity ? disk_table.capacity * 2
+                                              : DISK_TABLE_INITIAL_CAPACITY,
+                          0) != 0) {
+      return -1;
+    }
+
+    DiskDevice *device = disk_table_lookup(&disk_table, (unsigned int)major,
+                                           (unsigned int)minor, 1);
+    int is_new = device->last_seen == 0;
+    DiskStats previous = device->stats;
+
+    // Los kernels antiguos reportan 11 o 15 campos; el resto queda en 0
+    memset(&device->stats, 0, sizeof(device->stats));
+    if (proc_parse_u64_array(&line, (unsigned long long *)&device->stats,
+                             DISK_STATS_FIELD_COUNT) < 11) {
+      fprintf(stderr, "Línea de " PROC_DISKSTATS " incompleta\n");
+      device->stats = previous;
+      if (is_new) {
+        device->in_use = 0;
+        disk_table.count--;
       }
+      continue;
+    }
+
+    if (is_new) {
+      // Primer refresco del dispositivo: el intervalo todavía no existe
+      proc_field_copy(&device_name, device->name, sizeof(device->name));
+      device->prev = device->stats;
     } else {
-      printf("sscanf no pudo leer las 11 columnas. Retorno: %d\n",
-             ret); // Depuración para ver por qué falla
+      device->prev = previous;
     }
+    device->last_seen = disk_table.generation;
+    disk_compute_rates(device, disk_table.interval_ms);
+    seen++;
+  }
+
+  // Si desapareció algún dispositivo, reconstruimos la tabla sin él
+  if (seen < disk_table.count &&
+      disk_table_rehash(&disk_table, disk_table.capacity, 1) != 0) {
+    return -1;
   }
 
-  fclose(fp);
-  return stats;
+  return 0;
 }
 
-// Función para obtener estadísticas de red
-NetStats get_network_stats(const char *interface_name) {
-  FILE *fp;
-  char buffer[NETDEV_BUFFER_SIZE];
-  NetStats stats = {0, 0, 0, 0};        // Inicializar las métricas a 0
-  char iface_name[INTERFACE_NAME_SIZE]; // Variable para almacenar temporalmente
-                                        // el nombre de la interfaz
-
-  // Abrir el archivo /proc/net/dev
-  fp = fopen(PROC_NET_DEV, "r");
-  if (fp == NULL) {
-    perror("Error al abrir " PROC_NET_DEV);
-    return stats;
-  }
-
-  // Leer el archivo línea por línea
-  while (fgets(buffer, sizeof(buffer), fp) != NULL) {
-    // Leer el nombre de la interfaz y saltar el resto de los datos para
-    // verificar si es la interfaz correcta
-    sscanf(buffer, "%31[^:]:", iface_name);
-
-    // Comprobamos si la interfaz coincide con la que estamos buscando
-    if (strcmp(iface_name, interface_name) == 0) {
-      // Si es la interfaz correcta, ahora leemos los valores de bytes y
-      // paquetes
-      sscanf(buffer, "%*[^:]: %llu %llu %*u %*u %*u %*u %*u %*u %llu %llu",
-             &stats.bytes_received, &stats.packets_received,
-             &stats.bytes_transmitted, &stats.packets_transmitted);
-      break; // Salir del bucle una vez encontrada la interfaz
-    }
+const DiskTable *get_disk_table() { return &disk_table; }
+
+// Las columnas de /proc/net/dev se leen directamente sobre NetStats
+_Static_assert(sizeof(NetStats) ==
+                   NET_STATS_FIELD_COUNT * sizeof(unsigned long long),
+               "NetStats debe coincidir con las columnas de " PROC_NET_DEV);
+
+// Tabla de interfaces de red y momento del último refresco
+static NetTable net_table;
+static struct timespec net_last_refresh;
+
+// Hash FNV-1a del nombre de una interfaz
+static unsigned int net_name_hash(const char *name, size_t length) {
+  unsigned int hash = 2166136261u;
+  for (size_t i = 0; i < length; i++) {
+    hash = (hash ^ (unsigned char)name[i]) * 16777619u;
   }
+  return hash;
+}
 
-  fclose(fp);
-  return stats;
+// Devuelve la entrada del índice que corresponde al nombre: la que apunta a
+// la interfaz si ya existe, o la primera libre de su secuencia de sondeo
+static size_t net_index_probe(const NetTable *table, const char *name,
+                              size_t length, unsigned int hash) {
+  size_t mask = table->index_capacity - 1;
+  size_t slot = hash & mask;
+
+  while (table->index[slot] >= 0) {
+    const NetInterface *iface = &table->interfaces[table->index[slot]];
+    // Solo se comparan los nombres cuando coinciden hash y longitud
+    if (iface->hash == hash && iface->name_length == length &&
+        memcmp(iface->name, name, length) == 0) {
+      return slot;
+    }
+    slot = (slot + 1) & mask;
+  }
+  return slot;
 }
 
-// Función para obtener el número de procesos en ejecución
-int get_running_processes() {
-  FILE *fp;
-  char buffer[LOADAVG_BUFFER_SIZE];
-  int running_processes = 0, total_processes = 0;
-
-  // Abrir el archivo /proc/loadavg
-  fp = fopen(PROC_LOADAVG, "r");
-  if (fp == NULL) {
-    perror("Error al abrir " PROC_LOADAVG);
+// Reconstruye el índice con otra capacidad a partir del arreglo de interfaces
+static int net_index_rebuild(NetTable *table, size_t capacity) {
+  int *index = malloc(capacity * sizeof(int));
+  if (index == NULL) {
     return -1;
   }
+  for (size_t i = 0; i < capacity; i++) {
+    index[i] = -1;
+  }
 
-  // Leer el contenido del archivo
-  if (fgets(buffer, sizeof(buffer), fp) != NULL) {
-    // Extraer el número de procesos en ejecución y el total de procesos
-    sscanf(buffer, "%*f %*f %*f %d/%d", &running_processes, &total_processes);
+  free(table->index);
+  table->index = index;
+  table->index_capacity = capacity;
+
+  for (size_t i = 0; i < table->count; i++) {
+    const NetInterface *iface = &table->interfaces[i];
+    size_t slot =
+        net_index_probe(table, iface->name, iface->name_length, iface->hash);
+    table->index[slot] = (int)i;
   }
+  return 0;
+}
 
-  fclose(fp);
-  return running_processes; // Devolver el número de procesos en ejecución
+// Agrega una interfaz nueva al final del arreglo y la registra en el índice
+static NetInterface *net_table_insert(NetTable *table, size_t slot,
+                                      const char *name, size_t length,
+                                      unsigned int hash) {
+  if (table->count == table->allocated) {
+    size_t allocated = table->allocated ? table->allocated * 2 : 8;
+    NetInterface *interfaces =
+        realloc(table->interfaces, allocated * sizeof(NetInterface));
+    if (interfaces == NULL) {
+      return NULL;
+    }
+    table->interfaces = interfaces;
+    table->allocated = allocated;
+  }
+
+  NetInterface *iface = &table->interfaces[table->count];
+  memset(iface, 0, sizeof(*iface));
+  memcpy(iface->name, name, length);
+  iface->name[length] = '\0';
+  iface->name_length = length;
+  iface->hash = hash;
+  table->index[slot] = (int)table->count;
+  table->count++;
+  return iface;
 }
 
-// Función para obtener el número de cambios de contexto
-unsigned long long get_context_switches() {
-  FILE *fp;
-  char buffer[STAT_BUFFER_SIZE];
-  unsigned long long context_switches = 0;
-
-  // Abrir el archivo /proc/stat
-  fp = fopen(PROC_STAT, "r");
-  if (fp == NULL) {
-    perror("Error al abrir " PROC_STAT);
-    return 0;
+int refresh_network_stats() {
+  ProcCursor cursor, line, iface_name;
+  size_t length;
+  struct timespec now;
+
+  // Releer /proc/net/dev desde el descriptor persistente
+  const char *buffer = proc_file_read(PROC_FILE_NET_DEV, &length);
+  if (buffer == NULL) {
+    return -1;
+  }
+  proc_cursor_init(&cursor, buffer, length);
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  net_table.interval_seconds =
+      net_table.generation == 0
+          ? 0.0
+          : (double)(now.tv_sec - net_last_refresh.tv_sec) +
+                (double)(now.tv_nsec - net_last_refresh.tv_nsec) / 1e9;
+  net_last_refresh = now;
+  net_table.generation++;
+
+  size_t seen = 0;
+  while (proc_next_line(&cursor, &line)) {
+    // Separar el nombre de la interfaz (antes de ':') del resto de los datos;
+    // las líneas de encabezado no tienen ':'
+    if (!proc_split_at(&line, ':', &iface_name)) {
+      continue;
+    }
+    proc_skip_spaces(&iface_name);
+
+    size_t name_length = (size_t)(iface_name.end - iface_name.pos);
+    if (name_length >= NET_INTERFACE_NAME_SIZE) {
+      name_length = NET_INTERFACE_NAME_SIZE - 1;
+    }
+    unsigned int hash = net_name_hash(iface_name.pos, name_length);
+
+    // Mantenemos el índice ocupado a lo sumo a la mitad
+    if ((net_table.count + 1) * 2 > net_table.index_capacity &&
+        net_index_rebuild(&net_table, net_table.index_capacity
+                                          ? net_table.index_capacity * 2
+                                          : NET_INDEX_INITIAL_CAPACITY) != 0) {
+      return -1;
+    }
+
+    size_t slot =
+        net_index_probe(&net_table, iface_name.pos, name_length, hash);
+    int is_new = net_table.index[slot] < 0;
+    NetInterface *iface =
+        is_new ? net_table_insert(&net_table, slot, iface_name.pos,
+                                  name_length, hash)
+               : &net_table.interfaces[net_table.index[slot]];
+    if (iface == NULL) {
+      return -1;
+    }
+
+    NetStats previous = iface->stats;
+    if (proc_parse_u64_array(&line, (unsigned long long *)&iface->stats,
+                             NET_STATS_FIELD_COUNT) != NET_STATS_FIELD_COUNT) {
+      fprintf(stderr, "Línea de " PROC_NET_DEV " incompleta\n");
+      iface->stats = previous;
+    }
+    // En el primer refresco de la interfaz el intervalo todavía no existe
+    iface->prev = is_new ? iface->stats : previous;
+    iface->last_seen = net_table.generation;
+    seen++;
+
+    // Tasas por segundo del intervalo medido con CLOCK_MONOTONIC
+    double seconds = net_table.interval_seconds;
+    const NetStats *cur = &iface->stats;
+    const NetStats *prev = &iface->prev;
+    iface->rx_bytes_rate =
+        seconds > 0.0 ? (cur->bytes_received - prev->bytes_received) / seconds
+                      : 0.0;
+    iface->tx_bytes_rate =
+        seconds > 0.0
+            ? (cur->bytes_transmitted - prev->bytes_transmitted) / seconds
+            : 0.0;
+    iface->rx_packets_rate =
+        seconds > 0.0
+            ? (cur->packets_received - prev->packets_received) / seconds
+            : 0.0;
+    iface->tx_packets_rate =
+        seconds > 0.0
+            ? (cur->packets_transmitted - prev->packets_transmitted) / seconds
+            : 0.0;
   }
 
-  // Leer el archivo línea por línea
-  while (fgets(buffer, sizeof(buffer), fp) != NULL) {
-    // Buscamos la línea que comienza con "ctxt"
-    if (sscanf(buffer, "ctxt %llu", &context_switches) == 1) {
-      break; // Hemos encontrado la línea de cambios de contexto
+  // Si desapareció alguna interfaz, compactamos el arreglo y rehacemos el
+  // índice
+  if (seen < net_table.count) {
+    size_t kept = 0;
+    for (size_t i = 0; i < net_table.count; i++) {
+      if (net_table.interfaces[i].last_seen == net_table.generation) {
+        net_table.interfaces[kept++] = net_table.interfaces[i];
+      }
     }
+    net_table.count = kept;
+    if (net_index_rebuild(&net_table, net_table.index_capacity) != 0) {
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+const NetTable *get_network_table() { return &net_table; }
+
+// Función para obtener el número de procesos en ejecución
+int get_running_processes() {
+  // procs_running ya viene en la instantánea de /proc/stat del tick
+  if (!stat_valid) {
+    return -1;
   }
+  return (int)get_proc_stat_snapshot()->procs_running;
+}
 
-  fclose(fp);
-  return context_switches; // número total de cambios de contexto
+// Función para obtener el número de cambios de contexto
+unsigned long long get_context_switches() {
+  // ctxt ya viene en la instantánea de /proc/stat del tick
+  if (!stat_valid) {
+    return 0;
+  }
+  return get_proc_stat_snapshot()->ctxt;
 }
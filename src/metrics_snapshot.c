@@ -0,0 +1,105 @@
+#include "../include/metrics_snapshot.h"
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+// El índice intermedio lleva este bit cuando contiene una instantánea que el
+// exportador todavía no tomó
+#define SNAPSHOT_FRESH 4u
+#define SNAPSHOT_INDEX_MASK 3u
+
+/** Tres instantáneas: una del recolector, una del exportador y una intermedia */
+static MetricsSnapshot buffers[3];
+
+/** Índice de la instantánea intermedia, compartido entre ambos hilos */
+static _Atomic unsigned int middle = 1;
+
+/** Índice de la instantánea en construcción (solo el recolector) */
+static unsigned int back = 0;
+
+/** Índice de la instantánea en lectura (solo el exportador) */
+static unsigned int front = 2;
+
+/** Número de tick publicado por última vez */
+static unsigned long long generation = 0;
+
+/** eventfd con el que el recolector avisa al exportador */
+static int wake_fd = -1;
+
+int snapshot_init() {
+  wake_fd = eventfd(0, EFD_CLOEXEC);
+  if (wake_fd < 0) {
+    perror("Error al crear el eventfd de instantáneas");
+    return -1;
+  }
+  return 0;
+}
+
+void snapshot_gauge_set(prom_gauge_t *metric, double value,
+                        const char **labels, size_t label_count) {
+  MetricsSnapshot *snapshot = &buffers[back];
+
+  if (snapshot->count == snapshot->capacity) {
+    size_t capacity = snapshot->capacity ? snapshot->capacity * 2 : 256;
+    SnapshotSample *samples =
+        realloc(snapshot->samples, capacity * sizeof(SnapshotSample));
+    if (samples == NULL) {
+      fprintf(stderr, "Error al reservar muestras de la instantánea\n");
+      return;
+    }
+    snapshot->samples = samples;
+    snapshot->capacity = capacity;
+  }
+
+  SnapshotSample *sample = &snapshot->samples[snapshot->count++];
+  sample->metric = metric;
+  sample->value = value;
+  sample->label_count =
+      label_count < SNAPSHOT_MAX_LABELS ? label_count : SNAPSHOT_MAX_LABELS;
+  for (size_t i = 0; i < sample->label_count; i++) {
+    strncpy(sample->labels[i], labels[i], SNAPSHOT_LABEL_SIZE - 1);
+    sample->labels[i][SNAPSHOT_LABEL_SIZE - 1] = '\0';
+  }
+}
+
+void snapshot_publish() {
+  buffers[back].generation = ++generation;
+
+  // La instantánea terminada pasa a ser la intermedia; la release garantiza
+  // que el exportador vea todas sus escrituras
+  back = atomic_exchange_explicit(&middle, back | SNAPSHOT_FRESH,
+                                  memory_order_acq_rel) &
+         SNAPSHOT_INDEX_MASK;
+  buffers[back].count = 0;
+
+  uint64_t one = 1;
+  if (wake_fd >= 0 && write(wake_fd, &one, sizeof(one)) < 0 &&
+      errno != EAGAIN) {
+    perror("Error al notificar una instantánea nueva");
+  }
+}
+
+void snapshot_wait() {
+  uint64_t pending;
+  if (wake_fd < 0) {
+    sleep(1);
+    return;
+  }
+  while (read(wake_fd, &pending, sizeof(pending)) < 0 && errno == EINTR) {
+  }
+}
+
+const MetricsSnapshot *snapshot_acquire() {
+  // Solo intercambiamos si hay una instantánea nueva; si no, seguimos con la
+  // que ya teníamos
+  if (atomic_load_explicit(&middle, memory_order_relaxed) & SNAPSHOT_FRESH) {
+    front = atomic_exchange_explicit(&middle, front, memory_order_acq_rel) &
+            SNAPSHOT_INDEX_MASK;
+  }
+  return buffers[front].generation > 0 ? &buffers[front] : NULL;
+}
@@ -0,0 +1,360 @@
+#include "../include/monitor_pipe.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// Espera entre intentos de abrir el pipe mientras no hay lector
+#define MONITOR_PIPE_RETRY_MS 500
+
+/**
+ * @brief Registro encolado. El búfer se conserva al vaciar la entrada.
+ */
+typedef struct {
+  char *data;      ///< Contenido del registro
+  size_t length;   ///< Longitud del registro en bytes
+  size_t capacity; ///< Capacidad reservada en data
+} PipeRecord;
+
+/** Cola circular de registros pendientes */
+static PipeRecord *queue = NULL;
+static size_t queue_head = 0;
+static size_t queue_count = 0;
+static MonitorPipeConfig pipe_config;
+
+/** Estadísticas, protegidas por queue_lock */
+static MonitorPipeStats stats;
+
+static pthread_mutex_t queue_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t queue_not_empty = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t queue_not_full = PTHREAD_COND_INITIALIZER;
+static pthread_t publisher;
+static atomic_int running = 0;
+
+/** Descriptor del pipe, o -1 si está cerrado (solo el hilo publicador) */
+static int pipe_fd = -1;
+
+/** Datos enviados al abrir el pipe, antes del primer registro */
+static char *preamble = NULL;
+static size_t preamble_length = 0;
+
+static double now_seconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static int monitor_pipe_open(void) {
+  // Como antes con fopen("a"), si la ruta no existe se crea un archivo normal
+  pipe_fd = open(MONITOR_PIPE_PATH,
+                 O_WRONLY | O_APPEND | O_CREAT | O_NONBLOCK | O_CLOEXEC, 0644);
+  if (pipe_fd < 0) {
+    // ENXIO: el FIFO existe pero todavía no hay lector
+    if (errno != ENXIO) {
+      perror("Error al abrir el pipe para enviar métricas");
+    }
+    return -1;
+  }
+  return 0;
+}
+
+static void monitor_pipe_close(void) {
+  if (pipe_fd >= 0) {
+    close(pipe_fd);
+    pipe_fd = -1;
+  }
+}
+
+// Escribe el registro completo. Con un lector lento espera a que el pipe
+// acepte más datos, así el registro nunca queda cortado a la mitad.
+static int monitor_pipe_write_all(const char *data, size_t length) {
+  size_t offset = 0;
+  while (offset < length) {
+    ssize_t written = write(pipe_fd, data + offset, length - offset);
+    if (written > 0) {
+      offset += (size_t)written;
+      continue;
+    }
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written < 0 && errno == EAGAIN) {
+      // Esperamos de a tramos para poder abandonar si se detiene el hilo
+      struct pollfd pfd = {.fd = pipe_fd, .events = POLLOUT};
+      if (poll(&pfd, 1, MONITOR_PIPE_RETRY_MS) < 0 && errno != EINTR) {
+        return -1;
+      }
+      if (!atomic_load(&running)) {
+        return -1;
+      }
+      if (pfd.revents & (POLLERR | POLLHUP)) {
+        return -1;
+      }
+      continue;
+    }
+    if (errno != EPIPE) {
+      fprintf(stderr, "Error al escribir en el pipe: %s\n", strerror(errno));
+    }
+    return -1;
+  }
+  return 0;
+}
+
+static void *monitor_pipe_publisher(void *arg) {
+  (void)arg;
+  // Registro en escritura; se intercambia con la entrada de la cola para no
+  // copiarlo ni reservar memoria
+  PipeRecord current = {NULL, 0, 0};
+
+  pthread_mutex_lock(&queue_lock);
+  while (running) {
+    if (queue_count == 0) {
+      pthread_cond_wait(&queue_not_empty, &queue_lock);
+      continue;
+    }
+    pthread_mutex_unlock(&queue_lock);
+
+    // Sin lector no tiene sentido sacar registros: quedan en la cola y la
+    // política de desborde decide cuáles se conservan
+    if (pipe_fd < 0) {
+      if (monitor_pipe_open() != 0) {
+        struct timespec retry = {0, MONITOR_PIPE_RETRY_MS * 1000000L};
+        nanosleep(&retry, NULL);
+        pthread_mutex_lock(&queue_lock);
+        continue;
+      }
+      // Cada apertura empieza con el preámbulo, p. ej. el esquema binario
+      if (preamble_length > 0 &&
+          monitor_pipe_write_all(preamble, preamble_length) != 0) {
+        monitor_pipe_close();
+        pthread_mutex_lock(&queue_lock);
+        continue;
+      }
+    }
+
+    pthread_mutex_lock(&queue_lock);
+    if (queue_count == 0) {
+      continue;
+    }
+    PipeRecord swap = queue[queue_head];
+    queue[queue_head] = current;
+    current = swap;
+    queue_head = (queue_head + 1) % pipe_config.depth;
+    queue_count--;
+    stats.queue_depth = queue_count;
+    pthread_cond_signal(&queue_not_full);
+    pthread_mutex_unlock(&queue_lock);
+
+    double start = now_seconds();
+    int result = monitor_pipe_write_all(current.data, current.length);
+    double elapsed = now_seconds() - start;
+    if (result != 0) {
+      // El lector se fue: lo reabrimos en el próximo registro
+      monitor_pipe_close();
+    }
+
+    pthread_mutex_lock(&queue_lock);
+    if (result == 0) {
+      stats.written++;
+      stats.last_write_seconds = elapsed;
+      if (elapsed > stats.max_write_seconds) {
+        stats.max_write_seconds = elapsed;
+      }
+    } else {
+      stats.dropped++;
+    }
+  }
+  pthread_mutex_unlock(&queue_lock);
+
+  free(current.data);
+  monitor_pipe_close();
+  return NULL;
+}
+
+void monitor_pipe_config_from_env(MonitorPipeConfig *config) {
+  config->depth = MONITOR_PIPE_DEFAULT_DEPTH;
+  config->policy = MONITOR_PIPE_DROP_OLDEST;
+  config->block_ms = MONITOR_PIPE_DEFAULT_BLOCK_MS;
+
+  const char *depth = getenv("MONITOR_PIPE_DEPTH");
+  if (depth != NULL && atoi(depth) > 0) {
+    config->depth = (size_t)atoi(depth);
+  }
+
+  const char *policy = getenv("MONITOR_PIPE_POLICY");
+  if (policy != NULL) {
+    if (strcmp(policy, "drop-oldest") == 0) {
+      config->policy = MONITOR_PIPE_DROP_OLDEST;
+    } else if (strcmp(policy, "coalesce") == 0) {
+      config->policy = MONITOR_PIPE_COALESCE;
+    } else if (strcmp(policy, "block") == 0) {
+      config->policy = MONITOR_PIPE_BLOCK;
+    } else {
+      fprintf(stderr, "Política de pipe desconocida: %s\n", policy);
+    }
+  }
+
+  const char *block_ms = getenv("MONITOR_PIPE_BLOCK_MS");
+  if (block_ms != NULL && atoi(block_ms) >= 0) {
+    config->block_ms = (unsigned int)atoi(block_ms);
+  }
+
+  config->format = MONITOR_PIPE_JSON;
+  const char *format = getenv("MONITOR_PIPE_FORMAT");
+  if (format != NULL) {
+    if (strcmp(format, "binary") == 0) {
+      config->format = MONITOR_PIPE_BINARY;
+    } else if (strcmp(format, "json") != 0) {
+      fprintf(stderr, "Formato de pipe desconocido: %s\n", format);
+    }
+  }
+}
+
+int monitor_pipe_set_preamble(const void *data, size_t length) {
+  char *copy = malloc(length);
+  if (copy == NULL) {
+    return -1;
+  }
+  memcpy(copy, data, length);
+  free(preamble);
+  preamble = copy;
+  preamble_length = length;
+  return 0;
+}
+
+int monitor_pipe_start(const MonitorPipeConfig *config) {
+  // Sin lector, un write a un FIFO cerrado emitiría SIGPIPE y terminaría el
+  // proceso; preferimos recibir EPIPE y reabrir
+  signal(SIGPIPE, SIG_IGN);
+
+  pipe_config = *config;
+  if (pipe_config.depth == 0) {
+    pipe_config.depth = 1;
+  }
+  queue = calloc(pipe_config.depth, sizeof(PipeRecord));
+  if (queue == NULL) {
+    fprintf(stderr, "Error al reservar la cola del pipe\n");
+    return -1;
+  }
+
+  running = 1;
+  if (pthread_create(&publisher, NULL, monitor_pipe_publisher, NULL) != 0) {
+    fprintf(stderr, "Error al crear el hilo del pipe\n");
+    running = 0;
+    free(queue);
+    queue = NULL;
+    return -1;
+  }
+  return 0;
+}
+
+// Espera lugar en la cola hasta block_ms. Devuelve 0 si se liberó lugar.
+static int monitor_pipe_wait_not_full(void) {
+  struct timespec deadline;
+  clock_gettime(CLOCK_REALTIME, &deadline);
+  deadline.tv_sec += pipe_config.block_ms / 1000;
+  deadline.tv_nsec += (long)(pipe_config.block_ms % 1000) * 1000000L;
+  if (deadline.tv_nsec >= 1000000000L) {
+    deadline.tv_sec++;
+    deadline.tv_nsec -= 1000000000L;
+  }
+
+  while (queue_count == pipe_config.depth) {
+    if (pthread_cond_timedwait(&queue_not_full, &queue_lock, &deadline) ==
+        ETIMEDOUT) {
+      return queue_count == pipe_config.depth ? -1 : 0;
+    }
+  }
+  return 0;
+}
+
+int monitor_pipe_submit(const char *data, size_t length) {
+  pthread_mutex_lock(&queue_lock);
+  if (!running) {
+    pthread_mutex_unlock(&queue_lock);
+    return -1;
+  }
+
+  if (queue_count == pipe_config.depth) {
+    switch (pipe_config.policy) {
+    case MONITOR_PIPE_DROP_OLDEST:
+      queue_head = (queue_head + 1) % pipe_config.depth;
+      queue_count--;
+      stats.dropped++;
+      break;
+    case MONITOR_PIPE_COALESCE:
+      stats.dropped += queue_count;
+      queue_count = 0;
+      break;
+    case MONITOR_PIPE_BLOCK:
+      if (monitor_pipe_wait_not_full() != 0) {
+        stats.dropped++;
+        pthread_mutex_unlock(&queue_lock);
+        return -1;
+      }
+      break;
+    }
+  }
+
+  PipeRecord *record =
+      &queue[(queue_head + queue_count) % pipe_config.depth];
+  if (record->capacity < length) {
+    char *grown = realloc(record->data, length);
+    if (grown == NULL) {
+      stats.dropped++;
+      pthread_mutex_unlock(&queue_lock);
+      return -1;
+    }
+    record->data = grown;
+    record->capacity = length;
+  }
+  memcpy(record->data, data, length);
+  record->length = length;
+  queue_count++;
+  stats.queue_depth = queue_count;
+
+  pthread_cond_signal(&queue_not_empty);
+  pthread_mutex_unlock(&queue_lock);
+  return 0;
+}
+
+void monitor_pipe_get_stats(MonitorPipeStats *out) {
+  pthread_mutex_lock(&queue_lock);
+  *out = stats;
+  stats.max_write_seconds = 0.0;
+  pthread_mutex_unlock(&queue_lock);
+}
+
+void monitor_pipe_stop(void) {
+  pthread_mutex_lock(&queue_lock);
+  if (!running) {
+    pthread_mutex_unlock(&queue_lock);
+    return;
+  }
+  running = 0;
+  pthread_cond_broadcast(&queue_not_empty);
+  pthread_cond_broadcast(&queue_not_full);
+  pthread_mutex_unlock(&queue_lock);
+
+  // Una escritura trabada en un lector lento se abandona en el próximo tramo
+  // de espera
+  pthread_join(publisher, NULL);
+
+  for (size_t i = 0; i < pipe_config.depth; i++) {
+    free(queue[i].data);
+  }
+  free(queue);
+  queue = NULL;
+  queue_head = 0;
+  queue_count = 0;
+  free(preamble);
+  preamble = NULL;
+  preamble_length = 0;
+}
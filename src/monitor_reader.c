@@ -0,0 +1,253 @@
+#include "../include/monitor_reader.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Capacidad inicial del búfer de lectura; crece si un registro no entra
+#define MONITOR_READER_INITIAL_CAPACITY 65536
+
+int monitor_stream_header_decode(const void *data, size_t length,
+                                 MonitorStreamHeader *schema) {
+  if (length < sizeof(MonitorStreamHeader)) {
+    return -1;
+  }
+  memcpy(schema, data, sizeof(MonitorStreamHeader));
+
+  // Las estructuras solo crecen entre versiones: aceptamos tamaños mayores y
+  // salteamos los campos que no conocemos
+  if (memcmp(schema->magic, MONITOR_STREAM_MAGIC, sizeof(schema->magic)) != 0 ||
+      schema->byte_order != MONITOR_BYTE_ORDER_MARK ||
+      schema->version < MONITOR_RECORD_VERSION ||
+      schema->header_size < sizeof(MonitorStreamHeader) ||
+      schema->record_header_size < sizeof(MonitorRecordHeader) ||
+      schema->disk_entry_size < sizeof(MonitorDiskEntry) ||
+      schema->net_entry_size < sizeof(MonitorNetEntry) ||
+      schema->name_size != MONITOR_RECORD_NAME_SIZE) {
+    return -1;
+  }
+  return 0;
+}
+
+int monitor_record_decode(const MonitorStreamHeader *schema, const void *data,
+                          size_t length, MonitorRecordView *view) {
+  const MonitorRecordHeader *header = data;
+  if (length < schema->record_header_size || header->length > length) {
+    return -1;
+  }
+
+  size_t expected = schema->record_header_size +
+                    (size_t)header->disk_count * schema->disk_entry_size +
+                    (size_t)header->net_count * schema->net_entry_size;
+  if (header->length < expected) {
+    return -1;
+  }
+
+  view->header = header;
+  view->disks = (const char *)data + schema->record_header_size;
+  view->disk_stride = schema->disk_entry_size;
+  view->nets =
+      view->disks + (size_t)header->disk_count * schema->disk_entry_size;
+  view->net_stride = schema->net_entry_size;
+  return 0;
+}
+
+int monitor_reader_open(MonitorReader *reader, const char *path) {
+  memset(reader, 0, sizeof(*reader));
+  reader->fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (reader->fd < 0) {
+    return -1;
+  }
+  reader->capacity = MONITOR_READER_INITIAL_CAPACITY;
+  reader->buffer = malloc(reader->capacity);
+  if (reader->buffer == NULL) {
+    close(reader->fd);
+    reader->fd = -1;
+    return -1;
+  }
+  return 0;
+}
+
+// Asegura al menos needed bytes sin consumir. Devuelve 1 si están, 0 al final
+// del flujo y -1 si falla la lectura.
+static int monitor_reader_fill(MonitorReader *reader, size_t needed) {
+  while (reader->end - reader->start < needed) {
+    // Movemos lo pendiente al principio; start queda en 0, que conserva la
+    // alineación a 8 bytes de los registros
+    if (reader->start > 0) {
+      memmove(reader->buffer, reader->buffer + reader->start,
+              reader->end - reader->start);
+      reader->end -= reader->start;
+      reader->start = 0;
+    }
+    if (needed > reader->capacity) {
+      size_t capacity = reader->capacity;
+      while (needed > capacity) {
+        capacity *= 2;
+      }
+      char *buffer = realloc(reader->buffer, capacity);
+      if (buffer == NULL) {
+        return -1;
+      }
+      reader->buffer = buffer;
+      reader->capacity = capacity;
+    }
+
+    ssize_t n = read(reader->fd, reader->buffer + reader->end,
+                     reader->capacity - reader->end);
+    if (n == 0) {
+      return 0;
+    }
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return -1;
+    }
+    reader->end += (size_t)n;
+  }
+  return 1;
+}
+
+int monitor_reader_next(MonitorReader *reader, MonitorRecordView *view) {
+  for (;;) {
+    int status = monitor_reader_fill(reader, sizeof(uint32_t));
+    if (status <= 0) {
+      return status;
+    }
+
+    // Un encabezado de esquema: el monitor volvió a abrir el pipe
+    const char *pending = reader->buffer + reader->start;
+    if (memcmp(pending, MONITOR_STREAM_MAGIC, 4) == 0) {
+      status = monitor_reader_fill(reader, sizeof(MonitorStreamHeader));
+      if (status <= 0) {
+        return status < 0 ? -1 : 0;
+      }
+      pending = reader->buffer + reader->start;
+      if (monitor_stream_header_decode(pending, reader->end - reader->start,
+                                       &reader->schema) != 0) {
+        return -1;
+      }
+      status = monitor_reader_fill(reader, reader->schema.header_size);
+      if (status <= 0) {
+        return status < 0 ? -1 : 0;
+      }
+      reader->start += reader->schema.header_size;
+      reader->has_schema = 1;
+      continue;
+    }
+    if (!reader->has_schema) {
+      return -1;
+    }
+
+    uint32_t length;
+    memcpy(&length, pending, sizeof(length));
+    if (length < reader->schema.record_header_size || length % 8 != 0) {
+      return -1;
+    }
+    status = monitor_reader_fill(reader, length);
+    if (status <= 0) {
+      return status < 0 ? -1 : 0;
+    }
+
+    pending = reader->buffer + reader->start;
+    if (monitor_record_decode(&reader->schema, pending, length, view) != 0) {
+      return -1;
+    }
+    reader->start += length;
+    return 1;
+  }
+}
+
+void monitor_reader_close(MonitorReader *reader) {
+  if (reader->fd >= 0) {
+    close(reader->fd);
+  }
+  free(reader->buffer);
+  memset(reader, 0, sizeof(*reader));
+  reader->fd = -1;
+}
+
+int monitor_shm_reader_open(MonitorShmReader *reader, const char *name) {
+  memset(reader, 0, sizeof(*reader));
+  int fd = shm_open(name, O_RDONLY | O_CLOEXEC, 0);
+  if (fd < 0) {
+    return -1;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(MonitorShmHeader)) {
+    close(fd);
+    return -1;
+  }
+  void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    return -1;
+  }
+
+  // El escritor completa el identificador al final de la inicialización
+  const MonitorShmHeader *header = map;
+  int valid = memcmp(header->magic, MONITOR_SHM_MAGIC,
+                     sizeof(MONITOR_SHM_MAGIC)) == 0;
+  atomic_thread_fence(memory_order_acquire);
+  if (!valid || header->version != MONITOR_SHM_VERSION ||
+      header->header_size != sizeof(MonitorShmHeader) ||
+      header->slot_count == 0 ||
+      header->slot_size <= sizeof(MonitorShmSlot) ||
+      header->header_size + (size_t)header->slot_count * header->slot_size >
+          (size_t)st.st_size ||
+      header->schema.record_header_size < sizeof(MonitorRecordHeader)) {
+    munmap(map, (size_t)st.st_size);
+    return -1;
+  }
+  reader->header = header;
+  reader->size = (size_t)st.st_size;
+  return 0;
+}
+
+uint64_t monitor_shm_reader_head(const MonitorShmReader *reader) {
+  return atomic_load_explicit(&reader->header->head, memory_order_acquire);
+}
+
+static const MonitorShmSlot *monitor_shm_reader_slot(
+    const MonitorShmReader *reader, uint64_t tick) {
+  size_t index = (size_t)(tick % reader->header->slot_count);
+  return (const MonitorShmSlot *)((const char *)reader->header +
+                                  reader->header->header_size +
+                                  index * reader->header->slot_size);
+}
+
+int monitor_shm_reader_begin(const MonitorShmReader *reader, uint64_t tick,
+                             MonitorRecordView *view) {
+  const MonitorShmSlot *slot = monitor_shm_reader_slot(reader, tick);
+  if (atomic_load_explicit(&slot->seq, memory_order_acquire) != 2 * tick + 2) {
+    return -1;
+  }
+  // La longitud puede ser de una escritura en curso: la acotamos a la ranura
+  // para que la decodificación nunca lea fuera de ella
+  size_t capacity = reader->header->slot_size - sizeof(MonitorShmSlot);
+  size_t length = slot->length < capacity ? slot->length : capacity;
+  if (length == 0) {
+    return -1;
+  }
+  return monitor_record_decode(&reader->header->schema, slot + 1, length,
+                               view);
+}
+
+int monitor_shm_reader_validate(const MonitorShmReader *reader,
+                                uint64_t tick) {
+  const MonitorShmSlot *slot = monitor_shm_reader_slot(reader, tick);
+  atomic_thread_fence(memory_order_acquire);
+  return atomic_load_explicit(&slot->seq, memory_order_relaxed) ==
+         2 * tick + 2;
+}
+
+void monitor_shm_reader_close(MonitorShmReader *reader) {
+  if (reader->header != NULL) {
+    munmap((void *)reader->header, reader->size);
+  }
+  memset(reader, 0, sizeof(*reader));
+}
@@ -0,0 +1,111 @@
+#include "../include/monitor_record.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Capacidad inicial; alcanza para decenas de discos e interfaces
+#define MONITOR_RECORD_INITIAL_CAPACITY 4096
+
+// Reserva extra bytes al final del registro, inicializados en cero
+static void *monitor_record_extend(MonitorRecordBuilder *builder,
+                                   size_t extra) {
+  if (builder->failed) {
+    return NULL;
+  }
+  if (builder->length + extra > builder->capacity) {
+    size_t capacity = builder->capacity ? builder->capacity
+                                        : MONITOR_RECORD_INITIAL_CAPACITY;
+    while (builder->length + extra > capacity) {
+      capacity *= 2;
+    }
+    char *data = realloc(builder->data, capacity);
+    if (data == NULL) {
+      builder->failed = 1;
+      return NULL;
+    }
+    builder->data = data;
+    builder->capacity = capacity;
+  }
+
+  void *entry = builder->data + builder->length;
+  memset(entry, 0, extra);
+  builder->length += extra;
+  return entry;
+}
+
+void monitor_stream_header_init(MonitorStreamHeader *header) {
+  memset(header, 0, sizeof(*header));
+  memcpy(header->magic, MONITOR_STREAM_MAGIC, sizeof(header->magic));
+  header->byte_order = MONITOR_BYTE_ORDER_MARK;
+  header->version = MONITOR_RECORD_VERSION;
+  header->header_size = sizeof(MonitorStreamHeader);
+  header->record_header_size = sizeof(MonitorRecordHeader);
+  header->disk_entry_size = sizeof(MonitorDiskEntry);
+  header->net_entry_size = sizeof(MonitorNetEntry);
+  header->name_size = MONITOR_RECORD_NAME_SIZE;
+}
+
+void monitor_record_begin(MonitorRecordBuilder *builder) {
+  builder->length = 0;
+  builder->failed = 0;
+  monitor_record_extend(builder, sizeof(MonitorRecordHeader));
+}
+
+MonitorRecordHeader *monitor_record_header(MonitorRecordBuilder *builder) {
+  return builder->failed ? NULL : (MonitorRecordHeader *)builder->data;
+}
+
+MonitorDiskEntry *monitor_record_add_disk(MonitorRecordBuilder *builder) {
+  MonitorRecordHeader *header = monitor_record_header(builder);
+  if (header == NULL || header->net_count != 0 ||
+      header->disk_count == UINT16_MAX) {
+    builder->failed = 1;
+    return NULL;
+  }
+  MonitorDiskEntry *entry =
+      monitor_record_extend(builder, sizeof(MonitorDiskEntry));
+  if (entry != NULL) {
+    ((MonitorRecordHeader *)builder->data)->disk_count++;
+  }
+  return entry;
+}
+
+MonitorNetEntry *monitor_record_add_net(MonitorRecordBuilder *builder) {
+  MonitorRecordHeader *header = monitor_record_header(builder);
+  if (header == NULL || header->net_count == UINT16_MAX) {
+    builder->failed = 1;
+    return NULL;
+  }
+  MonitorNetEntry *entry =
+      monitor_record_extend(builder, sizeof(MonitorNetEntry));
+  if (entry != NULL) {
+    ((MonitorRecordHeader *)builder->data)->net_count++;
+  }
+  return entry;
+}
+
+const void *monitor_record_finish(MonitorRecordBuilder *builder,
+                                  size_t *length) {
+  MonitorRecordHeader *header = monitor_record_header(builder);
+  if (header == NULL) {
+    return NULL;
+  }
+  header->length = (uint32_t)builder->length;
+  header->version = MONITOR_RECORD_VERSION;
+  if (length != NULL) {
+    *length = builder->length;
+  }
+  return builder->data;
+}
+
+void monitor_record_builder_free(MonitorRecordBuilder *builder) {
+  free(builder->data);
+  builder->data = NULL;
+  builder->length = 0;
+  builder->capacity = 0;
+}
+
+void monitor_record_set_name(char *field, const char *name) {
+  size_t length = strnlen(name, MONITOR_RECORD_NAME_SIZE - 1);
+  memcpy(field, name, length);
+  memset(field + length, 0, MONITOR_RECORD_NAME_SIZE - length);
+}
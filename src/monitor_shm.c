@@ -0,0 +1,129 @@
+#include "../include/monitor_shm.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Las ranuras ocupan líneas de caché completas
+#define MONITOR_SHM_SLOT_ALIGN 64
+
+/** Objeto mapeado, o NULL si el anillo no está activo */
+static MonitorShmHeader *shm_header = NULL;
+static size_t shm_size = 0;
+static char shm_name[256];
+
+static MonitorShmSlot *monitor_shm_slot(uint64_t tick) {
+  size_t index = (size_t)(tick % shm_header->slot_count);
+  return (MonitorShmSlot *)((char *)shm_header + sizeof(MonitorShmHeader) +
+                            index * shm_header->slot_size);
+}
+
+void monitor_shm_config_from_env(MonitorShmConfig *config) {
+  config->name = MONITOR_SHM_DEFAULT_NAME;
+  config->slots = MONITOR_SHM_DEFAULT_SLOTS;
+  config->slot_size = MONITOR_SHM_DEFAULT_SLOT_SIZE;
+
+  const char *name = getenv("MONITOR_SHM_NAME");
+  if (name != NULL && name[0] == '/') {
+    config->name = name;
+  } else if (name != NULL) {
+    fprintf(stderr, "Nombre de memoria compartida inválido: %s\n", name);
+  }
+
+  const char *slots = getenv("MONITOR_SHM_SLOTS");
+  if (slots != NULL && atoi(slots) >= 0) {
+    config->slots = (size_t)atoi(slots);
+  }
+
+  const char *slot_size = getenv("MONITOR_SHM_SLOT_SIZE");
+  if (slot_size != NULL && atoi(slot_size) > 0) {
+    config->slot_size = (size_t)atoi(slot_size);
+  }
+}
+
+int monitor_shm_start(const MonitorShmConfig *config) {
+  if (config->slots == 0 || config->slots > UINT32_MAX) {
+    return -1;
+  }
+  size_t slot_size = (config->slot_size + MONITOR_SHM_SLOT_ALIGN - 1) /
+                     MONITOR_SHM_SLOT_ALIGN * MONITOR_SHM_SLOT_ALIGN;
+  if (slot_size < sizeof(MonitorShmSlot) + sizeof(MonitorRecordHeader) ||
+      slot_size > UINT32_MAX) {
+    fprintf(stderr, "Tamaño de ranura inválido: %zu\n", config->slot_size);
+    return -1;
+  }
+  snprintf(shm_name, sizeof(shm_name), "%s", config->name);
+
+  // Un objeto de una ejecución anterior puede tener otra disposición; los
+  // lectores que lo tengan mapeado conservan el viejo hasta reabrir
+  shm_unlink(shm_name);
+  int fd = shm_open(shm_name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    perror("Error al crear la memoria compartida");
+    return -1;
+  }
+  shm_size = sizeof(MonitorShmHeader) + config->slots * slot_size;
+  if (ftruncate(fd, (off_t)shm_size) != 0) {
+    perror("Error al dimensionar la memoria compartida");
+    close(fd);
+    shm_unlink(shm_name);
+    return -1;
+  }
+  void *map = mmap(NULL, shm_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    perror("Error al mapear la memoria compartida");
+    shm_unlink(shm_name);
+    return -1;
+  }
+
+  // ftruncate deja todo en cero: head y las ranuras ya están inicializados
+  MonitorShmHeader *header = map;
+  header->version = MONITOR_SHM_VERSION;
+  header->header_size = sizeof(MonitorShmHeader);
+  header->slot_count = (uint32_t)config->slots;
+  header->slot_size = (uint32_t)slot_size;
+  monitor_stream_header_init(&header->schema);
+  // El identificador va al final: un lector que lo ve tiene el resto completo
+  atomic_thread_fence(memory_order_release);
+  memcpy(header->magic, MONITOR_SHM_MAGIC, sizeof(MONITOR_SHM_MAGIC));
+
+  shm_header = header;
+  return 0;
+}
+
+int monitor_shm_publish(const void *record, size_t length) {
+  if (shm_header == NULL) {
+    return -1;
+  }
+  // Solo el hilo principal escribe, así que head no necesita más que relaxed
+  uint64_t tick = atomic_load_explicit(&shm_header->head, memory_order_relaxed);
+  MonitorShmSlot *slot = monitor_shm_slot(tick);
+  size_t capacity = shm_header->slot_size - sizeof(MonitorShmSlot);
+
+  atomic_store_explicit(&slot->seq, 2 * tick + 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+  if (length <= capacity) {
+    memcpy(slot + 1, record, length);
+    slot->length = (uint32_t)length;
+  } else {
+    // Publicamos la ranura vacía para que los lectores no esperen el tick
+    slot->length = 0;
+    atomic_fetch_add_explicit(&shm_header->oversized, 1, memory_order_relaxed);
+  }
+  atomic_store_explicit(&slot->seq, 2 * tick + 2, memory_order_release);
+  atomic_store_explicit(&shm_header->head, tick + 1, memory_order_release);
+  return 0;
+}
+
+void monitor_shm_stop() {
+  if (shm_header == NULL) {
+    return;
+  }
+  munmap(shm_header, shm_size);
+  shm_unlink(shm_name);
+  shm_header = NULL;
+  shm_size = 0;
+}
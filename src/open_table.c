@@ -0,0 +1,56 @@
+#include "../include/open_table.h"
+#include <stdlib.h>
+
+int open_table_init(OpenTable *table, size_t capacity, size_t slot_size) {
+  table->slots = calloc(capacity, slot_size);
+  if (table->slots == NULL) {
+    return -1;
+  }
+  table->slot_size = slot_size;
+  table->mask = capacity - 1;
+  table->count = 0;
+  return 0;
+}
+
+void open_table_free(OpenTable *table) {
+  free(table->slots);
+  table->slots = NULL;
+  table->mask = table->count = 0;
+}
+
+void open_table_remove(OpenTable *table, size_t s) {
+  size_t mask = table->mask;
+  size_t hole = s;
+  for (size_t next = (s + 1) & mask; open_table_key(table, next) != 0;
+       next = (next + 1) & mask) {
+    size_t home = open_table_home(table, open_table_key(table, next));
+    // La ranura puede ocupar el hueco si este no queda antes de su posición
+    if (((next - home) & mask) >= ((next - hole) & mask)) {
+      memcpy(open_table_slot(table, hole), open_table_slot(table, next),
+             table->slot_size);
+      hole = next;
+    }
+  }
+  memset(open_table_slot(table, hole), 0, sizeof(uint64_t));
+  table->count--;
+}
+
+int open_table_grow(OpenTable *table) {
+  size_t capacity = (table->mask + 1) * 2;
+  unsigned char *grown = calloc(capacity, table->slot_size);
+  if (grown == NULL) {
+    return -1;
+  }
+  OpenTable old = *table;
+  table->slots = grown;
+  table->mask = capacity - 1;
+  for (size_t i = 0; i <= old.mask; i++) {
+    uint64_t key = open_table_key(&old, i);
+    if (key != 0) {
+      memcpy(open_table_slot(table, open_table_find(table, key)),
+             open_table_slot(&old, i), table->slot_size);
+    }
+  }
+  free(old.slots);
+  return 0;
+}
@@ -0,0 +1,170 @@
+#include "../include/proc_parse.h"
+#include <stdint.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Un byte es separador si es menor o igual que ' ' (espacio, tabulador,
+// salto de línea o '\0'); los nombres y números de /proc nunca los contienen
+#define PROC_IS_SPACE(c) ((unsigned char)(c) <= ' ')
+
+// Busca la primera aparición de "target" en [pos, end)
+static const char *find_byte(const char *pos, const char *end, char target) {
+#ifdef __SSE2__
+  const __m128i needle = _mm_set1_epi8(target);
+  while (end - pos >= 16) {
+    __m128i chunk = _mm_loadu_si128((const __m128i *)pos);
+    int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle));
+    if (mask != 0) {
+      return pos + __builtin_ctz((unsigned int)mask);
+    }
+    pos += 16;
+  }
+#endif
+  while (pos < end && *pos != target) {
+    pos++;
+  }
+  return pos;
+}
+
+// Busca el primer byte que sea (want_space = 1) o no sea (want_space = 0)
+// separador en [pos, end)
+static const char *find_space_boundary(const char *pos, const char *end,
+                                       int want_space) {
+#ifdef __SSE2__
+  // v >= '!' equivale a max(v, '!') == v en comparación sin signo
+  const __m128i first_printable = _mm_set1_epi8('!');
+  const int flip = want_space ? 0xFFFF : 0;
+  while (end - pos >= 16) {
+    __m128i chunk = _mm_loadu_si128((const __m128i *)pos);
+    __m128i printable =
+        _mm_cmpeq_epi8(_mm_max_epu8(chunk, first_printable), chunk);
+    int mask = _mm_movemask_epi8(printable) ^ flip;
+    if (mask != 0) {
+      return pos + __builtin_ctz((unsigned int)mask);
+    }
+    pos += 16;
+  }
+#endif
+  while (pos < end && (PROC_IS_SPACE(*pos) ? 1 : 0) != want_space) {
+    pos++;
+  }
+  return pos;
+}
+
+// Convierte 8 dígitos ASCII consecutivos en su valor con aritmética SWAR
+// (ocho bytes procesados en un registro de 64 bits, little-endian).
+// Devuelve 0 si alguno de los 8 bytes no es un dígito.
+static int parse_eight_digits(const char *pos, uint32_t *value) {
+  uint64_t chunk;
+  memcpy(&chunk, pos, sizeof(chunk));
+
+  // Cada byte debe ser 0x3X con X <= 9 (sumar 6 no debe pasar a 0x4X)
+  if ((((chunk & 0xF0F0F0F0F0F0F0F0ULL) |
+        (((chunk + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4))) !=
+      0x3333333333333333ULL) {
+    return 0;
+  }
+
+  // Combinamos los dígitos de a pares, luego de a cuatro y por último los ocho
+  chunk = ((chunk & 0x0F0F0F0F0F0F0F0FULL) * 2561) >> 8;
+  chunk = ((chunk & 0x00FF00FF00FF00FFULL) * 6553601) >> 16;
+  *value = (uint32_t)(((chunk & 0x0000FFFF0000FFFFULL) * 42949672960001ULL) >>
+                      32);
+  return 1;
+}
+
+int proc_next_line(ProcCursor *cursor, ProcCursor *line) {
+  if (cursor->pos >= cursor->end) {
+    return 0;
+  }
+
+  const char *newline = find_byte(cursor->pos, cursor->end, '\n');
+  line->pos = cursor->pos;
+  line->end = newline;
+  cursor->pos = newline < cursor->end ? newline + 1 : newline;
+  return 1;
+}
+
+void proc_skip_spaces(ProcCursor *cursor) {
+  cursor->pos = find_space_boundary(cursor->pos, cursor->end, 0);
+}
+
+int proc_next_field(ProcCursor *cursor, ProcCursor *field) {
+  proc_skip_spaces(cursor);
+  if (cursor->pos >= cursor->end) {
+    return 0;
+  }
+
+  field->pos = cursor->pos;
+  field->end = find_space_boundary(cursor->pos, cursor->end, 1);
+  cursor->pos = field->end;
+  return 1;
+}
+
+int proc_parse_u64(ProcCursor *cursor, unsigned long long *value) {
+  // Los números de /proc van separados por uno o pocos espacios: un bucle
+  // escalar es más barato que preparar una comparación vectorial
+  const char *pos = cursor->pos;
+  const char *end = cursor->end;
+  while (pos < end && PROC_IS_SPACE(*pos)) {
+    pos++;
+  }
+  if (pos >= end || (unsigned char)(*pos - '0') > 9) {
+    cursor->pos = pos;
+    return 0;
+  }
+
+  unsigned long long result = 0;
+  uint32_t chunk;
+  while (end - pos >= 8 && parse_eight_digits(pos, &chunk)) {
+    result = result * 100000000ULL + chunk;
+    pos += 8;
+  }
+  while (pos < end && (unsigned char)(*pos - '0') <= 9) {
+    result = result * 10 + (unsigned long long)(*pos - '0');
+    pos++;
+  }
+
+  cursor->pos = pos;
+  *value = result;
+  return 1;
+}
+
+size_t proc_parse_u64_array(ProcCursor *cursor, unsigned long long *values,
+                            size_t count) {
+  size_t parsed = 0;
+  while (parsed < count && proc_parse_u64(cursor, &values[parsed])) {
+    parsed++;
+  }
+  return parsed;
+}
+
+int proc_split_at(ProcCursor *cursor, char delimiter, ProcCursor *before) {
+  const char *found = find_byte(cursor->pos, cursor->end, delimiter);
+  if (found >= cursor->end) {
+    return 0;
+  }
+
+  if (before != NULL) {
+    before->pos = cursor->pos;
+    before->end = found;
+  }
+  cursor->pos = found + 1;
+  return 1;
+}
+
+size_t proc_field_copy(const ProcCursor *field, char *out, size_t size) {
+  if (size == 0) {
+    return 0;
+  }
+
+  size_t length = (size_t)(field->end - field->pos);
+  if (length >= size) {
+    length = size - 1;
+  }
+  memcpy(out, field->pos, length);
+  out[length] = '\0';
+  return length;
+}
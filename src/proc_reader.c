@@ -0,0 +1,119 @@
+#include "../include/proc_reader.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Tamaño inicial del búfer de cada archivo; crece al doble si no alcanza
+#define PROC_FILE_INITIAL_CAPACITY 4096
+
+/**
+ * @brief Estado de un archivo de /proc abierto de forma persistente.
+ */
+typedef struct {
+  const char *path; ///< Ruta del archivo
+  int fd;           ///< Descriptor abierto, o -1 si está cerrado
+  char *buffer;     ///< Búfer reutilizable con el último contenido leído
+  size_t capacity;  ///< Capacidad del búfer en bytes
+} ProcFile;
+
+static ProcFile proc_files[PROC_FILE_COUNT] = {
+    [PROC_FILE_MEMINFO] = {"/proc/meminfo", -1, NULL, 0},
+    [PROC_FILE_STAT] = {"/proc/stat", -1, NULL, 0},
+    [PROC_FILE_DISKSTATS] = {"/proc/diskstats", -1, NULL, 0},
+    [PROC_FILE_NET_DEV] = {"/proc/net/dev", -1, NULL, 0},
+};
+
+static int proc_file_open(ProcFile *file) {
+  file->fd = open(file->path, O_RDONLY | O_CLOEXEC);
+  if (file->fd < 0) {
+    fprintf(stderr, "Error al abrir %s: %s\n", file->path, strerror(errno));
+    return -1;
+  }
+  return 0;
+}
+
+static void proc_file_close(ProcFile *file) {
+  if (file->fd >= 0) {
+    close(file->fd);
+    file->fd = -1;
+  }
+}
+
+// Lee el archivo completo desde el desplazamiento 0. Devuelve los bytes leídos
+// o -1 si pread falla.
+static ssize_t proc_file_load(ProcFile *file) {
+  size_t length = 0;
+
+  for (;;) {
+    // Reservamos un byte para el '\0' final
+    if (length + 1 >= file->capacity) {
+      size_t new_capacity = file->capacity ? file->capacity * 2
+                                           : PROC_FILE_INITIAL_CAPACITY;
+      char *new_buffer = realloc(file->buffer, new_capacity);
+      if (new_buffer == NULL) {
+        return -1;
+      }
+      file->buffer = new_buffer;
+      file->capacity = new_capacity;
+    }
+
+    ssize_t n = pread(file->fd, file->buffer + length,
+                      file->capacity - length - 1, (off_t)length);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return -1;
+    }
+    if (n == 0) {
+      break;
+    }
+    length += (size_t)n;
+  }
+
+  file->buffer[length] = '\0';
+  return (ssize_t)length;
+}
+
+const char *proc_file_read(ProcFileId id, size_t *length) {
+  if (id >= PROC_FILE_COUNT) {
+    return NULL;
+  }
+
+  ProcFile *file = &proc_files[id];
+  if (file->fd < 0 && proc_file_open(file) != 0) {
+    return NULL;
+  }
+
+  ssize_t n = proc_file_load(file);
+  if (n < 0) {
+    // El descriptor pudo quedar inválido: reabrimos una vez y reintentamos
+    proc_file_close(file);
+    if (proc_file_open(file) != 0) {
+      return NULL;
+    }
+    n = proc_file_load(file);
+    if (n < 0) {
+      fprintf(stderr, "Error al leer %s: %s\n", file->path, strerror(errno));
+      proc_file_close(file);
+      return NULL;
+    }
+  }
+
+  if (length != NULL) {
+    *length = (size_t)n;
+  }
+  return file->buffer;
+}
+
+void proc_files_close(void) {
+  for (int i = 0; i < PROC_FILE_COUNT; i++) {
+    proc_file_close(&proc_files[i]);
+    free(proc_files[i].buffer);
+    proc_files[i].buffer = NULL;
+    proc_files[i].capacity = 0;
+  }
+}
@@ -0,0 +1,408 @@
+#include "../include/proc_top.h"
+#include "../include/open_table.h"
+#include "../include/proc_parse.h"
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+// Bytes del búfer de getdents64; unas 1000 entradas de /proc por llamada
+#define PROC_TOP_DIRENT_BUFFER 32768
+
+// Una línea de stat ocupa unos 300 bytes
+#define PROC_TOP_STAT_BUFFER 1024
+
+/**
+ * @brief Entrada de getdents64 (struct linux_dirent64 del kernel).
+ */
+typedef struct {
+  uint64_t d_ino;
+  int64_t d_off;
+  unsigned short d_reclen;
+  unsigned char d_type;
+  char d_name[];
+} ProcDirent;
+
+/**
+ * @brief Ranura de la tabla de pids. 48 bits de ticks alcanzan para miles de
+ * años de CPU; la generación se compara solo por igualdad y los pids que no
+ * aparecen se borran en cada barrido completo, así que puede dar la vuelta.
+ */
+typedef struct {
+  uint64_t pid;             ///< Clave de open_table.h
+  uint64_t ticks : 48;      ///< utime + stime en ese barrido
+  uint64_t generation : 16; ///< Último barrido en que apareció
+} ProcTopSlot;
+
+_Static_assert(sizeof(ProcTopSlot) == 16, "ProcTopSlot");
+
+/**
+ * @brief Montículo de mínimos con los N mayores vistos hasta el momento.
+ */
+typedef struct {
+  ProcTopEntry *entries;
+  size_t count;
+  double (*key)(const ProcTopEntry *entry);
+} ProcTopHeap;
+
+static int proc_dir = -1;
+static size_t top_n = 0;
+static size_t max_pids = 0;
+
+/** Pids seguidos */
+static OpenTable pid_table;
+static uint16_t generation = 0;
+
+static ProcTopHeap cpu_heap;
+static ProcTopHeap rss_heap;
+
+static long ticks_per_second;
+static long page_size;
+static uint64_t last_scan_ns = 0;
+static ProcTopStats stats;
+
+static char dirent_buffer[PROC_TOP_DIRENT_BUFFER];
+static char stat_buffer[PROC_TOP_STAT_BUFFER];
+
+static uint64_t proc_top_now_ns(clockid_t clock) {
+  struct timespec ts;
+  clock_gettime(clock, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static double key_cpu(const ProcTopEntry *entry) { return entry->cpu_usage; }
+
+static double key_rss(const ProcTopEntry *entry) {
+  return (double)entry->rss_bytes;
+}
+
+void proc_top_config_from_env(ProcTopConfig *config) {
+  config->root = "/proc";
+  config->top_n = PROC_TOP_DEFAULT_N;
+  config->max_pids = PROC_TOP_DEFAULT_MAX_PIDS;
+
+  const char *top = getenv("MONITOR_PROC_TOP_N");
+  if (top != NULL && atoi(top) >= 0) {
+    config->top_n = (size_t)atoi(top);
+  }
+
+  const char *pids = getenv("MONITOR_PROC_TOP_MAX_PIDS");
+  if (pids != NULL && atoi(pids) > 0) {
+    config->max_pids = (size_t)atoi(pids);
+  }
+}
+
+int proc_top_start(const ProcTopConfig *config) {
+  if (config->top_n == 0 || config->max_pids == 0) {
+    return -1;
+  }
+
+  // Factor de carga de a lo sumo 1/2 con la tabla llena
+  size_t capacity = 1;
+  while (capacity < config->max_pids * 2) {
+    capacity *= 2;
+  }
+  int table = open_table_init(&pid_table, capacity, sizeof(ProcTopSlot));
+  cpu_heap.entries = malloc(config->top_n * sizeof(ProcTopEntry));
+  rss_heap.entries = malloc(config->top_n * sizeof(ProcTopEntry));
+  if (table != 0 || cpu_heap.entries == NULL || rss_heap.entries == NULL) {
+    fprintf(stderr, "Error al reservar la tabla de procesos\n");
+    proc_top_stop();
+    return -1;
+  }
+
+  proc_dir = open(config->root, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (proc_dir < 0) {
+    perror("Error al abrir el directorio de procesos");
+    proc_top_stop();
+    return -1;
+  }
+
+  top_n = config->top_n;
+  max_pids = config->max_pids;
+  cpu_heap.key = key_cpu;
+  rss_heap.key = key_rss;
+  ticks_per_second = sysconf(_SC_CLK_TCK);
+  page_size = sysconf(_SC_PAGESIZE);
+  stats.memory_bytes = capacity * sizeof(ProcTopSlot) +
+                       2 * top_n * sizeof(ProcTopEntry) +
+                       sizeof(dirent_buffer) + sizeof(stat_buffer);
+  return 0;
+}
+
+static int heap_admits(const ProcTopHeap *heap, double key) {
+  return heap->count < top_n || key > heap->key(&heap->entries[0]);
+}
+
+static void heap_sift_down(ProcTopHeap *heap, size_t i) {
+  for (;;) {
+    size_t smallest = i;
+    size_t left = 2 * i + 1, right = left + 1;
+    if (left < heap->count && heap->key(&heap->entries[left]) <
+                                  heap->key(&heap->entries[smallest])) {
+      smallest = left;
+    }
+    if (right < heap->count && heap->key(&heap->entries[right]) <
+                                   heap->key(&heap->entries[smallest])) {
+      smallest = right;
+    }
+    if (smallest == i) {
+      return;
+    }
+    ProcTopEntry swap = heap->entries[i];
+    heap->entries[i] = heap->entries[smallest];
+    heap->entries[smallest] = swap;
+    i = smallest;
+  }
+}
+
+// Agrega el proceso o reemplaza al menor; el llamador ya comprobó
+// heap_admits
+static void heap_push(ProcTopHeap *heap, const ProcTopEntry *entry) {
+  if (heap->count < top_n) {
+    size_t i = heap->count++;
+    heap->entries[i] = *entry;
+    while (i > 0) {
+      size_t parent = (i - 1) / 2;
+      if (heap->key(&heap->entries[parent]) <= heap->key(&heap->entries[i])) {
+        break;
+      }
+      ProcTopEntry swap = heap->entries[i];
+      heap->entries[i] = heap->entries[parent];
+      heap->entries[parent] = swap;
+      i = parent;
+    }
+  } else {
+    heap->entries[0] = *entry;
+    heap_sift_down(heap, 0);
+  }
+}
+
+// Deja el montículo ordenado de mayor a menor: cada paso lleva el menor al
+// final de la parte que sigue siendo montículo
+static void heap_sort_descending(ProcTopHeap *heap) {
+  size_t count = heap->count;
+  while (heap->count > 1) {
+    ProcTopEntry swap = heap->entries[0];
+    heap->entries[0] = heap->entries[heap->count - 1];
+    heap->entries[heap->count - 1] = swap;
+    heap->count--;
+    heap_sift_down(heap, 0);
+  }
+  heap->count = count;
+}
+
+// Lee /proc/<pid>/stat: nombre, utime + stime (campos 14 y 15) y rss en
+// páginas (campo 24). El nombre puede tener espacios y paréntesis, así que
+// los campos se cuentan desde el último ')'.
+static int read_stat(const char *name, size_t name_length, ProcCursor *comm,
+                     uint64_t *ticks, unsigned long long *rss_pages) {
+  char path[32];
+  if (name_length + sizeof("/stat") > sizeof(path)) {
+    return -1;
+  }
+  memcpy(path, name, name_length);
+  memcpy(path + name_length, "/stat", sizeof("/stat"));
+
+  int fd = openat(proc_dir, path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return -1;
+  }
+  ssize_t length = read(fd, stat_buffer, sizeof(stat_buffer) - 1);
+  close(fd);
+  if (length <= 0) {
+    return -1;
+  }
+
+  const char *open_paren = memchr(stat_buffer, '(', (size_t)length);
+  const char *close_paren = NULL;
+  for (const char *p = stat_buffer + length - 1; p > stat_buffer; p--) {
+    if (*p == ')') {
+      close_paren = p;
+      break;
+    }
+  }
+  if (open_paren == NULL || close_paren == NULL || close_paren < open_paren) {
+    return -1;
+  }
+  comm->pos = open_paren + 1;
+  comm->end = close_paren;
+
+  // Tras el ')' sigue el campo 3 (estado); se saltan del 3 al 13
+  ProcCursor cursor, field;
+  proc_cursor_init(&cursor, close_paren + 1,
+                   (size_t)(stat_buffer + length - close_paren - 1));
+  for (int i = 3; i <= 13; i++) {
+    if (!proc_next_field(&cursor, &field)) {
+      return -1;
+    }
+  }
+  unsigned long long times[2];
+  if (proc_parse_u64_array(&cursor, times, 2) != 2) {
+    return -1;
+  }
+  for (int i = 16; i <= 23; i++) {
+    if (!proc_next_field(&cursor, &field)) {
+      return -1;
+    }
+  }
+  if (!proc_parse_u64(&cursor, rss_pages)) {
+    return -1;
+  }
+  *ticks = times[0] + times[1];
+  return 0;
+}
+
+// Lee un pid del directorio y lo ofrece a los dos rankings
+static void scan_pid(const char *name, double elapsed) {
+  size_t name_length = strlen(name);
+  int32_t pid = 0;
+  for (size_t i = 0; i < name_length; i++) {
+    if (name[i] < '0' || name[i] > '9' || pid > (INT32_MAX - 9) / 10) {
+      return;
+    }
+    pid = pid * 10 + (name[i] - '0');
+  }
+  if (pid == 0) {
+    return;
+  }
+  stats.pids++;
+
+  size_t s = open_table_find(&pid_table, (uint64_t)pid);
+  ProcTopSlot *slot = open_table_slot(&pid_table, s);
+  int known = slot->pid != 0;
+  if (!known && pid_table.count >= max_pids) {
+    stats.dropped++;
+    return;
+  }
+
+  ProcCursor comm;
+  uint64_t ticks;
+  unsigned long long rss_pages;
+  if (read_stat(name, name_length, &comm, &ticks, &rss_pages) != 0) {
+    // El proceso terminó entre el listado y la lectura
+    return;
+  }
+
+  ProcTopEntry entry = {.pid = pid,
+                        .rss_bytes = rss_pages * (unsigned long long)page_size};
+  if (known && elapsed > 0.0 && ticks >= slot->ticks) {
+    entry.cpu_usage =
+        (double)(ticks - slot->ticks) / (double)ticks_per_second / elapsed;
+  }
+  if (!known) {
+    open_table_claim(&pid_table, s, (uint64_t)pid);
+  }
+  slot->generation = generation;
+  slot->ticks = ticks;
+
+  // El nombre solo se copia para los procesos que entran en algún ranking
+  int cpu_admits = heap_admits(&cpu_heap, key_cpu(&entry));
+  int rss_admits = heap_admits(&rss_heap, key_rss(&entry));
+  if (cpu_admits || rss_admits) {
+    proc_field_copy(&comm, entry.comm, sizeof(entry.comm));
+    if (cpu_admits) {
+      heap_push(&cpu_heap, &entry);
+    }
+    if (rss_admits) {
+      heap_push(&rss_heap, &entry);
+    }
+  }
+}
+
+int proc_top_scan() {
+  if (proc_dir < 0) {
+    return -1;
+  }
+
+  uint64_t cpu_start = proc_top_now_ns(CLOCK_THREAD_CPUTIME_ID);
+  uint64_t start = proc_top_now_ns(CLOCK_MONOTONIC);
+  double elapsed = last_scan_ns != 0 ? (double)(start - last_scan_ns) / 1e9
+                                     : 0.0;
+  last_scan_ns = start;
+
+  generation++;
+  stats.pids = stats.dropped = 0;
+  cpu_heap.count = rss_heap.count = 0;
+
+  int result = 0;
+  if (lseek(proc_dir, 0, SEEK_SET) < 0) {
+    perror("Error al rebobinar el directorio de procesos");
+    result = -1;
+  }
+  while (result == 0) {
+    long length = syscall(SYS_getdents64, proc_dir, dirent_buffer,
+                          sizeof(dirent_buffer));
+    if (length < 0) {
+      perror("Error al listar el directorio de procesos");
+      result = -1;
+      break;
+    }
+    if (length == 0) {
+      break;
+    }
+    for (long offset = 0; offset < length;) {
+      const ProcDirent *dirent = (const ProcDirent *)(dirent_buffer + offset);
+      // Solo los directorios con nombre numérico son procesos
+      if (dirent->d_name[0] >= '1' && dirent->d_name[0] <= '9') {
+        scan_pid(dirent->d_name, elapsed);
+      }
+      offset += dirent->d_reclen;
+    }
+  }
+
+  // Los pids que no aparecieron terminaron; el borrado desplaza ranuras
+  // hacia la actual, así que se vuelve a revisar antes de avanzar
+  if (result == 0) {
+    for (size_t s = 0; s <= pid_table.mask;) {
+      const ProcTopSlot *slot = open_table_slot(&pid_table, s);
+      if (slot->pid != 0 && slot->generation != generation) {
+        open_table_remove(&pid_table, s);
+      } else {
+        s++;
+      }
+    }
+  }
+
+  heap_sort_descending(&cpu_heap);
+  heap_sort_descending(&rss_heap);
+
+  stats.tracked = pid_table.count;
+  stats.cpu_seconds =
+      (double)(proc_top_now_ns(CLOCK_THREAD_CPUTIME_ID) - cpu_start) / 1e9;
+  stats.wall_seconds =
+      (double)(proc_top_now_ns(CLOCK_MONOTONIC) - start) / 1e9;
+  return result;
+}
+
+size_t proc_top_by_cpu(const ProcTopEntry **entries) {
+  *entries = cpu_heap.entries;
+  return cpu_heap.count;
+}
+
+size_t proc_top_by_rss(const ProcTopEntry **entries) {
+  *entries = rss_heap.entries;
+  return rss_heap.count;
+}
+
+size_t proc_top_size() { return proc_dir >= 0 ? top_n : 0; }
+
+void proc_top_get_stats(ProcTopStats *out) { *out = stats; }
+
+void proc_top_stop() {
+  if (proc_dir >= 0) {
+    close(proc_dir);
+    proc_dir = -1;
+  }
+  open_table_free(&pid_table);
+  free(cpu_heap.entries);
+  free(rss_heap.entries);
+  cpu_heap.entries = rss_heap.entries = NULL;
+  cpu_heap.count = rss_heap.count = 0;
+  top_n = max_pids = 0;
+  last_scan_ns = 0;
+}
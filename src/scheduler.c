@@ -0,0 +1,161 @@
+#include "../include/scheduler.h"
+#include <ctype.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#define NS_PER_MS 1000000LL
+#define NS_PER_SEC 1000000000LL
+
+static SchedulerTask *scheduler_tasks = NULL;
+static size_t scheduler_count = 0;
+
+/** timerfd sobre CLOCK_REALTIME, armado con el próximo vencimiento */
+static int timer_fd = -1;
+
+static long long now_realtime_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  return (long long)ts.tv_sec * NS_PER_SEC + ts.tv_nsec;
+}
+
+// Primer múltiplo del intervalo estrictamente posterior a now
+static long long next_boundary(long long now, unsigned int interval_ms) {
+  long long interval = (long long)interval_ms * NS_PER_MS;
+  return (now / interval + 1) * interval;
+}
+
+static void scheduler_align(long long now) {
+  for (size_t i = 0; i < scheduler_count; i++) {
+    if (scheduler_tasks[i].interval_ms > 0) {
+      scheduler_tasks[i].deadline_ns =
+          next_boundary(now, scheduler_tasks[i].interval_ms);
+    }
+  }
+}
+
+// Aplica MONITOR_INTERVAL_<NOMBRE>_MS, si está definida
+static void scheduler_interval_from_env(SchedulerTask *task) {
+  char variable[64] = "MONITOR_INTERVAL_";
+  size_t length = 17;
+  for (const char *c = task->name; *c && length < sizeof(variable) - 4; c++) {
+    variable[length++] = (char)toupper((unsigned char)*c);
+  }
+  snprintf(variable + length, sizeof(variable) - length, "_MS");
+
+  const char *value = getenv(variable);
+  if (value != NULL && atoi(value) >= 0) {
+    task->interval_ms = (unsigned int)atoi(value);
+  }
+}
+
+int scheduler_init(SchedulerTask *tasks, size_t count) {
+  timer_fd = timerfd_create(CLOCK_REALTIME, TFD_CLOEXEC);
+  if (timer_fd < 0) {
+    perror("Error al crear el timerfd del planificador");
+    return -1;
+  }
+
+  scheduler_tasks = tasks;
+  scheduler_count = count;
+  for (size_t i = 0; i < count; i++) {
+    scheduler_interval_from_env(&tasks[i]);
+    tasks[i].runs = 0;
+    tasks[i].overruns = 0;
+    tasks[i].last_jitter_seconds = 0.0;
+    tasks[i].max_jitter_seconds = 0.0;
+  }
+  scheduler_align(now_realtime_ns());
+  return 0;
+}
+
+int scheduler_run_once() {
+  long long deadline = INT64_MAX;
+  for (size_t i = 0; i < scheduler_count; i++) {
+    if (scheduler_tasks[i].interval_ms > 0 &&
+        scheduler_tasks[i].deadline_ns < deadline) {
+      deadline = scheduler_tasks[i].deadline_ns;
+    }
+  }
+  if (deadline == INT64_MAX) {
+    return -1; // Ninguna tarea activa
+  }
+
+  struct itimerspec spec = {
+      .it_value = {.tv_sec = deadline / NS_PER_SEC,
+                   .tv_nsec = deadline % NS_PER_SEC}};
+  // CANCEL_ON_SET hace fallar la espera si el reloj de pared cambia, para
+  // volver a alinear los vencimientos
+  if (timerfd_settime(timer_fd, TFD_TIMER_ABSTIME | TFD_TIMER_CANCEL_ON_SET,
+                      &spec, NULL) != 0) {
+    perror("Error al armar el timerfd del planificador");
+    return -1;
+  }
+
+  uint64_t expirations;
+  if (read(timer_fd, &expirations, sizeof(expirations)) < 0) {
+    if (errno == ECANCELED) {
+      // El reloj de pared saltó: los vencimientos ya no están alineados
+      scheduler_align(now_realtime_ns());
+      return 0;
+    }
+    if (errno == EINTR) {
+      return 0;
+    }
+    perror("Error al esperar el timerfd del planificador");
+    return -1;
+  }
+
+  int ran = 0;
+  for (size_t i = 0; i < scheduler_count; i++) {
+    SchedulerTask *task = &scheduler_tasks[i];
+    long long start = now_realtime_ns();
+    if (task->interval_ms == 0 || task->deadline_ns > start) {
+      continue;
+    }
+
+    double jitter = (double)(start - task->deadline_ns) / NS_PER_SEC;
+    task->last_jitter_seconds = jitter;
+    if (jitter > task->max_jitter_seconds) {
+      task->max_jitter_seconds = jitter;
+    }
+
+    task->run();
+    task->runs++;
+    ran++;
+
+    // El próximo vencimiento es el primer múltiplo posterior al fin de la
+    // ejecución; los que quedaron atrás se cuentan como perdidos
+    long long next = next_boundary(now_realtime_ns(), task->interval_ms);
+    long long interval = (long long)task->interval_ms * NS_PER_MS;
+    task->overruns += (unsigned long long)((next - task->deadline_ns) /
+                                           interval) -
+                      1;
+    task->deadline_ns = next;
+  }
+  return ran;
+}
+
+size_t scheduler_task_count() { return scheduler_count; }
+
+void scheduler_get_stats(size_t index, SchedulerStats *stats) {
+  SchedulerTask *task = &scheduler_tasks[index];
+  stats->name = task->name;
+  stats->interval_ms = task->interval_ms;
+  stats->runs = task->runs;
+  stats->overruns = task->overruns;
+  stats->last_jitter_seconds = task->last_jitter_seconds;
+  stats->max_jitter_seconds = task->max_jitter_seconds;
+  task->max_jitter_seconds = 0.0;
+}
+
+void scheduler_close() {
+  if (timer_fd >= 0) {
+    close(timer_fd);
+    timer_fd = -1;
+  }
+}
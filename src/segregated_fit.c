@@ -0,0 +1,165 @@
+#include "../include/segregated_fit.h"
+#include "../include/alloc_policy.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/**
+ * @brief Encabezado de cada bloque; mientras el bloque está libre, la carga
+ * útil guarda el siguiente de la lista.
+ */
+typedef struct {
+  uint64_t size; ///< Bytes pedidos; define la clase o si se delegó
+} SegregatedHeader;
+
+typedef struct SegregatedFree {
+  struct SegregatedFree *next;
+} SegregatedFree;
+
+/** Listas libres por clase */
+static SegregatedFree *free_lists[SEGREGATED_CLASSES];
+/** Un bit por clase con la lista no vacía */
+static uint32_t free_bitmap;
+
+_Static_assert(SEGREGATED_CLASSES <= 32, "free_bitmap");
+
+/** Losa de cada clase de la que se cortan bloques nuevos */
+static char *slab_cursor[SEGREGATED_CLASSES];
+static char *slab_end[SEGREGATED_CLASSES];
+
+static SegregatedStats stats;
+
+static double segregated_now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static size_t size_class_of(size_t size) {
+  return size > 0 ? (size - 1) / SEGREGATED_CLASS_SIZE : 0;
+}
+
+static size_t class_bytes(size_t size_class) {
+  return (size_class + 1) * SEGREGATED_CLASS_SIZE;
+}
+
+// Corta un bloque de la losa de la clase, pidiendo otra si se agotó
+static SegregatedHeader *segregated_carve(size_t size_class) {
+  size_t stride = sizeof(SegregatedHeader) + class_bytes(size_class);
+  if (slab_cursor[size_class] == NULL ||
+      (size_t)(slab_end[size_class] - slab_cursor[size_class]) < stride) {
+    char *slab = policy_reserve(SEGREGATED_SLAB_SIZE);
+    if (slab == NULL) {
+      return NULL;
+    }
+    // El resto de la losa anterior queda sin usar y se cuenta como
+    // fragmentación
+    slab_cursor[size_class] = slab;
+    slab_end[size_class] = slab + SEGREGATED_SLAB_SIZE;
+    stats.reserved_bytes += policy_reserve_size(SEGREGATED_SLAB_SIZE);
+  }
+
+  SegregatedHeader *header = (SegregatedHeader *)slab_cursor[size_class];
+  slab_cursor[size_class] += stride;
+  return header;
+}
+
+void *segregated_malloc(size_t size) {
+  double start = segregated_now();
+  SegregatedHeader *header;
+
+  if (size > SEGREGATED_MAX_SIZE) {
+    size_t bytes = sizeof(SegregatedHeader) + size;
+    if ((header = policy_reserve(bytes)) == NULL) {
+      return NULL;
+    }
+    stats.reserved_bytes += policy_reserve_size(bytes);
+    stats.requested_bytes += size;
+  } else {
+    size_t size_class = size_class_of(size);
+    SegregatedFree *block = free_lists[size_class];
+    if (block != NULL) {
+      free_lists[size_class] = block->next;
+      if (block->next == NULL) {
+        free_bitmap &= ~(1U << size_class);
+      }
+      stats.free_blocks--;
+      stats.free_bytes -= class_bytes(size_class);
+      stats.free_histogram[policy_free_bucket(class_bytes(size_class))]--;
+      header = (SegregatedHeader *)block - 1;
+    } else if ((header = segregated_carve(size_class)) == NULL) {
+      return NULL;
+    }
+    stats.requested_bytes += size;
+  }
+  header->size = size;
+
+  stats.allocations++;
+  stats.allocation_time += segregated_now() - start;
+  return header + 1;
+}
+
+void segregated_free(void *block) {
+  if (block == NULL) {
+    return;
+  }
+  SegregatedHeader *header = (SegregatedHeader *)block - 1;
+  if (header->size > SEGREGATED_MAX_SIZE) {
+    size_t bytes = sizeof(SegregatedHeader) + header->size;
+    stats.reserved_bytes -= policy_reserve_size(bytes);
+    stats.requested_bytes -= header->size;
+    policy_release(header, bytes);
+    return;
+  }
+
+  size_t size_class = size_class_of(header->size);
+  stats.requested_bytes -= header->size;
+  SegregatedFree *free_block = block;
+  free_block->next = free_lists[size_class];
+  free_lists[size_class] = free_block;
+  free_bitmap |= 1U << size_class;
+  stats.free_blocks++;
+  stats.free_bytes += class_bytes(size_class);
+  stats.free_histogram[policy_free_bucket(class_bytes(size_class))]++;
+}
+
+void segregated_get_stats(SegregatedStats *out) {
+  *out = stats;
+  out->largest_free_block =
+      free_bitmap != 0 ? class_bytes(31 - __builtin_clz(free_bitmap)) : 0;
+}
+
+int segregated_check() {
+  size_t blocks = 0, bytes = 0;
+  size_t histogram[POLICY_FREE_BUCKETS] = {0};
+  int result = 0;
+  for (size_t size_class = 0; size_class < SEGREGATED_CLASSES; size_class++) {
+    int listed = free_lists[size_class] != NULL;
+    if (listed != (int)((free_bitmap >> size_class) & 1)) {
+      fprintf(stderr,
+              "segregated_fit: bitmap de la clase %zu desactualizado\n",
+              size_class);
+      result = -1;
+    }
+    for (SegregatedFree *block = free_lists[size_class]; block != NULL;
+         block = block->next) {
+      blocks++;
+      bytes += class_bytes(size_class);
+      histogram[policy_free_bucket(class_bytes(size_class))]++;
+    }
+  }
+  if (blocks != stats.free_blocks || bytes != stats.free_bytes) {
+    fprintf(stderr,
+            "segregated_fit: %zu bloques libres (%zu bytes), las estadísticas "
+            "dicen %zu (%zu bytes)\n",
+            blocks, bytes, stats.free_blocks, stats.free_bytes);
+    result = -1;
+  }
+  if (memcmp(histogram, stats.free_histogram, sizeof(histogram)) != 0) {
+    fprintf(stderr,
+            "segregated_fit: histograma de bloques libres desactualizado\n");
+    result = -1;
+  }
+  return result;
+}